@@ -0,0 +1,232 @@
+#include "axis_sampler.hpp"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+void AxisStats::reset(int range_min, int range_max) {
+    *this = AxisStats{};
+    histogram_min = range_min;
+    histogram_span = std::max<int64_t>(1, static_cast<int64_t>(range_max) - range_min + 1);
+}
+
+void AxisStats::add(int value) {
+    if (samples == 0) {
+        min_value = value;
+        max_value = value;
+    } else {
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+    }
+    last_value = value;
+    samples++;
+    
+    double delta = value - mean_value;
+    mean_value += delta / static_cast<double>(samples);
+    m2 += delta * (value - mean_value);
+    
+    int bin = bin_of(value);
+    bin_counts[bin]++;
+    bin_sums[bin] += value;
+}
+
+double AxisStats::stddev() const {
+    return samples > 1 ? std::sqrt(m2 / static_cast<double>(samples - 1)) : 0.0;
+}
+
+int AxisStats::bin_of(int value) const {
+    int64_t offset = static_cast<int64_t>(value) - histogram_min;
+    return static_cast<int>(std::clamp<int64_t>(offset * HISTOGRAM_BINS / histogram_span, 0, HISTOGRAM_BINS - 1));
+}
+
+int AxisStats::center() const {
+    if (samples == 0) return last_value;
+    
+    int densest = static_cast<int>(std::max_element(bin_counts.begin(), bin_counts.end()) - bin_counts.begin());
+    uint64_t count = 0;
+    int64_t sum = 0;
+    for (int bin = std::max(0, densest - 1); bin <= std::min(HISTOGRAM_BINS - 1, densest + 1); bin++) {
+        count += bin_counts[bin];
+        sum += bin_sums[bin];
+    }
+    return static_cast<int>(std::llround(static_cast<double>(sum) / static_cast<double>(count)));
+}
+
+AxisSampler::~AxisSampler() {
+    close();
+}
+
+bool AxisSampler::open(const std::string& path) {
+    close();
+    
+    fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        perror(("Failed to open " + path + " for sampling").c_str());
+        return false;
+    }
+    
+    uint8_t abs_bits[(ABS_CNT + 7) / 8] = {};
+    if (ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(abs_bits)), abs_bits) < 0) {
+        perror("Failed to query device axes");
+        close();
+        return false;
+    }
+    for (int code = 0; code < ABS_CNT; code++) {
+        present[code] = abs_bits[code / 8] & (1u << (code % 8));
+    }
+    
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0) {
+        perror("Failed to set up sampling wait");
+        close();
+        return false;
+    }
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    bool added = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    ev.data.fd = wake_fd;
+    added = added && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) == 0;
+    if (!added) {
+        perror("Failed to set up sampling wait");
+        close();
+        return false;
+    }
+    
+    reset();
+    return true;
+}
+
+void AxisSampler::close() {
+    for (int* descriptor : {&fd, &epoll_fd, &wake_fd}) {
+        if (*descriptor >= 0) {
+            ::close(*descriptor);
+            *descriptor = -1;
+        }
+    }
+    present.reset();
+}
+
+void AxisSampler::reset(int jitter_threshold) {
+    jitter = jitter_threshold;
+    dropped = false;
+    
+    struct input_event events[64];
+    while (fd >= 0 && read(fd, events, sizeof(events)) > 0) {}
+    
+    for (int code = 0; code < ABS_CNT; code++) {
+        moved[code] = 0;
+        if (!present.test(code)) continue;
+        
+        struct input_absinfo absinfo;
+        if (ioctl(fd, EVIOCGABS(code), &absinfo) < 0) {
+            present.reset(code);
+            continue;
+        }
+        axes[code].reset(absinfo.minimum, absinfo.maximum);
+        axes[code].add(absinfo.value);
+        baseline[code] = absinfo.value;
+    }
+}
+
+bool AxisSampler::wait(int timeout_ms) {
+    if (epoll_fd < 0) return false;
+    
+    struct epoll_event ready[2];
+    int count = epoll_wait(epoll_fd, ready, 2, timeout_ms);
+    bool readable = false;
+    for (int i = 0; i < count; i++) {
+        if (ready[i].data.fd == wake_fd) {
+            uint64_t value;
+            while (read(wake_fd, &value, sizeof(value)) > 0) {}
+        } else {
+            readable = true;
+        }
+    }
+    return readable;
+}
+
+bool AxisSampler::read_events() {
+    if (fd < 0) return false;
+    
+    struct input_event events[64];
+    while (true) {
+        ssize_t bytes = read(fd, events, sizeof(events));
+        if (bytes < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN;
+        }
+        if (bytes == 0) return false;
+        
+        for (size_t i = 0; i < static_cast<size_t>(bytes) / sizeof(events[0]); i++) {
+            const auto& ev = events[i];
+            if (ev.type == EV_SYN) {
+                if (ev.code == SYN_DROPPED) {
+                    dropped = true;
+                } else if (ev.code == SYN_REPORT && dropped) {
+                    // Everything up to this report is unreliable; take the state from the kernel
+                    dropped = false;
+                    resync();
+                }
+            } else if (ev.type == EV_ABS && !dropped && has_axis(ev.code)) {
+                feed(ev.code, ev.value);
+            }
+        }
+    }
+}
+
+bool AxisSampler::run_for(int duration_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(duration_ms);
+    while (true) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) return true;
+        if (wait(static_cast<int>(remaining)) && !read_events()) return false;
+    }
+}
+
+void AxisSampler::wake() {
+    uint64_t one = 1;
+    if (wake_fd >= 0 && write(wake_fd, &one, sizeof(one)) < 0) {
+        // Counter saturated: a wakeup is already pending
+    }
+}
+
+int AxisSampler::most_moved_axis() const {
+    int best_code = -1;
+    int64_t best = 0;
+    for (int code = 0; code < ABS_CNT; code++) {
+        if (present.test(code) && moved[code] > best) {
+            best = moved[code];
+            best_code = code;
+        }
+    }
+    return best_code;
+}
+
+void AxisSampler::feed(int code, int value) {
+    axes[code].add(value);
+    int64_t delta = std::abs(static_cast<int64_t>(value) - baseline[code]);
+    if (delta >= jitter) {
+        moved[code] += delta;
+    }
+}
+
+void AxisSampler::resync() {
+    for (int code = 0; code < ABS_CNT; code++) {
+        if (!present.test(code)) continue;
+        
+        struct input_absinfo absinfo;
+        if (ioctl(fd, EVIOCGABS(code), &absinfo) == 0 && absinfo.value != axes[code].last()) {
+            feed(code, absinfo.value);
+        }
+    }
+}
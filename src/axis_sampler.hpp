@@ -0,0 +1,99 @@
+#ifndef AXIS_SAMPLER_HPP
+#define AXIS_SAMPLER_HPP
+
+#include <linux/input.h>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
+
+// Streaming statistics for one axis in constant memory, however long the
+// capture runs: running min/max, Welford mean/variance, and a coarse
+// histogram over the kernel-reported range for estimating the rest position.
+class AxisStats {
+public:
+    static constexpr int HISTOGRAM_BINS = 64;
+    
+    void reset(int range_min, int range_max);
+    void add(int value);
+    
+    uint64_t count() const { return samples; }
+    int last() const { return last_value; }
+    int min() const { return min_value; }
+    int max() const { return max_value; }
+    double mean() const { return mean_value; }
+    double stddev() const;
+    
+    // Mean of the samples in the densest histogram bin and its neighbours, so
+    // a bump or an off-center start doesn't drag the estimate like a plain mean
+    int center() const;
+
+private:
+    uint64_t samples = 0;
+    int last_value = 0;
+    int min_value = 0;
+    int max_value = 0;
+    double mean_value = 0.0;
+    double m2 = 0.0;
+    
+    int histogram_min = 0;
+    int64_t histogram_span = 1;
+    std::array<uint32_t, HISTOGRAM_BINS> bin_counts{};
+    std::array<int64_t, HISTOGRAM_BINS> bin_sums{};
+    
+    int bin_of(int value) const;
+};
+
+// Feeds AxisStats for every ABS axis of one device from its own non-blocking
+// fd (so the caller's fd and libevdev state are untouched). Waits block in
+// epoll and each wakeup drains everything the kernel queued, so no sample is
+// missed between polls; after SYN_DROPPED the axes are resynced by ioctl.
+class AxisSampler {
+public:
+    AxisSampler() = default;
+    ~AxisSampler();
+    AxisSampler(const AxisSampler&) = delete;
+    AxisSampler& operator=(const AxisSampler&) = delete;
+    
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return fd >= 0; }
+    
+    // Discards queued events and restarts every axis from its current value.
+    // Movement only counts deviations from that value of at least jitter_threshold.
+    void reset(int jitter_threshold = 0);
+    
+    // Blocks until events are queued (true), or the timeout passes or wake()
+    // is called (false). timeout_ms -1 waits indefinitely.
+    bool wait(int timeout_ms);
+    // Feeds every queued event; false once the device is gone
+    bool read_events();
+    // wait() + read_events() until duration_ms has passed
+    bool run_for(int duration_ms);
+    // Thread-safe: interrupts a blocked wait()
+    void wake();
+    
+    bool has_axis(int code) const { return code >= 0 && code < ABS_CNT && present.test(code); }
+    const AxisStats& stats(int code) const { return axes[code]; }
+    // Summed deviation from the starting value over all events
+    int64_t movement(int code) const { return moved[code]; }
+    // Axis that moved the most, or -1 if none did
+    int most_moved_axis() const;
+
+private:
+    int fd = -1;
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    bool dropped = false;
+    int jitter = 0;
+    
+    std::bitset<ABS_CNT> present;
+    std::array<AxisStats, ABS_CNT> axes{};
+    std::array<int, ABS_CNT> baseline{};
+    std::array<int64_t, ABS_CNT> moved{};
+    
+    void feed(int code, int value);
+    void resync();
+};
+
+#endif // AXIS_SAMPLER_HPP
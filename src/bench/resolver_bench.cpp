@@ -0,0 +1,267 @@
+// twcs_bench: BindingResolver microbenchmarks over synthetic 1 kHz traces.
+//
+// Each scenario replays a pre-generated trace of stick, throttle and rudder
+// frames (EV_ABS/EV_KEY events closed by SYN_REPORT) through process_input,
+// draining get_pending_events once per frame exactly like the mapper does.
+// Reported per input event: wall time and heap allocations.
+
+#include "bindings.hpp"
+#include "config.hpp"
+#include <linux/input-event-codes.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+// Allocation counting: every heap allocation in the process goes through here
+static std::atomic<uint64_t> allocation_count{0};
+
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+struct TraceEvent {
+    PhysicalInput input;
+    int value;
+    bool syn;  // SYN_REPORT: drain the resolver
+};
+
+struct Trace {
+    std::vector<TraceEvent> events;
+    size_t input_events = 0;
+    size_t frames = 0;
+};
+
+void push_input(Trace& trace, Role role, SrcKind kind, uint16_t code, int value) {
+    trace.events.push_back({{role, kind, code}, value, false});
+    trace.input_events++;
+}
+
+void push_syn(Trace& trace) {
+    trace.events.push_back({{Role::Stick, SrcKind::Abs, 0}, 0, true});
+    trace.frames++;
+}
+
+int sine_axis(double t, double hz, double phase) {
+    return static_cast<int>(32767.5 + 32767.0 * std::sin(2.0 * M_PI * hz * t + phase));
+}
+
+// One frame per device per millisecond, interleaved like three devices waking one epoll loop
+Trace make_flight_trace(int duration_ms) {
+    Trace trace;
+    for (int ms = 0; ms < duration_ms; ms++) {
+        double t = ms / 1000.0;
+        
+        // Stick: X/Y sweep every frame, trigger and thumb buttons every 100/250 ms, hat every 500 ms
+        push_input(trace, Role::Stick, SrcKind::Abs, ABS_X, sine_axis(t, 0.7, 0.0));
+        push_input(trace, Role::Stick, SrcKind::Abs, ABS_Y, sine_axis(t, 0.5, 1.0));
+        if (ms % 100 == 0) push_input(trace, Role::Stick, SrcKind::Key, BTN_TRIGGER, (ms / 100) % 2);
+        if (ms % 250 == 0) push_input(trace, Role::Stick, SrcKind::Key, BTN_THUMB, (ms / 250) % 2);
+        if (ms % 500 == 0) push_input(trace, Role::Stick, SrcKind::Abs, ABS_HAT0X, (ms / 500) % 3 - 1);
+        push_syn(trace);
+        
+        // Throttle: slow collective ramp, base buttons every 200 ms
+        push_input(trace, Role::Throttle, SrcKind::Abs, ABS_Z, (ms * 7) % 65536);
+        if (ms % 200 == 0) push_input(trace, Role::Throttle, SrcKind::Key, BTN_BASE5, (ms / 200) % 2);
+        push_syn(trace);
+        
+        // Rudder: pedals plus both toe brakes
+        push_input(trace, Role::Rudder, SrcKind::Abs, ABS_RZ, sine_axis(t, 0.3, 2.0));
+        push_input(trace, Role::Rudder, SrcKind::Abs, ABS_X, sine_axis(t, 0.2, 0.5));
+        push_input(trace, Role::Rudder, SrcKind::Abs, ABS_Y, sine_axis(t, 0.2, 1.5));
+        push_syn(trace);
+    }
+    return trace;
+}
+
+// Every button bound from every role, plus several axes fanned out to the whole axis contract
+std::vector<Binding> make_large_profile() {
+    const char* roles[] = {"stick", "throttle", "rudder"};
+    std::vector<BindingConfigKey> keys;
+    std::vector<BindingConfigAbs> abs;
+    
+    for (const char* role : roles) {
+        for (int i = 0; i < 32; i++) {
+            keys.push_back({role, BTN_JOYSTICK + i, VIRTUAL_BUTTON_CODES[i % VIRTUAL_BUTTON_COUNT]});
+            keys.push_back({role, BTN_JOYSTICK + i, VIRTUAL_BUTTON_CODES[(i + 5) % VIRTUAL_BUTTON_COUNT]});
+        }
+        for (int src : {ABS_X, ABS_Y, ABS_Z, ABS_RZ}) {
+            for (uint16_t dst : VIRTUAL_AXIS_CODES) {
+                if (dst == ABS_HAT0X || dst == ABS_HAT0Y) continue;
+                BindingConfigAbs binding;
+                binding.role = role;
+                binding.src = src;
+                binding.dst = dst;
+                binding.invert = (src == ABS_Y);
+                abs.push_back(binding);
+            }
+        }
+    }
+    return make_bindings_from_config(keys, abs);
+}
+
+void apply_calibrations(BindingResolver& resolver) {
+    for (Role role : {Role::Stick, Role::Throttle, Role::Rudder}) {
+        for (int code : {ABS_X, ABS_Y, ABS_Z, ABS_RZ, ABS_THROTTLE}) {
+            AxisCalibration cal{};
+            cal.src_code = code;
+            cal.observed_min = 120;
+            cal.observed_max = 65400;
+            bool centered = (role != Role::Throttle);
+            cal.center_value = centered ? 32760 : cal.observed_min;
+            cal.deadzone_radius = centered ? 400 : 0;
+            resolver.set_calibration(role, code, cal);
+        }
+    }
+}
+
+struct Result {
+    double ns_per_event;
+    double allocs_per_event;
+    double outputs_per_frame;
+    size_t events;
+};
+
+// Replays the trace until at least min_ms of wall time has elapsed
+Result run_resolver(BindingResolver& resolver, const Trace& trace, int min_ms) {
+    std::array<PendingEvent, MAX_PENDING_EVENTS> pending;
+    uint64_t outputs = 0;
+    size_t passes = 0;
+    
+    // Warm-up pass settles caches and the resolver's last-output state
+    for (const TraceEvent& ev : trace.events) {
+        if (ev.syn) resolver.get_pending_events(pending);
+        else resolver.process_input(ev.input, ev.value);
+    }
+    
+    uint64_t allocs_before = allocation_count.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(min_ms);
+    do {
+        for (const TraceEvent& ev : trace.events) {
+            if (ev.syn) {
+                outputs += resolver.get_pending_events(pending);
+            } else {
+                resolver.process_input(ev.input, ev.value);
+            }
+        }
+        passes++;
+    } while (std::chrono::steady_clock::now() < deadline);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t allocs = allocation_count.load(std::memory_order_relaxed) - allocs_before;
+    
+    size_t events = trace.input_events * passes;
+    return {
+        std::chrono::duration<double, std::nano>(elapsed).count() / events,
+        static_cast<double>(allocs) / events,
+        static_cast<double>(outputs) / (trace.frames * passes),
+        events
+    };
+}
+
+// apply_axis_transform alone over the full 16-bit input range
+Result run_axis_transform(const BindingResolver& resolver, const AxisTransform& xform, Role role, int code, int min_ms) {
+    volatile int sink = 0;
+    size_t passes = 0;
+    
+    uint64_t allocs_before = allocation_count.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(min_ms);
+    do {
+        int acc = 0;
+        for (int value = 0; value < 65536; value++) {
+            acc += resolver.apply_axis_transform(value, xform, role, code);
+        }
+        sink = sink + acc;
+        passes++;
+    } while (std::chrono::steady_clock::now() < deadline);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t allocs = allocation_count.load(std::memory_order_relaxed) - allocs_before;
+    
+    size_t events = 65536 * passes;
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / events,
+            static_cast<double>(allocs) / events, 0.0, events};
+}
+
+void print_header() {
+    printf("%-34s %12s %10s %13s %14s\n", "scenario", "events", "ns/event", "allocs/event", "outputs/frame");
+}
+
+void print_result(const char* name, const Result& result) {
+    printf("%-34s %12zu %10.1f %13.4f %14.2f\n", name, result.events, result.ns_per_event,
+           result.allocs_per_event, result.outputs_per_frame);
+}
+
+void print_usage(const char* program_name) {
+    printf("Usage: %s [--trace-ms N] [--min-ms N]\n", program_name);
+    printf("  --trace-ms N   Length of the synthetic 1 kHz trace in simulated ms (default 2000)\n");
+    printf("  --min-ms N     Minimum wall time per scenario in ms (default 300)\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int trace_ms = 2000;
+    int min_ms = 300;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace-ms") == 0 && i + 1 < argc) {
+            trace_ms = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            min_ms = std::max(1, atoi(argv[++i]));
+        } else {
+            print_usage(argv[0]);
+            return (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) ? 0 : 1;
+        }
+    }
+    
+    Trace trace = make_flight_trace(trace_ms);
+    printf("Trace: %d ms at 1 kHz x 3 devices, %zu input events in %zu frames\n\n",
+           trace_ms, trace.input_events, trace.frames);
+    
+    struct Scenario {
+        const char* name;
+        std::function<std::vector<Binding>()> make_bindings;
+        bool calibrated;
+    };
+    const Scenario scenarios[] = {
+        {"default bindings, uncalibrated", make_default_bindings, false},
+        {"default bindings, calibrated", make_default_bindings, true},
+        {"large profile, uncalibrated", make_large_profile, false},
+        {"large profile, calibrated", make_large_profile, true},
+    };
+    
+    print_header();
+    for (const Scenario& scenario : scenarios) {
+        BindingResolver resolver(scenario.make_bindings());
+        if (scenario.calibrated) {
+            apply_calibrations(resolver);
+        }
+        print_result(scenario.name, run_resolver(resolver, trace, min_ms));
+    }
+    
+    printf("\n");
+    print_header();
+    BindingResolver calibrated(make_default_bindings());
+    apply_calibrations(calibrated);
+    AxisTransform stick_xform{false, 0, 1.0f, -32768, 32767};
+    AxisTransform throttle_xform{false, 0, 1.0f, 0, 255};
+    print_result("apply_axis_transform, centered", run_axis_transform(calibrated, stick_xform, Role::Stick, ABS_X, min_ms));
+    print_result("apply_axis_transform, throttle", run_axis_transform(calibrated, throttle_xform, Role::Throttle, ABS_Z, min_ms));
+    print_result("apply_axis_transform, uncalibrated", run_axis_transform(calibrated, stick_xform, Role::Stick, ABS_RX, min_ms));
+    
+    return 0;
+}
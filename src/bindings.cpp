@@ -1,103 +1,84 @@
 #include "bindings.hpp"
 #include "config.hpp"
+#include "trace.hpp"
 #include <algorithm>
-#include <unordered_set>
-#include <set>
+#include <bit>
+#include <cmath>
 #include <iostream>
 
-#ifdef DEBUG_BINDINGS
-bool debug_bindings_enabled = false;
-#endif
-
 Role BindingResolver::get_role_priority(const VirtualSlot& dst) {
     return Role::Stick;
 }
 
 bool BindingResolver::is_virtual_slot_valid(const VirtualSlot& slot) const {
-    static const std::unordered_set<uint16_t> valid_buttons = {
-        BTN_SOUTH, BTN_EAST, BTN_WEST, BTN_NORTH,
-        BTN_TL, BTN_TR, BTN_TL2, BTN_TR2,
-        BTN_SELECT, BTN_START, BTN_MODE,
-        BTN_THUMBL, BTN_THUMBR,
-        BTN_DPAD_UP, BTN_DPAD_DOWN, BTN_DPAD_LEFT, BTN_DPAD_RIGHT
-    };
-    
-    static const std::unordered_set<uint16_t> valid_axes = {
-        ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ, ABS_HAT0X, ABS_HAT0Y
-    };
-    
     if (slot.kind == SrcKind::Key) {
-        return valid_buttons.count(slot.code) > 0;
+        return virtual_button_index(slot.code) >= 0;
     } else {
-        return valid_axes.count(slot.code) > 0;
+        return virtual_axis_index(slot.code) >= 0;
     }
 }
 
-int BindingResolver::apply_axis_transform(int value, const AxisTransform& xform, Role role, int src_code) const {
+int BindingResolver::calibrated_axis_value(int value, const AxisTransform& xform, Role role, const AxisCalibration& cal) {
     int input_value = value;
     
+    // Determine axis type: Throttle is always unidirectional, Stick/Rudder are centered
+    bool is_centered = (role == Role::Stick || role == Role::Rudder) && 
+                       (cal.center_value > cal.observed_min + 10) &&
+                       (cal.deadzone_radius > 0);
+    
+    int output_value;
+    if (is_centered) {
+        // Two-segment mapping for centered axes (rudder, stick)
+        // Apply deadzone and rescale to maintain smooth output
+        if (std::abs(input_value - cal.center_value) < cal.deadzone_radius) {
+            // Inside deadzone: output center (0)
+            output_value = 0;
+        } else if (input_value < cal.center_value) {
+            // Left half: rescale from [observed_min, center-deadzone] to [min_out, 0]
+            int deadzone_edge = cal.center_value - cal.deadzone_radius;
+            float ratio = (input_value - cal.observed_min) / (float)(deadzone_edge - cal.observed_min);
+            output_value = static_cast<int>(ratio * (0 - xform.min_out) + xform.min_out);
+        } else {
+            // Right half: rescale from [center+deadzone, observed_max] to [0, max_out]
+            int deadzone_edge = cal.center_value + cal.deadzone_radius;
+            float ratio = (input_value - deadzone_edge) / (float)(cal.observed_max - deadzone_edge);
+            output_value = static_cast<int>(ratio * xform.max_out);
+        }
+    } else {
+        // Unidirectional mapping for throttle: full range maps to full output range
+        // No deadzone for throttle (ARMA needs full precision)
+        float ratio = (input_value - cal.observed_min) / (float)(cal.observed_max - cal.observed_min);
+        output_value = static_cast<int>(ratio * (xform.max_out - xform.min_out) + xform.min_out);
+    }
+    
+    // Apply inversion if needed
+    if (xform.invert) {
+        output_value = xform.max_out + xform.min_out - output_value;
+    }
+    
+    // Final clamp to output range only (not input range)
+    return std::max(xform.min_out, std::min(xform.max_out, output_value));
+}
+
+int BindingResolver::apply_axis_transform(int value, const AxisTransform& xform, Role role, int src_code) const {
     // Check if we have calibration data for this axis
-    auto role_it = calibrations.find(role);
-    if (role_it != calibrations.end()) {
-        auto cal_it = role_it->second.find(src_code);
-        if (cal_it != role_it->second.end()) {
-            const AxisCalibration& cal = cal_it->second;
+    size_t role_index = static_cast<size_t>(role);
+    if (role_index < ROLE_COUNT && src_code >= 0 && src_code < ABS_CNT) {
+        const CalibrationSlot& slot = calibrations[role_index * ABS_CNT + src_code];
+        if (slot.present) {
+            const AxisCalibration& cal = slot.cal;
             
-            // TEMP DEBUG: log rudder transform
-            if (role == Role::Rudder) {
-                static int dbg_count = 0;
-                if (dbg_count++ % 100 == 0) {
-                    fprintf(stderr, "[RUDDER DBG] input=%d src_code=%d cal: min=%d max=%d center=%d dz=%d xform: min_out=%d max_out=%d invert=%d\n",
-                            input_value, src_code, cal.observed_min, cal.observed_max, cal.center_value, cal.deadzone_radius,
-                            xform.min_out, xform.max_out, xform.invert);
-                }
-            }
-            
-            // Determine axis type: Throttle is always unidirectional, Stick/Rudder are centered
-            bool is_centered = (role == Role::Stick || role == Role::Rudder) && 
-                               (cal.center_value > cal.observed_min + 10) &&
-                               (cal.deadzone_radius > 0);
-            
-            int output_value;
-            if (is_centered) {
-                // Two-segment mapping for centered axes (rudder, stick)
-                // Apply deadzone and rescale to maintain smooth output
-                if (std::abs(input_value - cal.center_value) < cal.deadzone_radius) {
-                    // Inside deadzone: output center (0)
-                    output_value = 0;
-                } else if (input_value < cal.center_value) {
-                    // Left half: rescale from [observed_min, center-deadzone] to [min_out, 0]
-                    int deadzone_edge = cal.center_value - cal.deadzone_radius;
-                    float ratio = (input_value - cal.observed_min) / (float)(deadzone_edge - cal.observed_min);
-                    output_value = static_cast<int>(ratio * (0 - xform.min_out) + xform.min_out);
-                } else {
-                    // Right half: rescale from [center+deadzone, observed_max] to [0, max_out]
-                    int deadzone_edge = cal.center_value + cal.deadzone_radius;
-                    float ratio = (input_value - deadzone_edge) / (float)(cal.observed_max - deadzone_edge);
-                    output_value = static_cast<int>(ratio * xform.max_out);
-                }
-            } else {
-                // Unidirectional mapping for throttle: full range maps to full output range
-                // No deadzone for throttle (ARMA needs full precision)
-                float ratio = (input_value - cal.observed_min) / (float)(cal.observed_max - cal.observed_min);
-                output_value = static_cast<int>(ratio * (xform.max_out - xform.min_out) + xform.min_out);
-            }
-            
-            // Apply inversion if needed
-            if (xform.invert) {
-                output_value = xform.max_out + xform.min_out - output_value;
-            }
+            TRACE(TRACE_CALIBRATION, "role=%d code=%d input=%d cal: min=%d max=%d center=%d dz=%d xform: min_out=%d max_out=%d invert=%d\n",
+                  static_cast<int>(role), src_code, value, cal.observed_min, cal.observed_max, cal.center_value,
+                  cal.deadzone_radius, xform.min_out, xform.max_out, xform.invert);
             
-            // Final clamp to output range only (not input range)
-            return std::max(xform.min_out, std::min(xform.max_out, output_value));
+            return calibrated_axis_value(value, xform, role, cal);
         }
     }
     
     // No calibration data - pass through with simple scaling
-    if (role == Role::Rudder) {
-        fprintf(stderr, "[RUDDER FALLBACK] NO CALIBRATION FOUND! role=%d src_code=%d value=%d\n",
-                static_cast<int>(role), src_code, value);
-    }
+    TRACE(TRACE_CALIBRATION, "no calibration for role=%d code=%d, using raw scaling (value=%d)\n",
+          static_cast<int>(role), src_code, value);
     float ratio = value / 65535.0f;
     if (xform.invert) {
         ratio = 1.0f - ratio;
@@ -106,221 +87,423 @@ int BindingResolver::apply_axis_transform(int value, const AxisTransform& xform,
     return std::max(xform.min_out, std::min(xform.max_out, output_value));
 }
 
-void BindingResolver::set_calibration(Role role, int src_code, const AxisCalibration& cal) {
-    calibrations[role][src_code] = cal;
+bool has_response_stages(const AxisTransform& xform) {
+    // Hats are -1/0/1 edges, nothing to shape
+    if (static_cast<int64_t>(xform.max_out) - xform.min_out <= 2) {
+        return false;
+    }
+    return xform.deadzone > 0 || xform.expo > 0.0f || xform.s_curve > 0.0f || xform.scale != 1.0f;
 }
 
-BindingResolver::BindingResolver(const std::vector<Binding>& bindings) : bindings(bindings) {
-    for (const auto& binding : bindings) {
-        if (!is_virtual_slot_valid(binding.dst)) {
-            continue;
-        }
-        
-        if (binding.dst.kind == SrcKind::Key) {
-            button_refcounts[binding.dst] = 0;
-        } else {
-            axis_values[binding.dst][Role::Stick] = std::nullopt;
-            axis_values[binding.dst][Role::Throttle] = std::nullopt;
-            axis_values[binding.dst][Role::Rudder] = std::nullopt;
-            axis_selected_source[binding.dst] = std::nullopt;
-            last_output_values[binding.dst] = 0;
-        }
+bool has_smoothing(const AxisTransform& xform) {
+    return xform.smoothing > 0.0f && static_cast<int64_t>(xform.max_out) - xform.min_out > 2;
+}
+
+int shape_axis_output(int value, const AxisTransform& xform) {
+    if (!has_response_stages(xform)) {
+        return value;
     }
+    
+    // Work on the deflection from rest in [0, 1]
+    bool centered = xform.min_out < 0 && xform.max_out > 0;
+    double full = centered ? (value >= 0 ? xform.max_out : -static_cast<double>(xform.min_out))
+                           : static_cast<double>(xform.max_out) - xform.min_out;
+    double u = centered ? std::abs(static_cast<double>(value)) / full : (value - static_cast<double>(xform.min_out)) / full;
+    u = std::clamp(u, 0.0, 1.0);
+    
+    double deadzone = std::clamp(xform.deadzone, 0, 99) / 100.0;
+    u = (u <= deadzone) ? 0.0 : (u - deadzone) / (1.0 - deadzone);
+    double expo = std::clamp(xform.expo, 0.0f, 1.0f);
+    u = (1.0 - expo) * u + expo * u * u * u;
+    double s_curve = std::clamp(xform.s_curve, 0.0f, 1.0f);
+    u = (1.0 - s_curve) * u + s_curve * u * u * (3.0 - 2.0 * u);
+    u = std::min(1.0, u * std::max(0.0f, xform.scale));
+    
+    long magnitude = std::lround(u * full);
+    long shaped = centered ? (value >= 0 ? magnitude : -magnitude) : xform.min_out + magnitude;
+    return static_cast<int>(std::clamp<long>(shaped, xform.min_out, xform.max_out));
 }
 
-void BindingResolver::process_input(const PhysicalInput& input, int value) {
-    DEBUG_LOG("Processing input: role=%d kind=%d code=%d value=%d\n", 
-              static_cast<int>(input.role), static_cast<int>(input.kind), input.code, value);
+// Tabulates the response stages over the whole output range, and sets up the
+// fixed-point smoothing kernel. Called once per axis binding at compile time.
+void BindingResolver::build_response_stages(CompiledBinding& compiled) {
+    const AxisTransform& xform = compiled.binding.xform;
+    int64_t output_span = static_cast<int64_t>(xform.max_out) - xform.min_out;
+    if (output_span <= 0 || output_span > UINT16_MAX) {
+        return;
+    }
     
-    for (const auto& binding : bindings) {
-        if (binding.src.role == input.role && 
-            binding.src.kind == input.kind && 
-            binding.src.code == input.code) {
-            
-            DEBUG_LOG("Found binding to: kind=%d code=%d\n", 
-                      static_cast<int>(binding.dst.kind), binding.dst.code);
-            
-            if (binding.dst.kind == SrcKind::Key) {
-                button_pressed_sources[binding.dst][binding.src] = (value != 0);
-                
-                int refcount = 0;
-                for (const auto& [source, pressed] : button_pressed_sources[binding.dst]) {
-                    if (pressed) refcount++;
-                }
-                button_refcounts[binding.dst] = refcount;
-                DEBUG_LOG("Button refcount: %d\n", refcount);
-            } else {
-                int transformed_value = apply_axis_transform(value, binding.xform, input.role, input.code);
-                if (input.role == Role::Rudder) {
-                    static int pdbg = 0;
-                    if (pdbg++ % 50 == 0) {
-                        fprintf(stderr, "[RUDDER PROC] raw=%d code=%d -> transformed=%d dst_code=%d\n",
-                                value, input.code, transformed_value, binding.dst.code);
-                    }
-                }
-                axis_values[binding.dst][input.role] = transformed_value;
-                DEBUG_LOG("Axis value for role %d: %d\n", static_cast<int>(input.role), transformed_value);
-            }
+    if (has_response_stages(xform)) {
+        compiled.response.resize(static_cast<size_t>(output_span) + 1);
+        for (size_t i = 0; i < compiled.response.size(); i++) {
+            compiled.response[i] = static_cast<uint16_t>(shape_axis_output(xform.min_out + static_cast<int>(i), xform) - xform.min_out);
         }
     }
+    
+    if (has_smoothing(xform)) {
+        // Jitter-sized steps get the minimum weight; a step of 1/32 of the range
+        // or more passes straight through, so real movement isn't delayed
+        double strength = std::clamp(xform.smoothing, 0.0f, 1.0f);
+        compiled.smooth_min_alpha = std::max<uint32_t>(1024, static_cast<uint32_t>(std::lround((1.0 - strength) * 65536.0)));
+        compiled.smooth_knee = static_cast<int32_t>(std::max<int64_t>(1, output_span / 32));
+        uint64_t remaining = (65536ull - std::min<uint32_t>(compiled.smooth_min_alpha, 65536)) << 16;
+        compiled.smooth_gain = (remaining + compiled.smooth_knee - 1) / compiled.smooth_knee;
+    }
 }
 
-std::vector<std::pair<VirtualSlot, int>> BindingResolver::get_pending_events() {
-    std::vector<std::pair<VirtualSlot, int>> events;
-    std::set<VirtualSlot> emitted_slots; // Track to prevent duplicates
-    
-    auto should_suppress_button_output = [&](const VirtualSlot& slot) {
-        // For Xbox-style controllers, triggers should be axes.
-        // Some games (including ARMA) may interpret BTN_TL2/BTN_TR2 as system/menu buttons.
-        // We still use these internally as "trigger clicks", but we suppress emitting them as EV_KEY.
-        return slot.kind == SrcKind::Key && (slot.code == BTN_TL2 || slot.code == BTN_TR2);
-    };
-
-    for (const auto& [slot, refcount] : button_refcounts) {
-        // Safety: Skip invalid slots
-        if (!is_virtual_slot_valid(slot)) {
-            DEBUG_LOG("Skipping invalid button slot: kind=%d code=%d\n", static_cast<int>(slot.kind), slot.code);
-            continue;
-        }
+// Tabulates calibrated_axis_value, then the response stages, over the calibrated
+// input range, so the table reproduces the reference path bit for bit. Inputs
+// outside the range (or axes whose range or output span does not fit) keep
+// using the float path.
+void BindingResolver::build_axis_lut(CompiledBinding& compiled, const AxisCalibration& cal) {
+    compiled.lut.clear();
+    
+    const AxisTransform& xform = compiled.binding.xform;
+    int64_t input_span = static_cast<int64_t>(cal.observed_max) - cal.observed_min + 1;
+    int64_t output_span = static_cast<int64_t>(xform.max_out) - xform.min_out;
+    if (input_span <= 0 || input_span > static_cast<int64_t>(MAX_AXIS_LUT_SIZE) ||
+        output_span < 0 || output_span > UINT16_MAX) {
+        return;
+    }
+    
+    compiled.lut_first = cal.observed_min;
+    compiled.lut.resize(static_cast<size_t>(input_span));
+    for (size_t i = 0; i < compiled.lut.size(); i++) {
+        int output = calibrated_axis_value(cal.observed_min + static_cast<int>(i), xform, compiled.binding.src.role, cal);
+        uint16_t offset = static_cast<uint16_t>(output - xform.min_out);
+        compiled.lut[i] = compiled.response.empty() ? offset : compiled.response[offset];
+    }
+}
 
-        // Safety: Skip duplicate slots
-        if (emitted_slots.count(slot)) {
-            DEBUG_LOG("Skipping duplicate button slot: kind=%d code=%d\n", static_cast<int>(slot.kind), slot.code);
-            continue;
-        }
+int BindingResolver::transform_axis(const CompiledBinding& compiled, int value) const {
+    uint32_t offset = static_cast<uint32_t>(value) - static_cast<uint32_t>(compiled.lut_first);
+    if (offset < compiled.lut.size()) {
+        return compiled.binding.xform.min_out + compiled.lut[offset];
+    }
+    const AxisTransform& xform = compiled.binding.xform;
+    int output = apply_axis_transform(value, xform, compiled.binding.src.role, compiled.binding.src.code);
+    if (!compiled.response.empty()) {
+        output = xform.min_out + compiled.response[static_cast<size_t>(output - xform.min_out)];
+    }
+    return output;
+}
 
-        int last_value = last_output_values.count(slot) ? last_output_values[slot] : 0;
-        int current_value = (refcount > 0) ? 1 : 0;
+// Speed-adaptive EMA in Q16: the weight of a new value grows with its distance
+// from the filtered one, from smooth_min_alpha up to 1 at smooth_knee
+int BindingResolver::smooth_axis(CompiledBinding& compiled, int value) {
+    if (!compiled.smoothed_valid) {
+        compiled.smoothed = value;
+        compiled.smoothed_valid = true;
+        return value;
+    }
+    
+    int64_t delta = static_cast<int64_t>(value) - compiled.smoothed;
+    uint64_t step = std::min<uint64_t>(static_cast<uint64_t>(delta < 0 ? -delta : delta),
+                                       static_cast<uint64_t>(compiled.smooth_knee));
+    uint64_t alpha = std::min<uint64_t>(65536, compiled.smooth_min_alpha + ((step * compiled.smooth_gain) >> 16));
+    compiled.smoothed += static_cast<int32_t>(delta * static_cast<int64_t>(alpha) / 65536);
+    return compiled.smoothed;
+}
 
-        if (last_value == current_value) {
-            continue;
+std::optional<int> BindingResolver::preview_axis(const PhysicalInput& input, int value) const {
+    auto index = dispatch_index(input);
+    if (!index || input.kind != SrcKind::Abs) {
+        return std::nullopt;
+    }
+    const DispatchRange& range = dispatch_table[*index];
+    for (uint16_t i = 0; i < range.count; i++) {
+        const CompiledBinding& compiled = compiled_bindings[range.first + i];
+        if (compiled.binding.dst.kind == SrcKind::Abs) {
+            return transform_axis(compiled, value);
         }
+    }
+    return std::nullopt;
+}
 
-        // Always update state so we don't repeatedly "re-detect" changes.
-        last_output_values[slot] = current_value;
-
-        if (should_suppress_button_output(slot)) {
-            continue;
+void BindingResolver::set_calibration(Role role, int src_code, const AxisCalibration& cal) {
+    size_t role_index = static_cast<size_t>(role);
+    if (role_index >= ROLE_COUNT || src_code < 0 || src_code >= ABS_CNT) {
+        return;
+    }
+    calibrations[role_index * ABS_CNT + src_code] = {true, cal};
+    
+    auto index = dispatch_index({role, SrcKind::Abs, static_cast<uint16_t>(src_code)});
+    if (!index) {
+        return;
+    }
+    const DispatchRange& range = dispatch_table[*index];
+    for (uint16_t i = 0; i < range.count; i++) {
+        CompiledBinding& compiled = compiled_bindings[range.first + i];
+        if (compiled.binding.dst.kind == SrcKind::Abs) {
+            build_axis_lut(compiled, cal);
         }
+    }
+}
 
-        events.push_back({slot, current_value});
-        emitted_slots.insert(slot);
-        DEBUG_LOG("Button event: slot=%d value=%d\n", slot.code, current_value);
+BindingResolver::BindingResolver(const std::vector<Binding>& bindings) {
+    compile_bindings(bindings);
+}
+
+std::optional<size_t> BindingResolver::dispatch_index(const PhysicalInput& input) {
+    size_t role_index = static_cast<size_t>(input.role);
+    if (role_index >= ROLE_COUNT) {
+        return std::nullopt;
     }
     
-    // Mirror button-style inputs into axis-style outputs for games expecting axes.
-    //
-    // This is especially important for:
-    // - D-pad: some games only read the hat axes (ABS_HAT0X/ABS_HAT0Y)
-    // - Triggers: some games only read the analog trigger axes (ABS_Z/ABS_RZ)
-
-    auto get_button_pressed = [&](uint16_t btn_code) -> bool {
-        VirtualSlot btn_slot{SrcKind::Key, btn_code};
-        return button_refcounts.count(btn_slot) ? (button_refcounts[btn_slot] > 0) : false;
-    };
+    size_t code_index;
+    if (input.kind == SrcKind::Key) {
+        if (input.code >= KEY_CNT) return std::nullopt;
+        code_index = input.code;
+    } else {
+        if (input.code >= ABS_CNT) return std::nullopt;
+        code_index = KEY_CNT + input.code;
+    }
+    
+    return role_index * DISPATCH_CODES_PER_ROLE + code_index;
+}
 
-    auto mirror_button_to_axis = [&](uint16_t btn_code, uint16_t axis_code, int pressed_value, int released_value) {
-        if (!get_button_pressed(btn_code)) {
-            pressed_value = released_value;
+void BindingResolver::compile_bindings(const std::vector<Binding>& bindings) {
+    compiled_bindings.clear();
+    dispatch_table.fill(DispatchRange{});
+    
+    // Count bindings per source so each source gets one contiguous range
+    std::vector<uint16_t> counts(dispatch_table.size(), 0);
+    std::vector<CompiledBinding> accepted;
+    accepted.reserve(bindings.size());
+    
+    // Each distinct source bound to a button gets its own bit in that button's press mask
+    std::array<std::map<PhysicalInput, uint8_t>, VIRTUAL_BUTTON_COUNT> button_source_bits;
+    
+    for (const auto& binding : bindings) {
+        int dst_index = (binding.dst.kind == SrcKind::Key)
+            ? virtual_button_index(binding.dst.code)
+            : virtual_axis_index(binding.dst.code);
+        if (dst_index < 0) {
+            continue;
         }
-
-        VirtualSlot axis_slot{SrcKind::Abs, axis_code};
-        if (!is_virtual_slot_valid(axis_slot)) {
-            return;
+        
+        auto index = dispatch_index(binding.src);
+        if (!index || counts[*index] == UINT16_MAX || accepted.size() >= UINT16_MAX) {
+            continue;
         }
+        
+        uint8_t source_bit = 0;
+        if (binding.dst.kind == SrcKind::Key) {
+            auto& source_bits = button_source_bits[dst_index];
+            auto it = source_bits.find(binding.src);
+            if (it == source_bits.end()) {
+                if (source_bits.size() >= 64) {
+                    std::cerr << "Warning: more than 64 sources bound to button " << binding.dst.code
+                              << ", ignoring extra binding" << std::endl;
+                    continue;
+                }
+                it = source_bits.emplace(binding.src, static_cast<uint8_t>(source_bits.size())).first;
+            }
+            source_bit = it->second;
+        }
+        
+        counts[*index]++;
+        CompiledBinding& compiled = accepted.emplace_back();
+        compiled.binding = binding;
+        compiled.dst_index = static_cast<uint8_t>(dst_index);
+        compiled.source_bit = source_bit;
+        if (binding.dst.kind == SrcKind::Abs) {
+            build_response_stages(accepted.back());
+        }
+    }
+    
+    uint16_t offset = 0;
+    for (size_t i = 0; i < dispatch_table.size(); i++) {
+        dispatch_table[i].first = offset;
+        offset += counts[i];
+    }
+    
+    // Scatter bindings into their ranges, preserving original order within a source
+    compiled_bindings.resize(accepted.size());
+    for (CompiledBinding& compiled : accepted) {
+        DispatchRange& range = dispatch_table[*dispatch_index(compiled.binding.src)];
+        compiled_bindings[range.first + range.count] = std::move(compiled);
+        range.count++;
+    }
+}
 
-        // Put mirrored values in the lowest-priority role so they never override
-        // any real axis mappings coming from stick/throttle.
-        auto& role_values = axis_values[axis_slot];
-        role_values[Role::Rudder] = pressed_value;
-    };
-
-    // D-pad buttons -> hat axes
-    // Linux hat convention: X left=-1 right=+1, Y up=-1 down=+1
-    int hat_x = 0;
-    if (get_button_pressed(BTN_DPAD_LEFT)) hat_x = -1;
-    if (get_button_pressed(BTN_DPAD_RIGHT)) hat_x = 1;
-
-    int hat_y = 0;
-    if (get_button_pressed(BTN_DPAD_UP)) hat_y = -1;
-    if (get_button_pressed(BTN_DPAD_DOWN)) hat_y = 1;
+bool BindingResolver::is_button_pressed(uint16_t btn_code) const {
+    int index = virtual_button_index(btn_code);
+    return index >= 0 && button_pressed_sources[index] != 0;
+}
 
-    {
-        VirtualSlot axis_slot{SrcKind::Abs, ABS_HAT0X};
-        if (is_virtual_slot_valid(axis_slot)) {
-            auto& role_values = axis_values[axis_slot];
-            role_values[Role::Rudder] = hat_x;
-        }
+// Mirror button-style inputs into axis-style outputs for games expecting axes.
+//
+// This is especially important for:
+// - D-pad: some games only read the hat axes (ABS_HAT0X/ABS_HAT0Y)
+// - Triggers: some games only read the analog trigger axes (ABS_Z/ABS_RZ)
+int BindingResolver::mirror_axis_for_button(int button_index) {
+    switch (VIRTUAL_BUTTON_CODES[button_index]) {
+        case BTN_DPAD_LEFT:
+        case BTN_DPAD_RIGHT:
+            return virtual_axis_index(ABS_HAT0X);
+        case BTN_DPAD_UP:
+        case BTN_DPAD_DOWN:
+            return virtual_axis_index(ABS_HAT0Y);
+        case BTN_TL2:
+            return virtual_axis_index(ABS_Z);
+        case BTN_TR2:
+            return virtual_axis_index(ABS_RZ);
+        default:
+            return -1;
     }
+}
 
-    {
-        VirtualSlot axis_slot{SrcKind::Abs, ABS_HAT0Y};
-        if (is_virtual_slot_valid(axis_slot)) {
-            auto& role_values = axis_values[axis_slot];
-            role_values[Role::Rudder] = hat_y;
-        }
+bool BindingResolver::apply_button_mirror(int axis_index) {
+    int value;
+    switch (VIRTUAL_AXIS_CODES[axis_index]) {
+        // Linux hat convention: X left=-1 right=+1, Y up=-1 down=+1
+        case ABS_HAT0X:
+            value = 0;
+            if (is_button_pressed(BTN_DPAD_LEFT)) value = -1;
+            if (is_button_pressed(BTN_DPAD_RIGHT)) value = 1;
+            break;
+        case ABS_HAT0Y:
+            value = 0;
+            if (is_button_pressed(BTN_DPAD_UP)) value = -1;
+            if (is_button_pressed(BTN_DPAD_DOWN)) value = 1;
+            break;
+        // Trigger click buttons -> trigger axes
+        case ABS_Z:
+            value = is_button_pressed(BTN_TL2) ? 255 : 0;
+            break;
+        case ABS_RZ:
+            value = is_button_pressed(BTN_TR2) ? 255 : 0;
+            break;
+        default:
+            return false;
     }
+    
+    // Put mirrored values in the lowest-priority role so they never override
+    // any real axis mappings coming from stick/throttle.
+    AxisState& axis = axis_values[axis_index];
+    axis.role_values[static_cast<size_t>(Role::Rudder)] = value;
+    axis.valid_roles |= static_cast<uint8_t>(1u << static_cast<size_t>(Role::Rudder));
+    return true;
+}
 
-    // Trigger click buttons -> trigger axes
-    mirror_button_to_axis(BTN_TL2, ABS_Z, 255, 0);
-    mirror_button_to_axis(BTN_TR2, ABS_RZ, 255, 0);
-    
-    for (const auto& [slot, role_values] : axis_values) {
-        // Safety: Skip invalid slots
-        if (!is_virtual_slot_valid(slot)) {
-            DEBUG_LOG("Skipping invalid axis slot: kind=%d code=%d\n", static_cast<int>(slot.kind), slot.code);
-            continue;
-        }
+void BindingResolver::process_input(const PhysicalInput& input, int value) {
+    TRACE(TRACE_BINDINGS, "Processing input: role=%d kind=%d code=%d value=%d\n",
+          static_cast<int>(input.role), static_cast<int>(input.kind), input.code, value);
+    
+    auto index = dispatch_index(input);
+    if (!index) {
+        return;
+    }
+    
+    const DispatchRange& range = dispatch_table[*index];
+    for (uint16_t i = 0; i < range.count; i++) {
+        CompiledBinding& compiled = compiled_bindings[range.first + i];
+        const Binding& binding = compiled.binding;
+        TRACE(TRACE_BINDINGS, "Found binding to: kind=%d code=%d\n",
+              static_cast<int>(binding.dst.kind), binding.dst.code);
         
-        // Safety: Skip duplicate slots
-        if (emitted_slots.count(slot)) {
-            DEBUG_LOG("Skipping duplicate axis slot: kind=%d code=%d\n", static_cast<int>(slot.kind), slot.code);
-            continue;
+        if (binding.dst.kind == SrcKind::Key) {
+            uint64_t& pressed_sources = button_pressed_sources[compiled.dst_index];
+            uint64_t bit = uint64_t{1} << compiled.source_bit;
+            if (value != 0) {
+                pressed_sources |= bit;
+            } else {
+                pressed_sources &= ~bit;
+            }
+            dirty_buttons |= 1u << compiled.dst_index;
+            int mirror_axis = mirror_axis_for_button(compiled.dst_index);
+            if (mirror_axis >= 0) {
+                dirty_axes |= static_cast<uint8_t>(1u << mirror_axis);
+            }
+            TRACE(TRACE_BINDINGS, "Button pressed sources: 0x%llx\n", static_cast<unsigned long long>(pressed_sources));
+        } else {
+            int transformed_value = transform_axis(compiled, value);
+            if (compiled.smooth_min_alpha != 0) {
+                transformed_value = smooth_axis(compiled, transformed_value);
+            }
+            TRACE(TRACE_AXES, "role=%d code=%d raw=%d -> %d dst_code=%d\n",
+                  static_cast<int>(input.role), input.code, value, transformed_value, binding.dst.code);
+            AxisState& axis = axis_values[compiled.dst_index];
+            axis.role_values[static_cast<size_t>(input.role)] = transformed_value;
+            axis.valid_roles |= static_cast<uint8_t>(1u << static_cast<size_t>(input.role));
+            dirty_axes |= static_cast<uint8_t>(1u << compiled.dst_index);
+            TRACE(TRACE_BINDINGS, "Axis value for role %d: %d\n", static_cast<int>(input.role), transformed_value);
         }
+    }
+}
+
+size_t BindingResolver::get_pending_events(std::span<PendingEvent> out) {
+    size_t count = 0;
+    
+    while (dirty_buttons != 0) {
+        int i = std::countr_zero(dirty_buttons);
+        uint16_t code = VIRTUAL_BUTTON_CODES[i];
+        int current_value = (button_pressed_sources[i] != 0) ? 1 : 0;
         
-        Role selected_role = Role::Stick;
-        bool has_value = false;
+        // For Xbox-style controllers, triggers should be axes
+        bool suppressed = !virtual_button_emits_key(code);
         
-        auto role_value = [&](Role role) -> const std::optional<int>* {
-            auto it = role_values.find(role);
-            if (it == role_values.end()) {
-                return nullptr;
+        if (last_button_outputs[i] != current_value && !suppressed) {
+            if (count == out.size()) {
+                return count;
             }
-            return &it->second;
-        };
-
-        // Priority: Stick > Throttle > Rudder
-        if (const auto* v = role_value(Role::Stick); v && v->has_value()) {
-            selected_role = Role::Stick;
-            has_value = true;
-        } else if (const auto* v = role_value(Role::Throttle); v && v->has_value()) {
-            selected_role = Role::Throttle;
-            has_value = true;
-        } else if (const auto* v = role_value(Role::Rudder); v && v->has_value()) {
-            selected_role = Role::Rudder;
-            has_value = true;
+            out[count++] = {{SrcKind::Key, code}, current_value};
+            TRACE(TRACE_BINDINGS, "Button event: slot=%d value=%d\n", code, current_value);
         }
-
+        
+        last_button_outputs[i] = current_value;
+        dirty_buttons &= ~(1u << i);
+    }
+    
+    while (dirty_axes != 0) {
+        int i = std::countr_zero(static_cast<unsigned>(dirty_axes));
+        apply_button_mirror(i);
+        const AxisState& axis = axis_values[i];
+        
+        // Priority: Stick > Throttle > Rudder (Role order); unset roles are skipped
         int current_value = 0;
-        if (has_value) {
-            if (const auto* v = role_value(selected_role); v && v->has_value()) {
-                current_value = **v;
+        int selected_role = -1;
+        for (int role = 0; role < ROLE_COUNT; role++) {
+            if (axis.valid_roles & (1u << role)) {
+                selected_role = role;
+                current_value = axis.role_values[role];
+                break;
             }
         }
-        int last_value = last_output_values.count(slot) ? last_output_values[slot] : 0;
         
-        if (last_value != current_value) {
-            events.push_back({slot, current_value});
-            last_output_values[slot] = current_value;
-            emitted_slots.insert(slot);
-            DEBUG_LOG("Axis event: slot=%d value=%d (role=%d)\n", slot.code, current_value, static_cast<int>(selected_role));
+        if (last_axis_outputs[i] != current_value) {
+            if (count == out.size()) {
+                return count;
+            }
+            uint16_t code = VIRTUAL_AXIS_CODES[i];
+            out[count++] = {{SrcKind::Abs, code}, current_value};
+            last_axis_outputs[i] = current_value;
+            TRACE(TRACE_BINDINGS, "Axis event: slot=%d value=%d (role=%d)\n", code, current_value, selected_role);
         }
+        
+        dirty_axes &= static_cast<uint8_t>(~(1u << i));
     }
     
-    return events;
+    return count;
+}
+
+std::vector<PendingEvent> BindingResolver::get_pending_events() {
+    std::array<PendingEvent, MAX_PENDING_EVENTS> buffer;
+    size_t count = get_pending_events(buffer);
+    return std::vector<PendingEvent>(buffer.begin(), buffer.begin() + count);
+}
+
+void BindingResolver::adopt_outputs(const BindingResolver& previous) {
+    last_button_outputs = previous.last_button_outputs;
+    last_axis_outputs = previous.last_axis_outputs;
+    dirty_buttons = (1u << VIRTUAL_BUTTON_COUNT) - 1;
+    dirty_axes = static_cast<uint8_t>((1u << VIRTUAL_AXIS_COUNT) - 1);
 }
 
 void BindingResolver::clear_pending_events() {
+    dirty_buttons = 0;
+    dirty_axes = 0;
 }
 
 std::vector<Binding> make_default_bindings() {
@@ -375,6 +558,7 @@ std::vector<Binding> make_bindings_from_config(const std::vector<BindingConfigKe
     
     // Convert key bindings
     for (const auto& config_key : config_keys) {
+        if (config_key.output < 0 || config_key.output > UINT8_MAX) continue;
         Role role;
         if (config_key.role == "stick") role = Role::Stick;
         else if (config_key.role == "throttle") role = Role::Throttle;
@@ -384,12 +568,14 @@ std::vector<Binding> make_bindings_from_config(const std::vector<BindingConfigKe
         bindings.push_back({
             {role, SrcKind::Key, static_cast<uint16_t>(config_key.src)},
             {SrcKind::Key, static_cast<uint16_t>(config_key.dst)},
-            {} // Empty AxisTransform for keys
+            {}, // Empty AxisTransform for keys
+            static_cast<uint8_t>(config_key.output)
         });
     }
     
     // Convert abs bindings
     for (const auto& config_abs : config_abs) {
+        if (config_abs.output < 0 || config_abs.output > UINT8_MAX) continue;
         Role role;
         if (config_abs.role == "stick") role = Role::Stick;
         else if (config_abs.role == "throttle") role = Role::Throttle;
@@ -431,7 +617,9 @@ std::vector<Binding> make_bindings_from_config(const std::vector<BindingConfigKe
         bindings.push_back({
             {role, SrcKind::Abs, static_cast<uint16_t>(config_abs.src)},
             {SrcKind::Abs, static_cast<uint16_t>(config_abs.dst)},
-            {config_abs.invert, config_abs.deadzone, config_abs.scale, min_out, max_out}
+            {config_abs.invert, config_abs.deadzone, config_abs.scale, min_out, max_out,
+             config_abs.expo, config_abs.s_curve, config_abs.smoothing},
+            static_cast<uint8_t>(config_abs.output)
         });
     }
     
@@ -439,25 +627,13 @@ std::vector<Binding> make_bindings_from_config(const std::vector<BindingConfigKe
 }
 
 bool validate_bindings(const std::vector<Binding>& bindings) {
-    static const std::unordered_set<uint16_t> valid_buttons = {
-        BTN_SOUTH, BTN_EAST, BTN_WEST, BTN_NORTH,
-        BTN_TL, BTN_TR, BTN_TL2, BTN_TR2,
-        BTN_SELECT, BTN_START, BTN_MODE,
-        BTN_THUMBL, BTN_THUMBR,
-        BTN_DPAD_UP, BTN_DPAD_DOWN, BTN_DPAD_LEFT, BTN_DPAD_RIGHT
-    };
-    
-    static const std::unordered_set<uint16_t> valid_axes = {
-        ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ, ABS_HAT0X, ABS_HAT0Y
-    };
-    
     for (const auto& binding : bindings) {
         if (binding.dst.kind == SrcKind::Key) {
-            if (valid_buttons.find(binding.dst.code) == valid_buttons.end()) {
+            if (virtual_button_index(binding.dst.code) < 0) {
                 return false;
             }
         } else {
-            if (valid_axes.find(binding.dst.code) == valid_axes.end()) {
+            if (virtual_axis_index(binding.dst.code) < 0) {
                 return false;
             }
         }
@@ -1,15 +1,14 @@
 #pragma once
 
+#include "config.hpp"
 #include <linux/input-event-codes.h>
 #include <vector>
 #include <map>
+#include <array>
 #include <cstdint>
 #include <optional>
-
-// Forward declarations to avoid circular includes
-struct BindingConfigKey;
-struct BindingConfigAbs;
-struct AxisCalibration;
+#include <span>
+#include <utility>
 
 enum class Role {
     Stick,
@@ -48,53 +47,180 @@ struct VirtualSlot {
     }
 };
 
+// Calibration and invert map the input onto [min_out, max_out]; the response
+// stages (deadzone, expo, s_curve, scale) then shape it, see shape_axis_output.
+// The resolver tabulates all of it, so stages cost nothing per event.
 struct AxisTransform {
     bool invert = false;
-    int deadzone = 0;
+    int deadzone = 0;        // Percent of travel that reads as rest, around center or at the low end
     float scale = 1.0f;
     int min_out;
     int max_out;
+    float expo = 0.0f;       // 0..1, softer around rest
+    float s_curve = 0.0f;    // 0..1, softer around rest and at full deflection
+    float smoothing = 0.0f;  // 0..1, speed-adaptive EMA (fixed point, per binding)
 };
 
+// True if any response stage (or the smoothing filter) changes the output
+bool has_response_stages(const AxisTransform& xform);
+bool has_smoothing(const AxisTransform& xform);
+
+// Response stages on an output value in [min_out, max_out]: deadzone, expo,
+// S-curve, then scale, applied to the distance from center on centered outputs
+// and from min_out on one-sided ones. Reference for the resolver's tables.
+int shape_axis_output(int value, const AxisTransform& xform);
+
 struct Binding {
     PhysicalInput src;
     VirtualSlot dst;
     AxisTransform xform;
+    uint8_t output = 0;  // Virtual device index; each output has its own resolver
+};
+
+constexpr int ROLE_COUNT = 3;
+
+// Virtual Controller Contract: fixed 17 buttons and 8 axes (see VirtualDevice).
+// Ordered by event code so resolver output order matches code order.
+constexpr int VIRTUAL_BUTTON_COUNT = 17;
+constexpr int VIRTUAL_AXIS_COUNT = 8;
+
+inline constexpr std::array<uint16_t, VIRTUAL_BUTTON_COUNT> VIRTUAL_BUTTON_CODES = {
+    BTN_SOUTH, BTN_EAST, BTN_NORTH, BTN_WEST,
+    BTN_TL, BTN_TR, BTN_TL2, BTN_TR2,
+    BTN_SELECT, BTN_START, BTN_MODE,
+    BTN_THUMBL, BTN_THUMBR,
+    BTN_DPAD_UP, BTN_DPAD_DOWN, BTN_DPAD_LEFT, BTN_DPAD_RIGHT
 };
 
+inline constexpr std::array<uint16_t, VIRTUAL_AXIS_COUNT> VIRTUAL_AXIS_CODES = {
+    ABS_X, ABS_Y, ABS_Z, ABS_RX, ABS_RY, ABS_RZ, ABS_HAT0X, ABS_HAT0Y
+};
+
+// Index into VIRTUAL_BUTTON_CODES / VIRTUAL_AXIS_CODES, or -1 if outside the contract
+constexpr int virtual_button_index(uint16_t code) {
+    for (int i = 0; i < VIRTUAL_BUTTON_COUNT; i++) {
+        if (VIRTUAL_BUTTON_CODES[i] == code) return i;
+    }
+    return -1;
+}
+
+constexpr int virtual_axis_index(uint16_t code) {
+    for (int i = 0; i < VIRTUAL_AXIS_COUNT; i++) {
+        if (VIRTUAL_AXIS_CODES[i] == code) return i;
+    }
+    return -1;
+}
+
+// BTN_TL2/BTN_TR2 are trigger clicks: tracked and mirrored onto ABS_Z/ABS_RZ, but
+// never emitted as EV_KEY since some games (including ARMA) read them as menu buttons
+constexpr bool virtual_button_emits_key(uint16_t code) {
+    return code != BTN_TL2 && code != BTN_TR2;
+}
+
+// One virtual output change. Each slot appears at most once per drain,
+// so a buffer of MAX_PENDING_EVENTS always holds a full drain.
+using PendingEvent = std::pair<VirtualSlot, int>;
+constexpr size_t MAX_PENDING_EVENTS = VIRTUAL_BUTTON_COUNT + VIRTUAL_AXIS_COUNT;
+
 class BindingResolver {
 private:
-    std::vector<Binding> bindings;
-    std::map<VirtualSlot, int> button_refcounts;
-    std::map<VirtualSlot, std::map<PhysicalInput, bool>> button_pressed_sources;
-    std::map<VirtualSlot, std::map<Role, std::optional<int>>> axis_values;
-    std::map<VirtualSlot, std::optional<Role>> axis_selected_source;
-    std::map<VirtualSlot, int> last_output_values;
-    std::map<Role, std::map<int, AxisCalibration>> calibrations;  // Role -> (src_code -> calibration)
+    // Compiled dispatch table: one range per (role, kind, code) into compiled_bindings.
+    // Key codes occupy [0, KEY_CNT), abs codes [KEY_CNT, KEY_CNT + ABS_CNT) within each role.
+    struct DispatchRange {
+        uint16_t first = 0;
+        uint16_t count = 0;
+    };
+    static constexpr size_t DISPATCH_CODES_PER_ROLE = KEY_CNT + ABS_CNT;
+    
+    struct CompiledBinding {
+        Binding binding;
+        uint8_t dst_index;   // Index into VIRTUAL_BUTTON_CODES or VIRTUAL_AXIS_CODES
+        uint8_t source_bit;  // Bit in the destination button's press mask (buttons only)
+        
+        // Calibrated and shaped axis output for inputs in [lut_first, lut_first + lut.size()),
+        // stored as offset from xform.min_out. Empty until set_calibration covers the source.
+        int32_t lut_first = 0;
+        std::vector<uint16_t> lut;
+        
+        // Response stages over the output range (offset in, offset out), for inputs
+        // the calibration table doesn't cover. Empty when no stage is set.
+        std::vector<uint16_t> response;
+        
+        // Smoothing kernel, Q16: steps of smooth_knee or more pass straight through,
+        // smaller ones get down to smooth_min_alpha of the way. smooth_min_alpha 0 = off.
+        uint32_t smooth_min_alpha = 0;
+        int32_t smooth_knee = 1;
+        uint64_t smooth_gain = 0;  // (65536 - smooth_min_alpha) / smooth_knee, Q16
+        int32_t smoothed = 0;
+        bool smoothed_valid = false;
+    };
+    static constexpr size_t MAX_AXIS_LUT_SIZE = 65536;
+    
+    // Per-axis value from each role; valid_roles marks which roles have reported (unset != zero)
+    struct AxisState {
+        int32_t role_values[ROLE_COUNT] = {0, 0, 0};
+        uint8_t valid_roles = 0;
+    };
+    
+    struct CalibrationSlot {
+        bool present = false;
+        AxisCalibration cal{};
+    };
+    
+    std::vector<CompiledBinding> compiled_bindings;  // Grouped by source, in original binding order
+    std::array<DispatchRange, ROLE_COUNT * DISPATCH_CODES_PER_ROLE> dispatch_table{};
+    
+    // Each button has one bit per distinct bound source (OR semantics: pressed if any bit set)
+    alignas(64) std::array<uint64_t, VIRTUAL_BUTTON_COUNT> button_pressed_sources{};
+    alignas(64) std::array<AxisState, VIRTUAL_AXIS_COUNT> axis_values{};
+    std::array<int32_t, VIRTUAL_BUTTON_COUNT> last_button_outputs{};
+    std::array<int32_t, VIRTUAL_AXIS_COUNT> last_axis_outputs{};
+    std::array<CalibrationSlot, ROLE_COUNT * ABS_CNT> calibrations{};  // Indexed by role * ABS_CNT + src_code
+    
+    // Slots touched by process_input since the last drain (bit i = contract index i)
+    uint32_t dirty_buttons = 0;
+    uint8_t dirty_axes = 0;
+    static_assert(VIRTUAL_BUTTON_COUNT <= 32 && VIRTUAL_AXIS_COUNT <= 8, "dirty masks too narrow");
     
     static Role get_role_priority(const VirtualSlot& dst);
     bool is_virtual_slot_valid(const VirtualSlot& slot) const;
+    static std::optional<size_t> dispatch_index(const PhysicalInput& input);
+    void compile_bindings(const std::vector<Binding>& bindings);
+    bool is_button_pressed(uint16_t btn_code) const;
+    static int mirror_axis_for_button(int button_index);
+    bool apply_button_mirror(int axis_index);
+    static int calibrated_axis_value(int value, const AxisTransform& xform, Role role, const AxisCalibration& cal);
+    static void build_axis_lut(CompiledBinding& compiled, const AxisCalibration& cal);
+    static void build_response_stages(CompiledBinding& compiled);
+    int transform_axis(const CompiledBinding& compiled, int value) const;
+    static int smooth_axis(CompiledBinding& compiled, int value);
     
 public:
     BindingResolver(const std::vector<Binding>& bindings);
     void set_calibration(Role role, int src_code, const AxisCalibration& cal);
     
     void process_input(const PhysicalInput& input, int value);
-    std::vector<std::pair<VirtualSlot, int>> get_pending_events();
+    
+    // Drains changed outputs into out (buttons first, then axes, ascending code) and
+    // returns the count written. Changes that do not fit stay pending for the next call.
+    size_t get_pending_events(std::span<PendingEvent> out);
+    std::vector<PendingEvent> get_pending_events();
     void clear_pending_events();
     
-    // Public for diagnostics
+    // Continue from what previous last emitted: every slot is marked dirty, but the
+    // next drain only reports values that differ from previous's last outputs.
+    // Used when a reloaded resolver replaces a live one.
+    void adopt_outputs(const BindingResolver& previous);
+    
+    // Public for diagnostics: calibration and invert only, before the response stages
     int apply_axis_transform(int value, const AxisTransform& xform, Role role, int src_code) const;
+    
+    // Output for an input through the full compiled pipeline (calibration, response
+    // stages; no smoothing) of the first axis binding on that source, or nullopt
+    std::optional<int> preview_axis(const PhysicalInput& input, int value) const;
 };
 
 std::vector<Binding> make_default_bindings();
 std::vector<Binding> make_bindings_from_config(const std::vector<BindingConfigKey>& config_keys, const std::vector<BindingConfigAbs>& config_abs);
 
 bool validate_bindings(const std::vector<Binding>& bindings);
-
-#ifdef DEBUG_BINDINGS
-extern bool debug_bindings_enabled;
-#define DEBUG_LOG(...) if (debug_bindings_enabled) { printf(__VA_ARGS__); }
-#else
-#define DEBUG_LOG(...)
-#endif
\ No newline at end of file
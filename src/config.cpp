@@ -1,10 +1,15 @@
 // config.cpp - Unified config with profiles
 #include "config.hpp"
 #include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <charconv>
 #include <cstdio>
 #include <cstdlib>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
 #include <iostream>
 
 // Get config path from environment or use default
@@ -25,131 +30,567 @@ std::string ConfigManager::get_config_path() {
     return std::string(home) + "/.config/twcs-mapper/config.json";
 }
 
-std::optional<Config> ConfigManager::load(const std::string& config_path) {
-    std::ifstream file(config_path);
-    if (!file.is_open()) {
-        return std::nullopt;
+namespace {
+
+// Single pass over the whole document. Values are consumed in order and handed
+// out as string_views into the loaded buffer; nothing is copied until a field
+// is stored into the Config. Unknown members are skipped, so the layout is as
+// forgiving as before (any member order, extra keys, missing keys).
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text) : text(text) {}
+    
+    // True if the next value is an object/array and was entered; otherwise the
+    // value is skipped. Then loop on next_member()/next_element() until false.
+    bool begin_object() { return begin('{'); }
+    bool begin_array() { return begin('['); }
+    
+    // Leaves the cursor on the member's value, which the caller must consume
+    bool next_member(std::string_view& key) {
+        if (!next_item('}')) return false;
+        if (peek() != '"') {
+            pos = text.size();
+            return false;
+        }
+        key = read_string();
+        skip_whitespace();
+        if (peek() != ':') {
+            pos = text.size();
+            return false;
+        }
+        pos++;
+        return true;
+    }
+    
+    bool next_element() {
+        return next_item(']');
+    }
+    
+    // Strings give their (still escaped) contents, other scalars their literal text;
+    // objects and arrays are skipped and give an empty view
+    std::string_view scalar() {
+        skip_whitespace();
+        char c = peek();
+        if (c == '"') return read_string();
+        if (c == '{' || c == '[') {
+            skip_value();
+            return {};
+        }
+        size_t start = pos;
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' &&
+               !is_whitespace(text[pos])) {
+            pos++;
+        }
+        return text.substr(start, pos - start);
+    }
+    
+    void skip_value() {
+        skip_whitespace();
+        char c = peek();
+        if (c != '{' && c != '[') {
+            scalar();
+            return;
+        }
+        
+        int depth = 0;
+        while (pos < text.size()) {
+            c = text[pos];
+            if (c == '"') {
+                read_string();
+                continue;
+            }
+            pos++;
+            if (c == '{' || c == '[') {
+                depth++;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return;
+            }
+        }
+    }
+    
+private:
+    std::string_view text;
+    size_t pos = 0;
+    
+    static bool is_whitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+    
+    void skip_whitespace() {
+        while (pos < text.size() && is_whitespace(text[pos])) pos++;
+    }
+    
+    char peek() const {
+        return pos < text.size() ? text[pos] : '\0';
+    }
+    
+    bool begin(char open) {
+        skip_whitespace();
+        if (peek() != open) {
+            skip_value();
+            return false;
+        }
+        pos++;
+        return true;
     }
+    
+    // Steps over the separating comma; false (with the closer consumed) at the end
+    bool next_item(char close) {
+        skip_whitespace();
+        if (peek() == ',') {
+            pos++;
+            skip_whitespace();
+        }
+        if (peek() == close) {
+            pos++;
+            return false;
+        }
+        return pos < text.size();
+    }
+    
+    // Cursor on the opening quote; returns the contents and leaves it past the closing one
+    std::string_view read_string() {
+        size_t start = ++pos;
+        while (pos < text.size() && text[pos] != '"') {
+            pos += (text[pos] == '\\') ? 2 : 1;
+        }
+        size_t end = std::min(pos, text.size());
+        pos = std::min(pos + 1, text.size());
+        return text.substr(start, end - start);
+    }
+};
 
-    std::string json;
-    std::string line;
-    while (std::getline(file, line)) {
-        json += line + "\n";
+std::string unescape_json_string(std::string_view str) {
+    std::string result;
+    result.reserve(str.size());
+    
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] == '\\' && i + 1 < str.size()) {
+            switch (str[i + 1]) {
+                case '"': result += '"'; ++i; break;
+                case '\\': result += '\\'; ++i; break;
+                case 'n': result += '\n'; ++i; break;
+                case 'r': result += '\r'; ++i; break;
+                case 't': result += '\t'; ++i; break;
+                default: result += str[i]; break;
+            }
+        } else {
+            result += str[i];
+        }
     }
+    
+    return result;
+}
 
-    Config config;
+int to_int(std::string_view value, int fallback) {
+    int result = fallback;
+    std::from_chars(value.data(), value.data() + value.size(), result);
+    return result;
+}
+
+float to_float(std::string_view value, float fallback) {
+    float result = fallback;
+    std::from_chars(value.data(), value.data() + value.size(), result);
+    return result;
+}
+
+bool to_bool(std::string_view value) {
+    return value == "true";
+}
+
+void read_profile_switch(JsonReader& reader, ProfileSwitchConfig& profile_switch) {
+    if (!reader.begin_object()) return;
+    
+    std::string_view key;
+    while (reader.next_member(key)) {
+        if (key == "role") {
+            profile_switch.role = unescape_json_string(reader.scalar());
+        } else if (key == "buttons") {
+            if (!reader.begin_array()) continue;
+            while (reader.next_element()) {
+                int code = to_int(reader.scalar(), -1);
+                if (code >= 0) profile_switch.buttons.push_back(code);
+            }
+        } else {
+            reader.skip_value();
+        }
+    }
+}
+
+void read_settings(JsonReader& reader, Config& config) {
+    if (!reader.begin_object()) return;
+    
+    std::string_view key;
+    while (reader.next_member(key)) {
+        if (key == "uinput_name") config.uinput_name = unescape_json_string(reader.scalar());
+        else if (key == "grab") config.grab = to_bool(reader.scalar());
+        else if (key == "realtime") config.realtime = to_bool(reader.scalar());
+        else if (key == "realtime_priority") config.realtime_priority = to_int(reader.scalar(), config.realtime_priority);
+        else if (key == "realtime_cpu") config.realtime_cpu = to_int(reader.scalar(), config.realtime_cpu);
+        else if (key == "lock_memory") config.lock_memory = to_bool(reader.scalar());
+        else if (key == "raw_read") config.raw_read = to_bool(reader.scalar());
+        else if (key == "output_hysteresis") config.output_hysteresis = to_float(reader.scalar(), config.output_hysteresis);
+        else if (key == "output_max_rate_hz") config.output_max_rate_hz = to_int(reader.scalar(), config.output_max_rate_hz);
+        else if (key == "profile_switch") read_profile_switch(reader, config.profile_switch);
+        else reader.skip_value();
+    }
+}
+
+// Device fields shared by the "devices" map and legacy "inputs" entries
+bool read_device_field(JsonReader& reader, std::string_view key, DeviceConfig& device) {
+    if (key == "by_id") device.by_id = unescape_json_string(reader.scalar());
+    else if (key == "vendor") device.vendor = unescape_json_string(reader.scalar());
+    else if (key == "product") device.product = unescape_json_string(reader.scalar());
+    else if (key == "optional") device.optional = to_bool(reader.scalar());
+    else return false;
+    return true;
+}
+
+void read_devices(JsonReader& reader, std::map<std::string, DeviceConfig>& devices) {
+    if (!reader.begin_object()) return;
+    
+    std::string_view role;
+    while (reader.next_member(role)) {
+        if (!reader.begin_object()) continue;
+        
+        DeviceConfig device;
+        device.role = unescape_json_string(role);
+        std::string_view key;
+        while (reader.next_member(key)) {
+            if (!read_device_field(reader, key, device)) reader.skip_value();
+        }
+        devices[device.role] = device;
+    }
+}
+
+AxisCalibration read_calibration(JsonReader& reader) {
+    AxisCalibration cal{0, 0, 65535, 32768, 0};
+    
+    std::string_view key;
+    while (reader.next_member(key)) {
+        if (key == "src_code") cal.src_code = to_int(reader.scalar(), cal.src_code);
+        else if (key == "observed_min") cal.observed_min = to_int(reader.scalar(), cal.observed_min);
+        else if (key == "observed_max") cal.observed_max = to_int(reader.scalar(), cal.observed_max);
+        else if (key == "center_value") cal.center_value = to_int(reader.scalar(), cal.center_value);
+        else if (key == "deadzone_radius") cal.deadzone_radius = to_int(reader.scalar(), cal.deadzone_radius);
+        else reader.skip_value();
+    }
+    return cal;
+}
+
+void read_calibrations(JsonReader& reader, std::map<std::string, std::map<int, AxisCalibration>>& calibrations) {
+    if (!reader.begin_object()) return;
+    
+    std::string_view role;
+    while (reader.next_member(role)) {
+        if (!reader.begin_object()) continue;
+        
+        auto& axes = calibrations[unescape_json_string(role)];
+        std::string_view axis_code;
+        while (reader.next_member(axis_code)) {
+            if (!reader.begin_object()) continue;
+            axes[to_int(axis_code, 0)] = read_calibration(reader);
+        }
+    }
+}
+
+// Fills keys/abs from a {"keys": [...], "abs": [...]} object
+void read_bindings(JsonReader& reader, Profile& profile) {
+    if (!reader.begin_object()) return;
+    
+    std::string_view list;
+    while (reader.next_member(list)) {
+        bool is_keys = (list == "keys");
+        if (!is_keys && list != "abs") {
+            reader.skip_value();
+            continue;
+        }
+        if (!reader.begin_array()) continue;
+        
+        while (reader.next_element()) {
+            if (!reader.begin_object()) continue;
+            
+            BindingConfigAbs binding;
+            bool has_role = false, has_src = false, has_dst = false;
+            std::string_view key;
+            while (reader.next_member(key)) {
+                if (key == "role") {
+                    binding.role = unescape_json_string(reader.scalar());
+                    has_role = true;
+                } else if (key == "src") {
+                    binding.src = to_int(reader.scalar(), 0);
+                    has_src = true;
+                } else if (key == "dst") {
+                    binding.dst = to_int(reader.scalar(), 0);
+                    has_dst = true;
+                } else if (key == "output") {
+                    binding.output = to_int(reader.scalar(), 0);
+                } else if (!is_keys && key == "invert") {
+                    binding.invert = to_bool(reader.scalar());
+                } else if (!is_keys && key == "deadzone") {
+                    binding.deadzone = to_int(reader.scalar(), binding.deadzone);
+                } else if (!is_keys && key == "scale") {
+                    binding.scale = to_float(reader.scalar(), binding.scale);
+                } else if (!is_keys && key == "expo") {
+                    binding.expo = to_float(reader.scalar(), binding.expo);
+                } else if (!is_keys && key == "s_curve") {
+                    binding.s_curve = to_float(reader.scalar(), binding.s_curve);
+                } else if (!is_keys && key == "smoothing") {
+                    binding.smoothing = to_float(reader.scalar(), binding.smoothing);
+                } else {
+                    reader.skip_value();
+                }
+            }
+            
+            if (!has_role || !has_src || !has_dst) continue;
+            if (is_keys) {
+                profile.bindings_keys.push_back({binding.role, binding.src, binding.dst, binding.output});
+            } else {
+                profile.bindings_abs.push_back(binding);
+            }
+        }
+    }
+}
+
+void read_profiles(JsonReader& reader, std::map<std::string, Profile>& profiles) {
+    if (!reader.begin_object()) return;
     
-    // Check version
-    auto version_opt = get_json_value(json, "version");
-    if (version_opt) {
-        config.version = std::stoi(*version_opt);
+    std::string_view id;
+    while (reader.next_member(id)) {
+        if (!reader.begin_object()) continue;
+        
+        std::string profile_id = unescape_json_string(id);
+        Profile profile;
+        profile.name = profile_id;
+        std::string_view key;
+        while (reader.next_member(key)) {
+            if (key == "name") profile.name = unescape_json_string(reader.scalar());
+            else if (key == "description") profile.description = unescape_json_string(reader.scalar());
+            else if (key == "bindings") read_bindings(reader, profile);
+            else reader.skip_value();
+        }
+        profiles[profile_id] = std::move(profile);
     }
+}
+
+void read_outputs(JsonReader& reader, std::vector<OutputConfig>& outputs) {
+    if (!reader.begin_array()) return;
     
-    // Parse settings
-    auto settings_opt = get_json_value(json, "settings");
-    if (settings_opt) {
-        auto uinput_opt = get_json_value(*settings_opt, "uinput_name");
-        if (uinput_opt) config.uinput_name = unescape_json_string(*uinput_opt);
+    while (reader.next_element()) {
+        if (!reader.begin_object()) continue;
+        
+        OutputConfig output;
+        std::string_view key;
+        while (reader.next_member(key)) {
+            if (key == "uinput_name") output.uinput_name = unescape_json_string(reader.scalar());
+            else reader.skip_value();
+        }
+        outputs.push_back(std::move(output));
+    }
+}
+
+// Legacy root "inputs" array: devices with their calibrations embedded
+void read_legacy_inputs(JsonReader& reader, std::map<std::string, DeviceConfig>& devices,
+                        std::map<std::string, std::map<int, AxisCalibration>>& calibrations) {
+    if (!reader.begin_array()) return;
+    
+    while (reader.next_element()) {
+        if (!reader.begin_object()) continue;
+        
+        DeviceConfig device;
+        std::vector<AxisCalibration> input_calibrations;
+        std::string_view key;
+        while (reader.next_member(key)) {
+            if (key == "role") {
+                device.role = unescape_json_string(reader.scalar());
+            } else if (key == "calibrations") {
+                if (!reader.begin_array()) continue;
+                while (reader.next_element()) {
+                    if (reader.begin_object()) input_calibrations.push_back(read_calibration(reader));
+                }
+            } else if (!read_device_field(reader, key, device)) {
+                reader.skip_value();
+            }
+        }
         
-        auto grab_opt = get_json_value(*settings_opt, "grab");
-        if (grab_opt) config.grab = (*grab_opt == "true");
+        if (device.role.empty()) continue;
+        devices[device.role] = device;
+        for (const auto& cal : input_calibrations) {
+            calibrations[device.role][cal.src_code] = cal;
+        }
+    }
+}
+
+// Appends straight into one buffer that is written out in a single call
+class JsonWriter {
+public:
+    explicit JsonWriter(size_t reserve) { out.reserve(reserve); }
+    
+    JsonWriter& raw(std::string_view text) {
+        out.append(text);
+        return *this;
+    }
+    
+    JsonWriter& string(std::string_view str) {
+        out += '"';
+        for (char c : str) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default: out += c; break;
+            }
+        }
+        out += '"';
+        return *this;
+    }
+    
+    JsonWriter& number(int value) {
+        char buffer[16];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+        return *this;
     }
     
-    // Parse devices
-    config.devices = parse_devices(json);
+    // Shortest form that reads back to the same float
+    JsonWriter& number(float value) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+        return *this;
+    }
+    
+    JsonWriter& boolean(bool value) {
+        out.append(value ? "true" : "false");
+        return *this;
+    }
+    
+    const std::string& str() const { return out; }
+    
+private:
+    std::string out;
+};
+
+}  // namespace
+
+// Whole file in one read
+static bool read_file(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamoff size = file.tellg();
+    contents.assign(size > 0 ? static_cast<size_t>(size) : 0, '\0');
+    file.seekg(0);
+    return static_cast<bool>(file.read(contents.data(), static_cast<std::streamsize>(contents.size())));
+}
+
+// Writes to a temp file in the same directory and renames it over path, so
+// readers (and the mapper's file watch) only ever see a complete document.
+// A symlinked path is resolved first so the link's target is replaced rather
+// than the link, and the new file keeps the old one's permissions.
+static bool write_file_atomic(const std::string& config_path, const std::string& contents) {
+    char real_path[PATH_MAX];
+    std::string path = realpath(config_path.c_str(), real_path) ? std::string(real_path) : config_path;
+    
+    std::string temp_path = path + ".tmp";
+    int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat existing;
+    if (stat(path.c_str(), &existing) == 0 && fchmod(fd, existing.st_mode & 07777) != 0) {
+        close(fd);
+        unlink(temp_path.c_str());
+        return false;
+    }
+    
+    size_t written = 0;
+    while (written < contents.size()) {
+        ssize_t result = write(fd, contents.data() + written, contents.size() - written);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) break;
+        written += static_cast<size_t>(result);
+    }
+    bool ok = written == contents.size() && fsync(fd) == 0;
+    ok = (close(fd) == 0) && ok;
+    
+    if (!ok || rename(temp_path.c_str(), path.c_str()) != 0) {
+        unlink(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::optional<Config> ConfigManager::load(const std::string& config_path) {
+    // The reader works on views into this buffer
+    std::string json;
+    if (!read_file(config_path, json)) {
+        return std::nullopt;
+    }
+
+    Config config;
     
-    // Parse calibrations
-    config.calibrations = parse_calibrations(json);
+    // Legacy root "inputs"/"bindings" are only used when the new sections are missing
+    bool has_devices = false;
+    std::map<std::string, DeviceConfig> legacy_devices;
+    std::map<std::string, std::map<int, AxisCalibration>> legacy_calibrations;
+    Profile legacy_profile;
+    std::string active_profile;
+    
+    JsonReader reader(json);
+    if (reader.begin_object()) {
+        std::string_view key;
+        while (reader.next_member(key)) {
+            if (key == "version") {
+                config.version = to_int(reader.scalar(), config.version);
+            } else if (key == "settings") {
+                read_settings(reader, config);
+            } else if (key == "outputs") {
+                read_outputs(reader, config.outputs);
+            } else if (key == "devices") {
+                read_devices(reader, config.devices);
+                has_devices = true;
+            } else if (key == "calibrations") {
+                read_calibrations(reader, config.calibrations);
+            } else if (key == "profiles") {
+                read_profiles(reader, config.profiles);
+            } else if (key == "active_profile") {
+                active_profile = unescape_json_string(reader.scalar());
+            } else if (key == "inputs") {
+                read_legacy_inputs(reader, legacy_devices, legacy_calibrations);
+            } else if (key == "bindings") {
+                read_bindings(reader, legacy_profile);
+            } else {
+                reader.skip_value();
+            }
+        }
+    }
     
-    // Parse profiles
-    config.profiles = parse_profiles(json);
+    if (!has_devices) {
+        config.devices = std::move(legacy_devices);
+    }
     
     // Get active profile
-    auto active_opt = get_json_value(json, "active_profile");
-    if (active_opt && config.profiles.count(*active_opt)) {
-        config.active_profile = *active_opt;
+    if (config.profiles.count(active_profile)) {
+        config.active_profile = active_profile;
     } else if (!config.profiles.empty()) {
         config.active_profile = config.profiles.begin()->first;
     }
     
     // Legacy migration: if old format with inputs/bindings at root, migrate calibrations + profile
     if (config.profiles.empty()) {
-        auto inputs_opt = get_json_value(json, "inputs");
-        if (inputs_opt) {
-            // Migrate embedded calibrations from legacy inputs[] if not already loaded
-            if (config.calibrations.empty()) {
-                std::string inputs_str = *inputs_opt;
-                if (!inputs_str.empty() && inputs_str.front() == '[' && inputs_str.back() == ']') {
-                    inputs_str = inputs_str.substr(1, inputs_str.length() - 2);
-                }
-                
-                size_t pos = 0;
-                while (pos < inputs_str.length()) {
-                    size_t obj_start = inputs_str.find('{', pos);
-                    if (obj_start == std::string::npos) break;
-                    
-                    int brace_count = 1;
-                    size_t obj_end = obj_start + 1;
-                    while (obj_end < inputs_str.length() && brace_count > 0) {
-                        if (inputs_str[obj_end] == '{') brace_count++;
-                        else if (inputs_str[obj_end] == '}') brace_count--;
-                        obj_end++;
-                    }
-                    
-                    if (brace_count == 0) {
-                        std::string obj_str = inputs_str.substr(obj_start, obj_end - obj_start);
-                        std::string role = get_json_value(obj_str, "role").value_or("");
-                        
-                        if (!role.empty()) {
-                            auto cals_opt = get_json_value(obj_str, "calibrations");
-                            if (cals_opt) {
-                                std::string cals_str = *cals_opt;
-                                if (!cals_str.empty() && cals_str.front() == '[' && cals_str.back() == ']') {
-                                    cals_str = cals_str.substr(1, cals_str.length() - 2);
-                                }
-                                
-                                size_t cpos = 0;
-                                while (cpos < cals_str.length()) {
-                                    size_t cal_start = cals_str.find('{', cpos);
-                                    if (cal_start == std::string::npos) break;
-                                    
-                                    int cb = 1;
-                                    size_t cal_end = cal_start + 1;
-                                    while (cal_end < cals_str.length() && cb > 0) {
-                                        if (cals_str[cal_end] == '{') cb++;
-                                        else if (cals_str[cal_end] == '}') cb--;
-                                        cal_end++;
-                                    }
-                                    
-                                    if (cb == 0) {
-                                        std::string cal_obj = cals_str.substr(cal_start, cal_end - cal_start);
-                                        AxisCalibration cal;
-                                        cal.src_code = std::stoi(get_json_value(cal_obj, "src_code").value_or("0"));
-                                        cal.observed_min = std::stoi(get_json_value(cal_obj, "observed_min").value_or("0"));
-                                        cal.observed_max = std::stoi(get_json_value(cal_obj, "observed_max").value_or("65535"));
-                                        cal.center_value = std::stoi(get_json_value(cal_obj, "center_value").value_or("32768"));
-                                        cal.deadzone_radius = std::stoi(get_json_value(cal_obj, "deadzone_radius").value_or("0"));
-                                        config.calibrations[role][cal.src_code] = cal;
-                                    }
-                                    cpos = cal_end;
-                                }
-                            }
-                        }
-                    }
-                    pos = obj_end;
-                }
-            }
+        if (config.calibrations.empty()) {
+            config.calibrations = std::move(legacy_calibrations);
         }
         
         // Create default profile with legacy bindings
-        Profile default_profile;
-        default_profile.name = "Default";
-        default_profile.description = "Migrated from legacy config";
-        default_profile.bindings_keys = parse_bindings_keys(json);
-        default_profile.bindings_abs = parse_bindings_abs(json);
-        
-        if (!default_profile.bindings_keys.empty() || !default_profile.bindings_abs.empty()) {
-            config.profiles["default"] = default_profile;
+        if (!legacy_profile.bindings_keys.empty() || !legacy_profile.bindings_abs.empty()) {
+            legacy_profile.name = "Default";
+            legacy_profile.description = "Migrated from legacy config";
+            config.profiles["default"] = std::move(legacy_profile);
             config.active_profile = "default";
         }
     }
@@ -180,119 +621,157 @@ bool ConfigManager::save(const std::string& config_path, const Config& config) {
         }
     }
 
-    std::ofstream file(config_path);
-    if (!file.is_open()) {
-        return false;
+    // Build the document in one buffer and write it in one call
+    size_t binding_count = 0;
+    for (const auto& [id, profile] : config.profiles) {
+        binding_count += profile.bindings_keys.size() + profile.bindings_abs.size();
     }
+    JsonWriter out(1024 + config.profiles.size() * 256 + binding_count * 160);
 
-    file << "{\n";
-    file << "  \"version\": " << config.version << ",\n";
+    out.raw("{\n");
+    out.raw("  \"version\": ").number(config.version).raw(",\n");
     
     // Settings
-    file << "  \"settings\": {\n";
-    file << "    \"uinput_name\": \"" << escape_json_string(config.uinput_name) << "\",\n";
-    file << "    \"grab\": " << (config.grab ? "true" : "false") << "\n";
-    file << "  },\n";
+    out.raw("  \"settings\": {\n");
+    out.raw("    \"uinput_name\": ").string(config.uinput_name).raw(",\n");
+    out.raw("    \"grab\": ").boolean(config.grab).raw(",\n");
+    out.raw("    \"realtime\": ").boolean(config.realtime).raw(",\n");
+    out.raw("    \"realtime_priority\": ").number(config.realtime_priority).raw(",\n");
+    out.raw("    \"realtime_cpu\": ").number(config.realtime_cpu).raw(",\n");
+    out.raw("    \"lock_memory\": ").boolean(config.lock_memory).raw(",\n");
+    out.raw("    \"raw_read\": ").boolean(config.raw_read).raw(",\n");
+    out.raw("    \"output_hysteresis\": ").number(config.output_hysteresis).raw(",\n");
+    out.raw("    \"output_max_rate_hz\": ").number(config.output_max_rate_hz);
+    if (!config.profile_switch.buttons.empty()) {
+        out.raw(",\n    \"profile_switch\": {\n");
+        out.raw("      \"role\": ").string(config.profile_switch.role).raw(",\n");
+        out.raw("      \"buttons\": [");
+        for (size_t i = 0; i < config.profile_switch.buttons.size(); i++) {
+            if (i > 0) out.raw(", ");
+            out.number(config.profile_switch.buttons[i]);
+        }
+        out.raw("]\n    }");
+    }
+    out.raw("\n  },\n");
+    
+    // Extra outputs (omitted with just the one controller)
+    if (!config.outputs.empty()) {
+        out.raw("  \"outputs\": [\n");
+        for (size_t i = 0; i < config.outputs.size(); i++) {
+            out.raw("    {\n");
+            out.raw("      \"uinput_name\": ").string(config.outputs[i].uinput_name).raw("\n");
+            out.raw(i < config.outputs.size() - 1 ? "    },\n" : "    }\n");
+        }
+        out.raw("  ],\n");
+    }
     
     // Devices
-    file << "  \"devices\": {\n";
+    out.raw("  \"devices\": {\n");
     bool first_device = true;
     for (const auto& [role, device] : config.devices) {
-        if (!first_device) file << ",\n";
+        if (!first_device) out.raw(",\n");
         first_device = false;
         
-        file << "    \"" << escape_json_string(role) << "\": {\n";
-        file << "      \"by_id\": \"" << escape_json_string(device.by_id) << "\",\n";
-        file << "      \"vendor\": \"" << escape_json_string(device.vendor) << "\",\n";
-        file << "      \"product\": \"" << escape_json_string(device.product) << "\",\n";
-        file << "      \"optional\": " << (device.optional ? "true" : "false") << "\n";
-        file << "    }";
+        out.raw("    ").string(role).raw(": {\n");
+        out.raw("      \"by_id\": ").string(device.by_id).raw(",\n");
+        out.raw("      \"vendor\": ").string(device.vendor).raw(",\n");
+        out.raw("      \"product\": ").string(device.product).raw(",\n");
+        out.raw("      \"optional\": ").boolean(device.optional).raw("\n");
+        out.raw("    }");
     }
-    file << "\n  },\n";
+    out.raw("\n  },\n");
     
     // Calibrations
-    file << "  \"calibrations\": {\n";
+    out.raw("  \"calibrations\": {\n");
     bool first_cal_role = true;
     for (const auto& [role, axes] : config.calibrations) {
-        if (!first_cal_role) file << ",\n";
+        if (!first_cal_role) out.raw(",\n");
         first_cal_role = false;
         
-        file << "    \"" << escape_json_string(role) << "\": {\n";
+        out.raw("    ").string(role).raw(": {\n");
         bool first_axis = true;
         for (const auto& [axis_code, cal] : axes) {
-            if (!first_axis) file << ",\n";
+            if (!first_axis) out.raw(",\n");
             first_axis = false;
             
-            file << "      \"" << axis_code << "\": {\n";
-            file << "        \"src_code\": " << cal.src_code << ",\n";
-            file << "        \"observed_min\": " << cal.observed_min << ",\n";
-            file << "        \"observed_max\": " << cal.observed_max << ",\n";
-            file << "        \"center_value\": " << cal.center_value << ",\n";
-            file << "        \"deadzone_radius\": " << cal.deadzone_radius << "\n";
-            file << "      }";
+            out.raw("      \"").number(axis_code).raw("\": {\n");
+            out.raw("        \"src_code\": ").number(cal.src_code).raw(",\n");
+            out.raw("        \"observed_min\": ").number(cal.observed_min).raw(",\n");
+            out.raw("        \"observed_max\": ").number(cal.observed_max).raw(",\n");
+            out.raw("        \"center_value\": ").number(cal.center_value).raw(",\n");
+            out.raw("        \"deadzone_radius\": ").number(cal.deadzone_radius).raw("\n");
+            out.raw("      }");
         }
-        file << "\n    }";
+        out.raw("\n    }");
     }
-    file << "\n  },\n";
+    out.raw("\n  },\n");
     
     // Profiles
-    file << "  \"profiles\": {\n";
+    out.raw("  \"profiles\": {\n");
     bool first_profile = true;
     for (const auto& [id, profile] : config.profiles) {
-        if (!first_profile) file << ",\n";
+        if (!first_profile) out.raw(",\n");
         first_profile = false;
         
-        file << "    \"" << escape_json_string(id) << "\": {\n";
-        file << "      \"name\": \"" << escape_json_string(profile.name) << "\",\n";
-        file << "      \"description\": \"" << escape_json_string(profile.description) << "\",\n";
+        out.raw("    ").string(id).raw(": {\n");
+        out.raw("      \"name\": ").string(profile.name).raw(",\n");
+        out.raw("      \"description\": ").string(profile.description).raw(",\n");
         
         // Keys
-        file << "      \"bindings\": {\n";
-        file << "        \"keys\": [\n";
+        out.raw("      \"bindings\": {\n");
+        out.raw("        \"keys\": [\n");
         for (size_t i = 0; i < profile.bindings_keys.size(); i++) {
             const auto& binding = profile.bindings_keys[i];
-            file << "          {\n";
-            file << "            \"role\": \"" << escape_json_string(binding.role) << "\",\n";
-            file << "            \"src\": " << binding.src << ",\n";
-            file << "            \"dst\": " << binding.dst << "\n";
-            file << "          }";
-            file << (i < profile.bindings_keys.size() - 1 ? ",\n" : "\n");
+            out.raw("          {\n");
+            out.raw("            \"role\": ").string(binding.role).raw(",\n");
+            out.raw("            \"src\": ").number(binding.src).raw(",\n");
+            out.raw("            \"dst\": ").number(binding.dst);
+            if (binding.output != 0) out.raw(",\n            \"output\": ").number(binding.output);
+            out.raw("\n          }");
+            out.raw(i < profile.bindings_keys.size() - 1 ? ",\n" : "\n");
         }
-        file << "        ]";
+        out.raw("        ]");
         
         // ABS
         if (!profile.bindings_abs.empty()) {
-            file << ",\n        \"abs\": [\n";
+            out.raw(",\n        \"abs\": [\n");
             for (size_t i = 0; i < profile.bindings_abs.size(); i++) {
                 const auto& binding = profile.bindings_abs[i];
-                file << "          {\n";
-                file << "            \"role\": \"" << escape_json_string(binding.role) << "\",\n";
-                file << "            \"src\": " << binding.src << ",\n";
-                file << "            \"dst\": " << binding.dst << ",\n";
-                file << "            \"invert\": " << (binding.invert ? "true" : "false") << ",\n";
-                file << "            \"deadzone\": " << binding.deadzone << ",\n";
-                
-                std::ostringstream scale_stream;
-                scale_stream << binding.scale;
-                file << "            \"scale\": " << scale_stream.str() << "\n";
-                file << "          }";
-                file << (i < profile.bindings_abs.size() - 1 ? ",\n" : "\n");
+                out.raw("          {\n");
+                out.raw("            \"role\": ").string(binding.role).raw(",\n");
+                out.raw("            \"src\": ").number(binding.src).raw(",\n");
+                out.raw("            \"dst\": ").number(binding.dst).raw(",\n");
+                out.raw("            \"invert\": ").boolean(binding.invert).raw(",\n");
+                out.raw("            \"deadzone\": ").number(binding.deadzone).raw(",\n");
+                out.raw("            \"scale\": ").number(binding.scale);
+                // Response stages are written only when set, like output
+                if (binding.expo != 0.0f) out.raw(",\n            \"expo\": ").number(binding.expo);
+                if (binding.s_curve != 0.0f) out.raw(",\n            \"s_curve\": ").number(binding.s_curve);
+                if (binding.smoothing != 0.0f) out.raw(",\n            \"smoothing\": ").number(binding.smoothing);
+                if (binding.output != 0) out.raw(",\n            \"output\": ").number(binding.output);
+                out.raw("\n          }");
+                out.raw(i < profile.bindings_abs.size() - 1 ? ",\n" : "\n");
             }
-            file << "        ]\n";
+            out.raw("        ]\n");
         } else {
-            file << "\n";
+            out.raw("\n");
         }
-        file << "      }\n";
-        file << "    }";
+        out.raw("      }\n");
+        out.raw("    }");
     }
-    file << "\n  },\n";
+    out.raw("\n  },\n");
     
     // Active profile
-    file << "  \"active_profile\": \"" << escape_json_string(config.active_profile) << "\"\n";
-    
-    file << "}";
+    out.raw("  \"active_profile\": ").string(config.active_profile).raw("\n");
     
-    return file.good();
+    out.raw("}");
+
+    // Saving what is already there would only wake the file watch for nothing
+    std::string existing;
+    if (read_file(config_path, existing) && existing == out.str()) {
+        return true;
+    }
+    return write_file_atomic(config_path, out.str());
 }
 
 // Profile management
@@ -382,464 +861,3 @@ std::optional<AxisCalibration> Config::get_calibration(const std::string& role,
 void Config::set_calibration(const std::string& role, int axis_code, const AxisCalibration& cal) {
     calibrations[role][axis_code] = cal;
 }
-
-// JSON parsing helpers
-std::map<std::string, DeviceConfig> ConfigManager::parse_devices(const std::string& json) {
-    std::map<std::string, DeviceConfig> devices;
-    
-    auto devices_opt = get_json_value(json, "devices");
-    if (!devices_opt) {
-        // Try legacy format
-        auto inputs_opt = get_json_value(json, "inputs");
-        if (!inputs_opt) return devices;
-        
-        // Parse legacy inputs array
-        std::string inputs_str = *inputs_opt;
-        if (!inputs_str.empty() && inputs_str.front() == '[' && inputs_str.back() == ']') {
-            inputs_str = inputs_str.substr(1, inputs_str.length() - 2);
-        }
-        
-        size_t pos = 0;
-        while (pos < inputs_str.length()) {
-            size_t obj_start = inputs_str.find('{', pos);
-            if (obj_start == std::string::npos) break;
-            
-            int brace_count = 1;
-            size_t obj_end = obj_start + 1;
-            while (obj_end < inputs_str.length() && brace_count > 0) {
-                if (inputs_str[obj_end] == '{') brace_count++;
-                else if (inputs_str[obj_end] == '}') brace_count--;
-                obj_end++;
-            }
-            
-            if (brace_count == 0) {
-                std::string obj_str = inputs_str.substr(obj_start, obj_end - obj_start);
-                
-                DeviceConfig device;
-                device.role = get_json_value(obj_str, "role").value_or("");
-                device.by_id = get_json_value(obj_str, "by_id").value_or("");
-                device.vendor = get_json_value(obj_str, "vendor").value_or("");
-                device.product = get_json_value(obj_str, "product").value_or("");
-                device.optional = get_json_value(obj_str, "optional").value_or("false") == "true";
-                
-                if (!device.role.empty()) {
-                    devices[device.role] = device;
-                }
-            }
-            pos = obj_end;
-        }
-        return devices;
-    }
-    
-    // Parse new format
-    std::string devices_str = *devices_opt;
-    if (devices_str.empty() || devices_str.front() != '{' || devices_str.back() != '}') {
-        return devices;
-    }
-    
-    devices_str = devices_str.substr(1, devices_str.length() - 2);
-    
-    // Parse key-value pairs
-    size_t pos = 0;
-    while (pos < devices_str.length()) {
-        // Find key
-        size_t key_start = devices_str.find('"', pos);
-        if (key_start == std::string::npos) break;
-        
-        size_t key_end = devices_str.find('"', key_start + 1);
-        if (key_end == std::string::npos) break;
-        
-        std::string role = unescape_json_string(devices_str.substr(key_start + 1, key_end - key_start - 1));
-        
-        // Find value object
-        size_t obj_start = devices_str.find('{', key_end);
-        if (obj_start == std::string::npos) break;
-        
-        int brace_count = 1;
-        size_t obj_end = obj_start + 1;
-        while (obj_end < devices_str.length() && brace_count > 0) {
-            if (devices_str[obj_end] == '{') brace_count++;
-            else if (devices_str[obj_end] == '}') brace_count--;
-            obj_end++;
-        }
-        
-        if (brace_count == 0) {
-            std::string obj_str = devices_str.substr(obj_start, obj_end - obj_start);
-            
-            DeviceConfig device;
-            device.role = role;
-            device.by_id = get_json_value(obj_str, "by_id").value_or("");
-            device.vendor = get_json_value(obj_str, "vendor").value_or("");
-            device.product = get_json_value(obj_str, "product").value_or("");
-            device.optional = get_json_value(obj_str, "optional").value_or("false") == "true";
-            
-            devices[role] = device;
-        }
-        
-        pos = obj_end;
-    }
-    
-    return devices;
-}
-
-std::map<std::string, std::map<int, AxisCalibration>> ConfigManager::parse_calibrations(const std::string& json) {
-    std::map<std::string, std::map<int, AxisCalibration>> calibrations;
-    
-    auto cal_opt = get_json_value(json, "calibrations");
-    if (!cal_opt) return calibrations;
-    
-    std::string cal_str = *cal_opt;
-    if (cal_str.empty() || cal_str.front() != '{' || cal_str.back() != '}') {
-        return calibrations;
-    }
-    
-    cal_str = cal_str.substr(1, cal_str.length() - 2);
-    
-    size_t pos = 0;
-    while (pos < cal_str.length()) {
-        size_t key_start = cal_str.find('"', pos);
-        if (key_start == std::string::npos) break;
-        
-        size_t key_end = cal_str.find('"', key_start + 1);
-        if (key_end == std::string::npos) break;
-        
-        std::string role = unescape_json_string(cal_str.substr(key_start + 1, key_end - key_start - 1));
-        
-        size_t obj_start = cal_str.find('{', key_end);
-        if (obj_start == std::string::npos) break;
-        
-        int brace_count = 1;
-        size_t obj_end = obj_start + 1;
-        while (obj_end < cal_str.length() && brace_count > 0) {
-            if (cal_str[obj_end] == '{') brace_count++;
-            else if (cal_str[obj_end] == '}') brace_count--;
-            obj_end++;
-        }
-        
-        if (brace_count == 0) {
-            std::string axes_str = cal_str.substr(obj_start, obj_end - obj_start);
-            
-            // Parse axis calibrations
-            size_t axis_pos = 0;
-            while (axis_pos < axes_str.length()) {
-                size_t axis_key_start = axes_str.find('"', axis_pos);
-                if (axis_key_start == std::string::npos) break;
-                
-                size_t axis_key_end = axes_str.find('"', axis_key_start + 1);
-                if (axis_key_end == std::string::npos) break;
-                
-                int axis_code = std::stoi(axes_str.substr(axis_key_start + 1, axis_key_end - axis_key_start - 1));
-                
-                size_t cal_obj_start = axes_str.find('{', axis_key_end);
-                if (cal_obj_start == std::string::npos) break;
-                
-                int cal_brace_count = 1;
-                size_t cal_obj_end = cal_obj_start + 1;
-                while (cal_obj_end < axes_str.length() && cal_brace_count > 0) {
-                    if (axes_str[cal_obj_end] == '{') cal_brace_count++;
-                    else if (axes_str[cal_obj_end] == '}') cal_brace_count--;
-                    cal_obj_end++;
-                }
-                
-                if (cal_brace_count == 0) {
-                    std::string cal_obj = axes_str.substr(cal_obj_start, cal_obj_end - cal_obj_start);
-                    
-                    AxisCalibration cal;
-                    cal.src_code = std::stoi(get_json_value(cal_obj, "src_code").value_or("0"));
-                    cal.observed_min = std::stoi(get_json_value(cal_obj, "observed_min").value_or("0"));
-                    cal.observed_max = std::stoi(get_json_value(cal_obj, "observed_max").value_or("65535"));
-                    cal.center_value = std::stoi(get_json_value(cal_obj, "center_value").value_or("32768"));
-                    cal.deadzone_radius = std::stoi(get_json_value(cal_obj, "deadzone_radius").value_or("0"));
-                    
-                    calibrations[role][axis_code] = cal;
-                }
-                
-                axis_pos = cal_obj_end;
-            }
-        }
-        
-        pos = obj_end;
-    }
-    
-    return calibrations;
-}
-
-std::map<std::string, Profile> ConfigManager::parse_profiles(const std::string& json) {
-    std::map<std::string, Profile> profiles;
-    
-    auto profiles_opt = get_json_value(json, "profiles");
-    if (!profiles_opt) return profiles;
-    
-    std::string profiles_str = *profiles_opt;
-    if (profiles_str.empty() || profiles_str.front() != '{' || profiles_str.back() != '}') {
-        return profiles;
-    }
-    
-    profiles_str = profiles_str.substr(1, profiles_str.length() - 2);
-    
-    size_t pos = 0;
-    while (pos < profiles_str.length()) {
-        size_t key_start = profiles_str.find('"', pos);
-        if (key_start == std::string::npos) break;
-        
-        size_t key_end = profiles_str.find('"', key_start + 1);
-        if (key_end == std::string::npos) break;
-        
-        std::string profile_id = unescape_json_string(profiles_str.substr(key_start + 1, key_end - key_start - 1));
-        
-        size_t obj_start = profiles_str.find('{', key_end);
-        if (obj_start == std::string::npos) break;
-        
-        int brace_count = 1;
-        size_t obj_end = obj_start + 1;
-        while (obj_end < profiles_str.length() && brace_count > 0) {
-            if (profiles_str[obj_end] == '{') brace_count++;
-            else if (profiles_str[obj_end] == '}') brace_count--;
-            obj_end++;
-        }
-        
-        if (brace_count == 0) {
-            std::string profile_obj = profiles_str.substr(obj_start, obj_end - obj_start);
-            Profile profile;
-            profile.name = unescape_json_string(get_json_value(profile_obj, "name").value_or(profile_id));
-            profile.description = unescape_json_string(get_json_value(profile_obj, "description").value_or(""));
-            profile.bindings_keys = parse_bindings_keys(profile_obj);
-            profile.bindings_abs = parse_bindings_abs(profile_obj);
-            
-            profiles[profile_id] = profile;
-        }
-        
-        pos = obj_end;
-    }
-    
-    return profiles;
-}
-
-// Legacy binding parsers (reuse existing)
-std::vector<BindingConfigKey> ConfigManager::parse_bindings_keys(const std::string& json) {
-    std::vector<BindingConfigKey> bindings;
-
-    auto bindings_obj_opt = get_json_value(json, "bindings");
-    if (!bindings_obj_opt) return bindings;
-
-    auto keys_array_opt = get_json_value(*bindings_obj_opt, "keys");
-    if (!keys_array_opt) return bindings;
-
-    std::string keys_str = *keys_array_opt;
-    if (!keys_str.empty() && keys_str.front() == '[' && keys_str.back() == ']') {
-        keys_str = keys_str.substr(1, keys_str.length() - 2);
-    }
-
-    size_t pos = 0;
-    while (pos < keys_str.length()) {
-        size_t obj_start = keys_str.find('{', pos);
-        if (obj_start == std::string::npos) break;
-
-        int brace_count = 1;
-        size_t obj_end = obj_start + 1;
-        while (obj_end < keys_str.length() && brace_count > 0) {
-            if (keys_str[obj_end] == '{') brace_count++;
-            else if (keys_str[obj_end] == '}') brace_count--;
-            obj_end++;
-        }
-
-        if (brace_count == 0) {
-            std::string obj_str = keys_str.substr(obj_start, obj_end - obj_start);
-
-            BindingConfigKey binding;
-            auto role_opt = get_json_value(obj_str, "role");
-            auto src_opt = get_json_value(obj_str, "src");
-            auto dst_opt = get_json_value(obj_str, "dst");
-
-            if (role_opt && src_opt && dst_opt) {
-                binding.role = *role_opt;
-                binding.src = std::stoi(*src_opt);
-                binding.dst = std::stoi(*dst_opt);
-                bindings.push_back(binding);
-            }
-        }
-
-        pos = obj_end;
-    }
-
-    return bindings;
-}
-
-std::vector<BindingConfigAbs> ConfigManager::parse_bindings_abs(const std::string& json) {
-    std::vector<BindingConfigAbs> bindings;
-
-    auto bindings_obj_opt = get_json_value(json, "bindings");
-    if (!bindings_obj_opt) return bindings;
-
-    auto abs_array_opt = get_json_value(*bindings_obj_opt, "abs");
-    if (!abs_array_opt) return bindings;
-
-    std::string abs_str = *abs_array_opt;
-    if (!abs_str.empty() && abs_str.front() == '[' && abs_str.back() == ']') {
-        abs_str = abs_str.substr(1, abs_str.length() - 2);
-    }
-
-    size_t pos = 0;
-    while (pos < abs_str.length()) {
-        size_t obj_start = abs_str.find('{', pos);
-        if (obj_start == std::string::npos) break;
-
-        int brace_count = 1;
-        size_t obj_end = obj_start + 1;
-        while (obj_end < abs_str.length() && brace_count > 0) {
-            if (abs_str[obj_end] == '{') brace_count++;
-            else if (abs_str[obj_end] == '}') brace_count--;
-            obj_end++;
-        }
-
-        if (brace_count == 0) {
-            std::string obj_str = abs_str.substr(obj_start, obj_end - obj_start);
-
-            BindingConfigAbs binding;
-            auto role_opt = get_json_value(obj_str, "role");
-            auto src_opt = get_json_value(obj_str, "src");
-            auto dst_opt = get_json_value(obj_str, "dst");
-
-            if (role_opt && src_opt && dst_opt) {
-                binding.role = *role_opt;
-                binding.src = std::stoi(*src_opt);
-                binding.dst = std::stoi(*dst_opt);
-
-                auto invert_opt = get_json_value(obj_str, "invert");
-                if (invert_opt) binding.invert = (*invert_opt == "true");
-
-                auto deadzone_opt = get_json_value(obj_str, "deadzone");
-                if (deadzone_opt) binding.deadzone = std::stoi(*deadzone_opt);
-
-                auto scale_opt = get_json_value(obj_str, "scale");
-                if (scale_opt) binding.scale = std::stof(*scale_opt);
-
-                bindings.push_back(binding);
-            }
-        }
-
-        pos = obj_end;
-    }
-
-    return bindings;
-}
-
-// JSON helpers (copied from original)
-std::string ConfigManager::escape_json_string(const std::string& str) {
-    std::string result;
-    result.reserve(str.size() + 10);
-
-    for (char c : str) {
-        switch (c) {
-            case '"': result += "\\\""; break;
-            case '\\': result += "\\\\"; break;
-            case '\n': result += "\\n"; break;
-            case '\r': result += "\\r"; break;
-            case '\t': result += "\\t"; break;
-            default: result += c; break;
-        }
-    }
-
-    return result;
-}
-
-std::string ConfigManager::unescape_json_string(const std::string& str) {
-    std::string result;
-    result.reserve(str.size());
-
-    for (size_t i = 0; i < str.size(); ++i) {
-        if (str[i] == '\\' && i + 1 < str.size()) {
-            switch (str[i + 1]) {
-                case '"': result += '"'; ++i; break;
-                case '\\': result += '\\'; ++i; break;
-                case 'n': result += '\n'; ++i; break;
-                case 'r': result += '\r'; ++i; break;
-                case 't': result += '\t'; ++i; break;
-                default: result += str[i]; break;
-            }
-        } else {
-            result += str[i];
-        }
-    }
-
-    return result;
-}
-
-std::optional<std::string> ConfigManager::get_json_value(const std::string& json, std::string_view key) {
-    std::string search_key = "\"";
-    search_key += key;
-    search_key += "\"";
-
-    size_t key_pos = json.find(search_key);
-    if (key_pos == std::string::npos) {
-        return std::nullopt;
-    }
-
-    size_t colon_pos = json.find(':', key_pos);
-    if (colon_pos == std::string::npos) {
-        return std::nullopt;
-    }
-
-    size_t value_start = json.find_first_not_of(" \t", colon_pos + 1);
-    if (value_start == std::string::npos) {
-        return std::nullopt;
-    }
-
-    // Handle object/array values
-    if (value_start < json.size() && (json[value_start] == '[' || json[value_start] == '{')) {
-        const char open = json[value_start];
-        const char close = (open == '[') ? ']' : '}';
-        int depth = 0;
-        bool in_string = false;
-        bool escape = false;
-
-        for (size_t i = value_start; i < json.size(); ++i) {
-            const char c = json[i];
-
-            if (in_string) {
-                if (escape) { escape = false; continue; }
-                if (c == '\\') { escape = true; continue; }
-                if (c == '"') in_string = false;
-                continue;
-            }
-
-            if (c == '"') { in_string = true; continue; }
-            if (c == open) { depth++; continue; }
-            if (c == close) {
-                depth--;
-                if (depth == 0) {
-                    return json.substr(value_start, (i - value_start) + 1);
-                }
-            }
-        }
-        return std::nullopt;
-    }
-
-    if (json[value_start] == '"') {
-        size_t value_end = json.find('"', value_start + 1);
-        if (value_end == std::string::npos) {
-            return std::nullopt;
-        }
-
-        size_t end = value_end;
-        while (end + 1 < json.size() && json[end] == '"' && json[end - 1] == '\\') {
-            end = json.find('"', end + 1);
-            if (end == std::string::npos) break;
-        }
-        if (end == std::string::npos) {
-            end = value_end;
-        }
-
-        return json.substr(value_start + 1, end - (value_start + 1));
-    } else {
-        size_t value_end = json.find_first_of(",}\n", value_start);
-        if (value_end == std::string::npos) {
-            value_end = json.size();
-        }
-
-        std::string value = json.substr(value_start, value_end - value_start);
-        value.erase(0, value.find_first_not_of(" \t\r\n"));
-        value.erase(value.find_last_not_of(" \t\r\n") + 1);
-        return value;
-    }
-}
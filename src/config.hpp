@@ -15,6 +15,8 @@ struct AxisCalibration {
     int observed_max;
     int center_value;
     int deadzone_radius;
+    
+    bool operator==(const AxisCalibration&) const = default;
 };
 
 struct DeviceConfig {
@@ -23,12 +25,17 @@ struct DeviceConfig {
     std::string vendor;
     std::string product;
     bool optional = false;
+    
+    bool operator==(const DeviceConfig&) const = default;
 };
 
 struct BindingConfigKey {
     std::string role;
     int src;
     int dst;
+    int output = 0;  // Virtual device index, see Config::outputs
+    
+    bool operator==(const BindingConfigKey&) const = default;
 };
 
 struct BindingConfigAbs {
@@ -38,6 +45,27 @@ struct BindingConfigAbs {
     bool invert = false;
     int deadzone = 0;
     float scale = 1.0f;
+    int output = 0;
+    float expo = 0.0f;       // Response stages, see AxisTransform
+    float s_curve = 0.0f;
+    float smoothing = 0.0f;
+    
+    bool operator==(const BindingConfigAbs&) const = default;
+};
+
+// An additional virtual controller; bindings with "output": N > 0 drive outputs[N - 1]
+struct OutputConfig {
+    std::string uinput_name;
+    
+    bool operator==(const OutputConfig&) const = default;
+};
+
+// Buttons that, held together, switch the mapper to the next profile
+struct ProfileSwitchConfig {
+    std::string role;          // Device role the buttons are on
+    std::vector<int> buttons;  // EV_KEY codes; empty disables switching
+    
+    bool operator==(const ProfileSwitchConfig&) const = default;
 };
 
 struct Profile {
@@ -45,6 +73,8 @@ struct Profile {
     std::string description;
     std::vector<BindingConfigKey> bindings_keys;
     std::vector<BindingConfigAbs> bindings_abs;
+    
+    bool operator==(const Profile&) const = default;
 };
 
 // Single unified config structure
@@ -55,6 +85,25 @@ struct Config {
     std::string uinput_name = "Thrustmaster ARMA Virtual";
     bool grab = true;
     
+    // Real-time mode (opt-in): event translation on its own SCHED_FIFO thread
+    bool realtime = false;
+    int realtime_priority = 50;  // SCHED_FIFO priority, 1-99
+    int realtime_cpu = -1;       // CPU to pin the event thread to, -1 for no pinning
+    bool lock_memory = true;     // mlockall() in real-time mode
+    
+    // Read input_event arrays straight from the device fd; libevdev only handles SYN_DROPPED recovery
+    bool raw_read = false;
+    
+    // Output scheduling toward the game (see OutputScheduler); 0 disables each
+    float output_hysteresis = 0.0f;  // Axis changes below this percent of the axis range are dropped
+    int output_max_rate_hz = 0;      // Max axis-only frames per second, latest values coalesced
+    
+    // Cycles through profiles in name order while the mapper runs
+    ProfileSwitchConfig profile_switch;
+    
+    // Virtual controllers beyond the first (which is uinput_name), same contract each
+    std::vector<OutputConfig> outputs;
+    
     // Device paths (shared across all profiles)
     std::map<std::string, DeviceConfig> devices;  // role -> device
     
@@ -72,12 +121,15 @@ struct Config {
     // Get calibration for a role/axis
     std::optional<AxisCalibration> get_calibration(const std::string& role, int axis_code) const;
     void set_calibration(const std::string& role, int axis_code, const AxisCalibration& cal);
+    
+    bool operator==(const Config&) const = default;
 };
 
 class ConfigManager {
 public:
     static std::string get_config_path();
     static std::optional<Config> load(const std::string& config_path);
+    // Atomic (temp file + rename); an unchanged document is not rewritten
     static bool save(const std::string& config_path, const Config& config);
     
     // Profile management
@@ -87,17 +139,4 @@ public:
     static bool delete_profile(Config& config, const std::string& name);
     static bool duplicate_profile(Config& config, const std::string& source_name,
                                   const std::string& dest_name);
-    
-private:
-    static std::string escape_json_string(const std::string& str);
-    static std::string unescape_json_string(const std::string& str);
-    static std::optional<std::string> get_json_value(const std::string& json, std::string_view key);
-    
-    // New parsing functions
-    static std::map<std::string, DeviceConfig> parse_devices(const std::string& json);
-    static std::map<std::string, std::map<int, AxisCalibration>> parse_calibrations(const std::string& json);
-    static std::map<std::string, Profile> parse_profiles(const std::string& json);
-    static Profile parse_single_profile(const std::string& json);
-    static std::vector<BindingConfigKey> parse_bindings_keys(const std::string& json);
-    static std::vector<BindingConfigAbs> parse_bindings_abs(const std::string& json);
 };
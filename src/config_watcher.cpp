@@ -0,0 +1,84 @@
+#include "config_watcher.hpp"
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdio>
+
+ConfigWatcher::ConfigWatcher() : inotify_fd(-1), dir_wd(-1) {
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    cleanup();
+}
+
+bool ConfigWatcher::initialize(const std::string& config_path) {
+    if (inotify_fd >= 0) {
+        return true;
+    }
+    
+    // Saves replace a symlinked config's target, so watch the target's directory
+    char real_path[PATH_MAX];
+    std::string path = realpath(config_path.c_str(), real_path) ? std::string(real_path) : config_path;
+    size_t last_slash = path.find_last_of('/');
+    std::string dir = (last_slash == std::string::npos) ? "." : path.substr(0, last_slash);
+    if (dir.empty()) dir = "/";
+    file_name = (last_slash == std::string::npos) ? path : path.substr(last_slash + 1);
+    
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0) {
+        perror("Failed to create inotify instance");
+        return false;
+    }
+    
+    // IN_MOVED_TO: atomic save renamed over the file; IN_CLOSE_WRITE: edited in place
+    dir_wd = inotify_add_watch(inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (dir_wd < 0) {
+        perror(("Failed to watch " + dir).c_str());
+        cleanup();
+        return false;
+    }
+    return true;
+}
+
+void ConfigWatcher::cleanup() {
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+        inotify_fd = -1;
+    }
+    dir_wd = -1;
+}
+
+bool ConfigWatcher::drain() {
+    if (inotify_fd < 0) {
+        return false;
+    }
+    
+    bool changed = false;
+    alignas(struct inotify_event) char buffer[4096];
+    
+    while (true) {
+        ssize_t len = read(inotify_fd, buffer, sizeof(buffer));
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            break; // EAGAIN: queue empty
+        }
+        if (len == 0) {
+            break;
+        }
+        
+        for (char* ptr = buffer; ptr < buffer + len;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+            
+            if (event->mask & IN_Q_OVERFLOW) {
+                changed = true;
+            } else if (event->wd == dir_wd && event->len > 0 && file_name == event->name) {
+                changed = true;
+            }
+        }
+    }
+    
+    return changed;
+}
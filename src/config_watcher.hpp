@@ -0,0 +1,27 @@
+#ifndef CONFIG_WATCHER_HPP
+#define CONFIG_WATCHER_HPP
+
+#include <string>
+
+// Watches the config file for saves. The directory is watched rather than the
+// file, since an atomic save (write + rename) replaces the file's inode.
+class ConfigWatcher {
+public:
+    ConfigWatcher();
+    ~ConfigWatcher();
+    
+    bool initialize(const std::string& config_path);
+    void cleanup();
+    
+    int get_fd() const { return inotify_fd; }
+    
+    // Reads all queued notifications; true if the config file was written or replaced
+    bool drain();
+
+private:
+    int inotify_fd;
+    int dir_wd;
+    std::string file_name;
+};
+
+#endif // CONFIG_WATCHER_HPP
@@ -0,0 +1,137 @@
+#include "device_discovery.hpp"
+#include "device_identity.hpp"
+#include <libevdev-1.0/libevdev/libevdev.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+std::vector<std::string> DeviceDiscovery::list_event_links(const std::string& dir) {
+    std::vector<std::string> links;
+    DIR* handle = opendir(dir.c_str());
+    if (!handle) return links;
+    
+    struct dirent* entry;
+    while ((entry = readdir(handle)) != nullptr) {
+        if (strstr(entry->d_name, "event") == nullptr) continue;
+        links.push_back(dir + "/" + entry->d_name);
+    }
+    closedir(handle);
+    
+    std::sort(links.begin(), links.end());
+    return links;
+}
+
+std::vector<ProbedDevice> DeviceDiscovery::scan(const std::vector<std::string>& links) {
+    std::vector<ProbedDevice> results(links.size());
+    std::vector<size_t> pending;
+    
+    // stat() follows the link without opening the node, which is all an unchanged device costs
+    for (size_t i = 0; i < links.size(); i++) {
+        ProbedDevice& device = results[i];
+        device.by_id = links[i];
+        
+        struct stat st;
+        if (stat(links[i].c_str(), &st) < 0) {
+            device.error = "Failed to resolve " + links[i];
+            cache.erase(links[i]);
+            continue;
+        }
+        
+        auto it = cache.find(links[i]);
+        if (it != cache.end() && it->second.inode == st.st_ino && it->second.rdev == st.st_rdev) {
+            device = it->second;
+            continue;
+        }
+        device.inode = st.st_ino;
+        device.rdev = st.st_rdev;
+        pending.push_back(i);
+    }
+    
+    // Opening a node can block on the device (USB resume, hub enumeration), so
+    // probes overlap; each worker takes the next pending link until none are left
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t job = next++; job < pending.size(); job = next++) {
+            probe(results[pending[job]]);
+        }
+    };
+    size_t thread_count = std::min(pending.size(), MAX_PROBE_THREADS);
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < thread_count; t++) {
+        threads.emplace_back(worker);
+    }
+    if (thread_count > 0) worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    for (size_t i : pending) {
+        const ProbedDevice& device = results[i];
+        if (!device.ok()) {
+            cache.erase(device.by_id);
+            continue;
+        }
+        ProbedDevice& cached = cache[device.by_id];
+        cached = device;
+        cached.fd = -1;
+        cached.dev = nullptr;
+    }
+    return results;
+}
+
+bool DeviceDiscovery::open_handle(ProbedDevice& device) {
+    int fd = open(device.path.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd < 0) return false;
+    
+    struct libevdev* dev = nullptr;
+    int rc = libevdev_new_from_fd(fd, &dev);
+    if (rc != 0) {
+        close(fd);
+        errno = -rc;
+        return false;
+    }
+    device.fd = fd;
+    device.dev = dev;
+    return true;
+}
+
+void DeviceDiscovery::probe(ProbedDevice& device) {
+    char real_path[PATH_MAX];
+    if (realpath(device.by_id.c_str(), real_path) == nullptr) {
+        device.error = "Failed to resolve " + device.by_id;
+        return;
+    }
+    device.path = real_path;
+    
+    if (!open_handle(device)) {
+        device.error = "Failed to open " + device.by_id + " (" + strerror(errno) + ")";
+        return;
+    }
+    
+    const char* name = libevdev_get_name(device.dev);
+    device.name = name ? name : "Unknown";
+    for (int code = 0; code <= ABS_MAX; code++) {
+        if (libevdev_has_event_code(device.dev, EV_ABS, code)) {
+            device.axes.push_back(code);
+        }
+    }
+    for (int code = BTN_JOYSTICK; code < BTN_DIGI; code++) {
+        if (libevdev_has_event_code(device.dev, EV_KEY, code)) {
+            device.buttons.push_back(code);
+        }
+    }
+    
+    // read_device_identity has no shared cache, so it is safe from the workers
+    if (auto identity = read_device_identity(device.path)) {
+        device.vendor = identity->vendor;
+        device.product = identity->product;
+    }
+}
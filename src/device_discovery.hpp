@@ -0,0 +1,56 @@
+#ifndef DEVICE_DISCOVERY_HPP
+#define DEVICE_DISCOVERY_HPP
+
+#include <sys/types.h>
+#include <map>
+#include <string>
+#include <vector>
+
+struct libevdev;
+
+// One evdev node behind a /dev/input/by-id style link, with the capability
+// lists the tools show. fd and dev are set only when this scan opened the
+// node; the caller then owns them (libevdev_free + close).
+struct ProbedDevice {
+    std::string by_id;
+    std::string path;     // Resolved /dev/input/eventN
+    ino_t inode = 0;      // Of the event node; a re-created node gets a new one
+    dev_t rdev = 0;
+    std::string name;
+    std::string vendor;   // sysfs id, formatted like DeviceIdentity
+    std::string product;
+    std::vector<int> axes;     // ABS codes
+    std::vector<int> buttons;  // BTN_JOYSTICK..BTN_DIGI
+    
+    int fd = -1;
+    struct libevdev* dev = nullptr;
+    std::string error;    // Why the probe failed; empty on success
+    
+    bool ok() const { return error.empty(); }
+};
+
+// Finds input devices without serializing on slow nodes: links whose event
+// node is unchanged since the last scan (same by-id path, inode and device
+// number) come straight from the capability cache without being opened, and
+// everything else is opened and probed on a few worker threads at once.
+class DeviceDiscovery {
+public:
+    static constexpr size_t MAX_PROBE_THREADS = 8;
+    
+    // Event links in dir ("...event-joystick" etc.), sorted for a stable order
+    static std::vector<std::string> list_event_links(const std::string& dir = "/dev/input/by-id");
+    
+    // One result per link, in order. Failed probes carry an error and are
+    // dropped from the cache, so the next scan retries them.
+    std::vector<ProbedDevice> scan(const std::vector<std::string>& links);
+    
+    // Opens a handle on a node that came from the cache; false with errno on failure
+    static bool open_handle(ProbedDevice& device);
+
+private:
+    std::map<std::string, ProbedDevice> cache;  // by-id link -> capabilities (no handles)
+    
+    static void probe(ProbedDevice& device);
+};
+
+#endif // DEVICE_DISCOVERY_HPP
@@ -0,0 +1,85 @@
+#include "device_identity.hpp"
+#include <fstream>
+#include <map>
+#include <limits.h>
+#include <stdlib.h>
+
+namespace {
+
+struct CachedIdentity {
+    std::string node_path;
+    DeviceIdentity identity;
+};
+
+std::map<std::string, CachedIdentity> identity_cache;
+
+bool read_sysfs_line(const std::string& path, std::string& value) {
+    std::ifstream file(path);
+    if (!file || !std::getline(file, value)) {
+        return false;
+    }
+    while (!value.empty() && (value.back() == '\n' || value.back() == ' ')) {
+        value.pop_back();
+    }
+    return true;
+}
+
+std::string resolve_node(const std::string& device_path) {
+    char real_path[PATH_MAX];
+    if (realpath(device_path.c_str(), real_path) == nullptr) {
+        return "";
+    }
+    return real_path;
+}
+
+std::optional<DeviceIdentity> read_node_identity(const std::string& node_path) {
+    // /dev/input/eventN -> /sys/class/input/eventN/device
+    size_t slash = node_path.find_last_of('/');
+    std::string node_name = (slash == std::string::npos) ? node_path : node_path.substr(slash + 1);
+    if (node_name.empty()) {
+        return std::nullopt;
+    }
+    std::string sysfs_dir = "/sys/class/input/" + node_name + "/device/";
+    
+    DeviceIdentity identity;
+    if (!read_sysfs_line(sysfs_dir + "id/vendor", identity.vendor) ||
+        !read_sysfs_line(sysfs_dir + "id/product", identity.product)) {
+        return std::nullopt;
+    }
+    read_sysfs_line(sysfs_dir + "name", identity.name);
+    read_sysfs_line(sysfs_dir + "phys", identity.phys);
+    
+    return identity;
+}
+
+} // namespace
+
+std::optional<DeviceIdentity> read_device_identity(const std::string& device_path) {
+    std::string node_path = resolve_node(device_path);
+    if (node_path.empty()) {
+        return std::nullopt;
+    }
+    return read_node_identity(node_path);
+}
+
+std::optional<DeviceIdentity> lookup_device_identity(const std::string& device_path) {
+    std::string node_path = resolve_node(device_path);
+    if (node_path.empty()) {
+        identity_cache.erase(device_path);
+        return std::nullopt;
+    }
+    
+    auto it = identity_cache.find(device_path);
+    if (it != identity_cache.end() && it->second.node_path == node_path) {
+        return it->second.identity;
+    }
+    
+    auto identity = read_node_identity(node_path);
+    if (!identity) {
+        identity_cache.erase(device_path);
+        return std::nullopt;
+    }
+    
+    identity_cache[device_path] = {node_path, *identity};
+    return identity;
+}
@@ -0,0 +1,27 @@
+#ifndef DEVICE_IDENTITY_HPP
+#define DEVICE_IDENTITY_HPP
+
+#include <string>
+#include <optional>
+
+// Identity of an evdev node as exposed by the kernel under
+// /sys/class/input/eventN/device. vendor/product are formatted like udev's
+// ID_VENDOR_ID/ID_MODEL_ID (4 lowercase hex digits) so they compare directly
+// against the values stored in config.json.
+struct DeviceIdentity {
+    std::string vendor;
+    std::string product;
+    std::string name;
+    std::string phys;
+};
+
+// Reads the identity of a /dev/input/eventN node (or a symlink to one) from sysfs
+std::optional<DeviceIdentity> read_device_identity(const std::string& device_path);
+
+// Same as read_device_identity, but cached per /dev/input/by-id path. A cached
+// entry is reused only while the link still resolves to the same event node,
+// so a replugged device that came back under a different eventN is re-read.
+// Don't pass bare eventN paths: those numbers get reused by other devices.
+std::optional<DeviceIdentity> lookup_device_identity(const std::string& device_path);
+
+#endif // DEVICE_IDENTITY_HPP
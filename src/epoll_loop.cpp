@@ -1,6 +1,5 @@
 #include "epoll_loop.hpp"
 #include "input_source.hpp"
-#include "bindings.hpp"
 #include <fcntl.h>
 #include <unistd.h>
 #include <cstring>
@@ -8,8 +7,9 @@
 #include <iostream>
 #include <libevdev-1.0/libevdev/libevdev.h>
 #include <algorithm>
+#include <sys/eventfd.h>
 
-EpollLoop::EpollLoop() : epoll_fd(-1) {
+EpollLoop::EpollLoop() : epoll_fd(-1), wake_fd(-1) {
 }
 
 EpollLoop::~EpollLoop() {
@@ -17,11 +17,21 @@ EpollLoop::~EpollLoop() {
 }
 
 bool EpollLoop::initialize() {
-    epoll_fd = epoll_create1(0);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
     if (epoll_fd < 0) {
         perror("Failed to create epoll");
         return false;
     }
+    
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0 || !add_fd(wake_fd, [this](uint32_t) {
+            uint64_t count;
+            while (read(wake_fd, &count, sizeof(count)) > 0) {}
+        })) {
+        perror("Failed to create loop wakeup eventfd");
+        cleanup();
+        return false;
+    }
     return true;
 }
 
@@ -30,7 +40,37 @@ void EpollLoop::cleanup() {
         close(epoll_fd);
         epoll_fd = -1;
     }
-    active_devices.clear();
+    if (wake_fd >= 0) {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+    registrations.clear();
+    retired.clear();
+}
+
+bool EpollLoop::add_registration(std::unique_ptr<Registration> registration) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLET;
+    event.data.ptr = registration.get();
+    
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, registration->fd, &event) < 0) {
+        perror("Failed to add fd to epoll");
+        return false;
+    }
+    
+    registrations.push_back(std::move(registration));
+    return true;
+}
+
+void EpollLoop::retire(std::vector<std::unique_ptr<Registration>>::iterator it) {
+    Registration& registration = **it;
+    if (registration.fd >= 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, registration.fd, nullptr);
+    }
+    registration.active = false;
+    retired.push_back(std::move(*it));
+    registrations.erase(it);
 }
 
 bool EpollLoop::add_device(InputSource* device) {
@@ -38,60 +78,67 @@ bool EpollLoop::add_device(InputSource* device) {
         return false;
     }
     
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.fd = device->fd;
+    if (has_device(device)) {
+        return true;
+    }
     
-    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, device->fd, &event) < 0) {
-        perror("Failed to add device to epoll");
+    auto registration = std::make_unique<Registration>();
+    registration->fd = device->fd;
+    registration->device = device;
+    if (!add_registration(std::move(registration))) {
         return false;
     }
     
-    // Remove if already present, then add to active devices
-    active_devices.erase(
-        std::remove(active_devices.begin(), active_devices.end(), device),
-        active_devices.end()
-    );
-    active_devices.push_back(device);
+    // With edge triggering, anything queued before registration would never
+    // raise an edge of its own, so drain it now.
+    handle_device_event(device);
     
     return true;
 }
 
 bool EpollLoop::remove_device(InputSource* device) {
-    if (!device || epoll_fd < 0 || device->fd < 0) {
+    if (!device || epoll_fd < 0) {
         return false;
     }
     
-    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, device->fd, nullptr);
-    
-    active_devices.erase(
-        std::remove(active_devices.begin(), active_devices.end(), device),
-        active_devices.end()
-    );
+    auto it = std::find_if(registrations.begin(), registrations.end(),
+                           [device](const auto& r) { return r->device == device; });
+    if (it == registrations.end()) {
+        return false;
+    }
     
+    retire(it);
     return true;
 }
 
-bool EpollLoop::rebuild_devices(const std::vector<InputSource*>& devices) {
-    if (epoll_fd < 0) {
+bool EpollLoop::has_device(const InputSource* device) const {
+    return std::any_of(registrations.begin(), registrations.end(),
+                       [device](const auto& r) { return r->device == device; });
+}
+
+bool EpollLoop::add_fd(int fd, FdCallback callback) {
+    if (fd < 0 || epoll_fd < 0 || !callback) {
         return false;
     }
     
-    // Clear all existing devices
-    for (auto* device : active_devices) {
-        if (device && device->fd >= 0) {
-            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, device->fd, nullptr);
-        }
+    auto registration = std::make_unique<Registration>();
+    registration->fd = fd;
+    registration->callback = std::move(callback);
+    return add_registration(std::move(registration));
+}
+
+bool EpollLoop::remove_fd(int fd) {
+    if (epoll_fd < 0) {
+        return false;
     }
-    active_devices.clear();
     
-    // Add all valid devices
-    for (auto* device : devices) {
-        if (device && device->fd >= 0) {
-            add_device(device);
-        }
+    auto it = std::find_if(registrations.begin(), registrations.end(),
+                           [fd](const auto& r) { return !r->device && r->fd == fd; });
+    if (it == registrations.end()) {
+        return false;
     }
     
+    retire(it);
     return true;
 }
 
@@ -100,8 +147,8 @@ int EpollLoop::run_once(int timeout_ms) {
         return -1;
     }
     
-    struct epoll_event events[8];
-    int nfds = epoll_wait(epoll_fd, events, 8, timeout_ms);
+    struct epoll_event events[MAX_EVENTS];
+    int nfds = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout_ms);
     
     if (nfds < 0) {
         if (errno == EINTR) return 0;
@@ -110,63 +157,180 @@ int EpollLoop::run_once(int timeout_ms) {
     }
     
     for (int i = 0; i < nfds; i++) {
-        InputSource* source_device = nullptr;
-        for (auto* device : active_devices) {
-            if (device && device->fd == events[i].data.fd) {
-                source_device = device;
-                break;
-            }
-        }
+        Registration* registration = static_cast<Registration*>(events[i].data.ptr);
         
-        if (!source_device) continue;
+        // Removed earlier in this batch but still had a queued wakeup
+        if (!registration->active) continue;
         
-        // Handle disconnect events
-        if (events[i].events & (EPOLLHUP | EPOLLERR)) {
-            handle_disconnect(source_device);
+        if (!registration->device) {
+            registration->callback(events[i].events);
             continue;
         }
         
-        // Handle input events
+        InputSource* source_device = registration->device;
+        
+        // Drain first so events queued ahead of a hangup are still delivered
         if (events[i].events & EPOLLIN) {
             handle_device_event(source_device);
         }
+        
+        if ((events[i].events & (EPOLLHUP | EPOLLERR)) && registration->active) {
+            handle_disconnect(source_device, ENODEV);
+        }
+    }
+    
+    if (nfds > 0 && batch_callback) {
+        batch_callback();
+    }
+    
+    retired.clear();
+    
+    if (nfds > 0) {
+        run_posted_tasks();
     }
     
     return nfds;
 }
 
 void EpollLoop::handle_device_event(InputSource* device) {
-    if (!device || !device->dev || !event_callback) {
+    if (!device || !device->dev) {
         return;
     }
     
+    if (raw_read) {
+        read_raw_events(device);
+    } else {
+        read_libevdev_events(device, LIBEVDEV_READ_FLAG_NORMAL);
+    }
+}
+
+void EpollLoop::read_libevdev_events(InputSource* device, unsigned int flags) {
+    // Edge-triggered: keep reading until the kernel queue is empty
     while (true) {
         struct input_event ev;
-        int rc = libevdev_next_event(device->dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
+        int rc = libevdev_next_event(device->dev, flags, &ev);
         
         if (rc == -EAGAIN) {
+            if (flags & LIBEVDEV_READ_FLAG_SYNC) {
+                // Resync finished; carry on with the normal stream
+                flags = LIBEVDEV_READ_FLAG_NORMAL;
+                continue;
+            }
             break; // No more events
         }
         
-        if (rc == -ENODEV) {
-            handle_disconnect(device);
+        if (rc == -EINTR) {
+            continue;
+        }
+        
+        if (rc == -ENODEV || rc == -EIO) {
+            handle_disconnect(device, -rc);
             break;
         }
         
-        if (rc != 0) {
-            break; // Other error
+        if (rc < 0) {
+            if (++device->consecutive_read_failures >= MAX_READ_FAILURES) {
+                handle_disconnect(device, -rc);
+                break;
+            }
+            continue;
         }
         
-        // Call the event callback
-        event_callback(device, ev);
+        device->consecutive_read_failures = 0;
+        
+        if (rc == LIBEVDEV_READ_STATUS_SYNC) {
+            // Kernel buffer overflowed (SYN_DROPPED): the events that follow
+            // describe the device's current state until the queue drains.
+            // This is recovery, not a read failure, so the device stays open.
+            flags = LIBEVDEV_READ_FLAG_SYNC;
+        }
+        
+        if (event_callback) {
+            event_callback(device, ev);
+        }
     }
 }
 
-void EpollLoop::handle_disconnect(InputSource* device) {
-    std::cout << "Disconnect " << device->role << ": " << device->resolved_path << "\n";
+void EpollLoop::read_raw_events(InputSource* device) {
+    struct input_event events[RAW_READ_EVENTS];
+    
+    // Edge-triggered: keep reading until the kernel queue is empty
+    while (true) {
+        ssize_t bytes = read(device->fd, events, sizeof(events));
+        
+        if (bytes < 0) {
+            if (errno == EAGAIN) break;
+            if (errno == EINTR) continue;
+            int error = errno;
+            if (error == ENODEV || error == EIO || ++device->consecutive_read_failures >= MAX_READ_FAILURES) {
+                handle_disconnect(device, error);
+                break;
+            }
+            continue;
+        }
+        if (bytes == 0) {
+            handle_disconnect(device, ENODEV);
+            break;
+        }
+        
+        device->consecutive_read_failures = 0;
+        
+        size_t count = static_cast<size_t>(bytes) / sizeof(struct input_event);
+        for (size_t i = 0; i < count; i++) {
+            const struct input_event& ev = events[i];
+            
+            if (ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+                // The rest of this buffer predates the state libevdev is about to
+                // query from the kernel, so drop it and let libevdev resync and
+                // drain whatever is still queued
+                read_libevdev_events(device, LIBEVDEV_READ_FLAG_FORCE_SYNC);
+                return;
+            }
+            
+            // libevdev doesn't see these events, but its SYN_DROPPED resync diffs
+            // against its own state and the resolver seeds reloads from it
+            if (ev.type == EV_KEY || ev.type == EV_ABS) {
+                libevdev_set_event_value(device->dev, ev.type, ev.code, ev.value);
+            }
+            
+            if (event_callback) {
+                event_callback(device, ev);
+            }
+        }
+    }
+}
+
+void EpollLoop::handle_disconnect(InputSource* device, int error) {
+    remove_device(device);
     device->close_and_free();
     
     if (disconnect_callback) {
-        disconnect_callback(device);
+        disconnect_callback(device, error);
+    } else {
+        std::cout << "Disconnect " << device->role << " (" << strerror(error) << ")\n";
+    }
+}
+
+void EpollLoop::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex);
+        posted_tasks.push_back(std::move(task));
+    }
+    uint64_t one = 1;
+    if (wake_fd >= 0 && write(wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        perror("Failed to wake event loop");
     }
-}
\ No newline at end of file
+}
+
+void EpollLoop::run_posted_tasks() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex);
+        tasks.swap(posted_tasks);
+    }
+    for (auto& task : tasks) {
+        task();
+    }
+    // Tasks may remove devices too
+    retired.clear();
+}
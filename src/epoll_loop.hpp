@@ -2,15 +2,26 @@
 #define EPOLL_LOOP_HPP
 
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include <functional>
+#include <mutex>
 #include <sys/epoll.h>
 
 #include "input_source.hpp"
 
+// Single event engine for every mapper mode. Devices are registered
+// edge-triggered with a pointer back to their InputSource, drained until
+// EAGAIN on each wakeup, and removed with EPOLL_CTL_DEL on disconnect.
 class EpollLoop {
 public:
     using EventCallback = std::function<void(InputSource*, const struct input_event&)>;
-    using DisconnectCallback = std::function<void(InputSource*)>;
+    using DisconnectCallback = std::function<void(InputSource*, int error)>;
+    using BatchCallback = std::function<void()>;
+    using FdCallback = std::function<void(uint32_t events)>;
+    
+    // Consecutive failed reads before a device is treated as gone
+    static constexpr int MAX_READ_FAILURES = 3;
     
     EpollLoop();
     ~EpollLoop();
@@ -20,23 +31,63 @@ public:
     
     bool add_device(InputSource* device);
     bool remove_device(InputSource* device);
-    bool rebuild_devices(const std::vector<InputSource*>& devices);
+    bool has_device(const InputSource* device) const;
+    
+    // Auxiliary fds (inotify, timers, ...) share the same wait. They are
+    // edge-triggered too, so the callback must read the fd until EAGAIN.
+    bool add_fd(int fd, FdCallback callback);
+    bool remove_fd(int fd);
     
+    // Waits once, drains every ready device, then runs the batch callback
+    // followed by any posted tasks
     int run_once(int timeout_ms = 250);
     
+    // Thread-safe: runs task on the loop's thread after the current batch,
+    // waking a blocked run_once. This is how other threads change loop state.
+    void post(std::function<void()> task);
+    
     void set_event_callback(EventCallback callback) { event_callback = callback; }
     void set_disconnect_callback(DisconnectCallback callback) { disconnect_callback = callback; }
+    // Called after all devices woken by one epoll_wait have been drained
+    void set_batch_callback(BatchCallback callback) { batch_callback = callback; }
+    
+    // Read input_event arrays with read(2) instead of one libevdev_next_event at a
+    // time. libevdev's state is kept current and it still handles SYN_DROPPED.
+    void set_raw_read(bool enabled) { raw_read = enabled; }
     
     bool is_running() const { return epoll_fd >= 0; }
 
 private:
+    static constexpr int MAX_EVENTS = 16;
+    static constexpr size_t RAW_READ_EVENTS = 64;  // input_events per read(2) in raw mode
+    
+    // epoll_event.data.ptr points at one of these: either an input device or an auxiliary fd
+    struct Registration {
+        int fd = -1;
+        InputSource* device = nullptr;
+        FdCallback callback;
+        bool active = true;
+    };
+    
     int epoll_fd;
-    std::vector<InputSource*> active_devices;
+    int wake_fd;  // eventfd signalled by post()
+    std::mutex posted_mutex;
+    std::vector<std::function<void()>> posted_tasks;
+    std::vector<std::unique_ptr<Registration>> registrations;
+    // Removed during a batch; kept alive until the batch ends so queued wakeups stay valid
+    std::vector<std::unique_ptr<Registration>> retired;
     EventCallback event_callback;
     DisconnectCallback disconnect_callback;
+    BatchCallback batch_callback;
+    bool raw_read = false;
     
+    bool add_registration(std::unique_ptr<Registration> registration);
+    void retire(std::vector<std::unique_ptr<Registration>>::iterator it);
     void handle_device_event(InputSource* device);
-    void handle_disconnect(InputSource* device);
+    void read_libevdev_events(InputSource* device, unsigned int flags);
+    void read_raw_events(InputSource* device);
+    void handle_disconnect(InputSource* device, int error);
+    void run_posted_tasks();
 };
 
-#endif // EPOLL_LOOP_HPP
\ No newline at end of file
+#endif // EPOLL_LOOP_HPP
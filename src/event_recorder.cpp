@@ -0,0 +1,193 @@
+#include "event_recorder.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+constexpr char RECORDING_MAGIC[8] = {'T', 'W', 'C', 'S', 'R', 'E', 'C', '\0'};
+constexpr uint32_t RECORDING_VERSION = 1;
+
+bool write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+EventRecorder::EventRecorder() : fd(-1), last_time_us(0), batch_has_events(false) {}
+
+EventRecorder::~EventRecorder() {
+    close();
+}
+
+bool EventRecorder::open(const std::string& path, const std::vector<std::string>& source_labels) {
+    close();
+    
+    if (source_labels.size() >= RECORD_BATCH_END) {
+        std::cerr << "Too many input sources to record\n";
+        return false;
+    }
+    
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror(("Failed to open recording file: " + path).c_str());
+        return false;
+    }
+    
+    RecordingHeader header{};
+    memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+    header.version = RECORDING_VERSION;
+    header.source_count = static_cast<uint32_t>(source_labels.size());
+    
+    std::vector<char> labels(source_labels.size() * RECORDING_LABEL_SIZE, '\0');
+    for (size_t i = 0; i < source_labels.size(); i++) {
+        strncpy(&labels[i * RECORDING_LABEL_SIZE], source_labels[i].c_str(), RECORDING_LABEL_SIZE - 1);
+    }
+    
+    if (!write_all(fd, &header, sizeof(header)) || !write_all(fd, labels.data(), labels.size())) {
+        perror(("Failed to write recording header: " + path).c_str());
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    
+    buffer.reserve(BUFFER_EVENTS);
+    last_time_us = 0;
+    batch_has_events = false;
+    return true;
+}
+
+void EventRecorder::close() {
+    if (fd < 0) {
+        return;
+    }
+    flush();
+    ::close(fd);
+    fd = -1;
+}
+
+void EventRecorder::record(uint8_t source, const struct input_event& ev) {
+    RecordedEvent event{};
+    event.time_us = static_cast<uint64_t>(ev.input_event_sec) * 1000000 + static_cast<uint64_t>(ev.input_event_usec);
+    event.value = ev.value;
+    event.code = ev.code;
+    event.type = static_cast<uint8_t>(ev.type);
+    event.source = source;
+    last_time_us = event.time_us;
+    batch_has_events = true;
+    append(event);
+}
+
+void EventRecorder::mark_batch_end() {
+    // Batches with nothing recorded carry no information
+    if (!batch_has_events) {
+        return;
+    }
+    batch_has_events = false;
+    RecordedEvent event{};
+    event.time_us = last_time_us;
+    event.type = RECORD_BATCH_END;
+    append(event);
+}
+
+void EventRecorder::append(const RecordedEvent& event) {
+    if (fd < 0) {
+        return;
+    }
+    buffer.push_back(event);
+    if (buffer.size() >= BUFFER_EVENTS) {
+        flush();
+    }
+}
+
+bool EventRecorder::flush() {
+    if (buffer.empty()) {
+        return true;
+    }
+    bool ok = write_all(fd, buffer.data(), buffer.size() * sizeof(RecordedEvent));
+    if (!ok) {
+        perror("Failed to write recording");
+    }
+    buffer.clear();
+    return ok;
+}
+
+EventReplay::EventReplay() : mapping(MAP_FAILED), mapping_size(0), first_event(nullptr), count(0) {}
+
+EventReplay::~EventReplay() {
+    close();
+}
+
+bool EventReplay::open(const std::string& path) {
+    close();
+    
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(("Failed to open recording: " + path).c_str());
+        return false;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(RecordingHeader)) {
+        std::cerr << "Not a recording file: " << path << "\n";
+        ::close(fd);
+        return false;
+    }
+    
+    mapping_size = static_cast<size_t>(st.st_size);
+    mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        perror(("Failed to map recording: " + path).c_str());
+        return false;
+    }
+    
+    const auto* header = static_cast<const RecordingHeader*>(mapping);
+    size_t events_offset = sizeof(RecordingHeader) + static_cast<size_t>(header->source_count) * RECORDING_LABEL_SIZE;
+    if (memcmp(header->magic, RECORDING_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != RECORDING_VERSION || header->source_count >= RECORD_BATCH_END ||
+        events_offset > mapping_size) {
+        std::cerr << "Unsupported recording format: " << path << "\n";
+        close();
+        return false;
+    }
+    
+    const char* labels = static_cast<const char*>(mapping) + sizeof(RecordingHeader);
+    for (uint32_t i = 0; i < header->source_count; i++) {
+        const char* label = labels + i * RECORDING_LABEL_SIZE;
+        source_labels.emplace_back(label, strnlen(label, RECORDING_LABEL_SIZE));
+    }
+    
+    // A capture cut short by a crash just ends at the last complete event
+    first_event = reinterpret_cast<const RecordedEvent*>(static_cast<const char*>(mapping) + events_offset);
+    count = (mapping_size - events_offset) / sizeof(RecordedEvent);
+    
+    madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+    return true;
+}
+
+void EventReplay::close() {
+    if (mapping != MAP_FAILED) {
+        munmap(mapping, mapping_size);
+    }
+    mapping = MAP_FAILED;
+    mapping_size = 0;
+    first_event = nullptr;
+    count = 0;
+    source_labels.clear();
+}
@@ -0,0 +1,80 @@
+#ifndef EVENT_RECORDER_HPP
+#define EVENT_RECORDER_HPP
+
+#include <linux/input.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Capture file layout (native endian, memory-mappable):
+//   RecordingHeader, then source_count fixed-size source labels, then a flat
+//   array of RecordedEvent until end of file. A source label is the device's
+//   roles joined with '+', e.g. "stick" or "throttle+rudder".
+struct RecordingHeader {
+    char magic[8];          // "TWCSREC" + NUL
+    uint32_t version;
+    uint32_t source_count;
+};
+
+constexpr size_t RECORDING_LABEL_SIZE = 32;
+
+struct RecordedEvent {
+    uint64_t time_us;   // Kernel timestamp (CLOCK_MONOTONIC)
+    int32_t value;
+    uint16_t code;
+    uint8_t type;       // EV_* or RECORD_BATCH_END
+    uint8_t source;     // Index into the source labels
+};
+static_assert(sizeof(RecordedEvent) == 16, "RecordedEvent must stay packed");
+
+// Marks where one epoll batch ended, so replay merges frames exactly like the live loop
+constexpr uint8_t RECORD_BATCH_END = 0xff;
+
+class EventRecorder {
+public:
+    EventRecorder();
+    ~EventRecorder();
+    
+    bool open(const std::string& path, const std::vector<std::string>& source_labels);
+    void close();
+    bool is_open() const { return fd >= 0; }
+    
+    // Buffered; the file is written in large chunks and on close()
+    void record(uint8_t source, const struct input_event& ev);
+    void mark_batch_end();
+
+private:
+    int fd;
+    std::vector<RecordedEvent> buffer;
+    uint64_t last_time_us;
+    bool batch_has_events;
+    
+    static constexpr size_t BUFFER_EVENTS = 4096;
+    
+    void append(const RecordedEvent& event);
+    bool flush();
+};
+
+// Read-only mmap of a capture file
+class EventReplay {
+public:
+    EventReplay();
+    ~EventReplay();
+    
+    bool open(const std::string& path);
+    void close();
+    
+    const std::vector<std::string>& sources() const { return source_labels; }
+    const RecordedEvent* events() const { return first_event; }
+    size_t event_count() const { return count; }
+
+private:
+    void* mapping;
+    size_t mapping_size;
+    const RecordedEvent* first_event;
+    size_t count;
+    std::vector<std::string> source_labels;
+};
+
+#endif // EVENT_RECORDER_HPP
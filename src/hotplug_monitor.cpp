@@ -0,0 +1,110 @@
+#include "hotplug_monitor.hpp"
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+static const char* INPUT_DIR = "/dev/input";
+static const char* BY_ID_DIR = "/dev/input/by-id";
+
+HotplugMonitor::HotplugMonitor() : inotify_fd(-1), input_dir_wd(-1), by_id_dir_wd(-1) {
+}
+
+HotplugMonitor::~HotplugMonitor() {
+    cleanup();
+}
+
+bool HotplugMonitor::initialize() {
+    if (inotify_fd >= 0) {
+        return true;
+    }
+    
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0) {
+        perror("Failed to create inotify instance");
+        return false;
+    }
+    
+    // IN_ATTRIB catches udev applying permissions to a node created moments earlier
+    input_dir_wd = inotify_add_watch(inotify_fd, INPUT_DIR, IN_CREATE | IN_ATTRIB | IN_MOVED_TO);
+    if (input_dir_wd < 0) {
+        perror("Failed to watch /dev/input");
+        cleanup();
+        return false;
+    }
+    
+    // by-id does not exist until the first persistent-name device shows up
+    watch_by_id_dir();
+    return true;
+}
+
+void HotplugMonitor::cleanup() {
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+        inotify_fd = -1;
+    }
+    input_dir_wd = -1;
+    by_id_dir_wd = -1;
+}
+
+void HotplugMonitor::watch_by_id_dir() {
+    if (by_id_dir_wd >= 0) {
+        return;
+    }
+    by_id_dir_wd = inotify_add_watch(inotify_fd, BY_ID_DIR, IN_CREATE | IN_MOVED_TO);
+}
+
+bool HotplugMonitor::drain() {
+    if (inotify_fd < 0) {
+        return false;
+    }
+    
+    bool changed = false;
+    alignas(struct inotify_event) char buffer[4096];
+    
+    while (true) {
+        ssize_t len = read(inotify_fd, buffer, sizeof(buffer));
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            break; // EAGAIN: queue empty
+        }
+        if (len == 0) {
+            break;
+        }
+        
+        for (char* ptr = buffer; ptr < buffer + len;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+            
+            if (event->mask & IN_Q_OVERFLOW) {
+                changed = true;
+                continue;
+            }
+            
+            if (event->mask & IN_IGNORED) {
+                // Watched directory went away (e.g. by-id removed with the last device)
+                if (event->wd == by_id_dir_wd) by_id_dir_wd = -1;
+                continue;
+            }
+            
+            const char* name = event->len > 0 ? event->name : "";
+            
+            if (event->wd == input_dir_wd) {
+                if ((event->mask & IN_ISDIR) && strcmp(name, "by-id") == 0) {
+                    watch_by_id_dir();
+                    changed = true;
+                } else if (strncmp(name, "event", 5) == 0) {
+                    changed = true;
+                }
+            } else if (event->wd == by_id_dir_wd) {
+                changed = true;
+            }
+        }
+    }
+    
+    // by-id may have been created before the watch above could be added
+    watch_by_id_dir();
+    
+    return changed;
+}
@@ -0,0 +1,30 @@
+#ifndef HOTPLUG_MONITOR_HPP
+#define HOTPLUG_MONITOR_HPP
+
+#include <string>
+
+// Watches /dev/input and /dev/input/by-id for new device nodes and symlinks.
+// The by-id symlinks only appear once udev has finished with a device, so a
+// change there means a configured path may now resolve and open.
+class HotplugMonitor {
+public:
+    HotplugMonitor();
+    ~HotplugMonitor();
+    
+    bool initialize();
+    void cleanup();
+    
+    int get_fd() const { return inotify_fd; }
+    
+    // Reads all queued notifications; true if any input device may have appeared
+    bool drain();
+
+private:
+    int inotify_fd;
+    int input_dir_wd;
+    int by_id_dir_wd;
+    
+    void watch_by_id_dir();
+};
+
+#endif // HOTPLUG_MONITOR_HPP
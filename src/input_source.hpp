@@ -8,6 +8,7 @@
 #include <unistd.h>
 #include <limits.h>
 #include <sys/ioctl.h>
+#include <time.h>
 
 struct InputSource {
     std::string role;
@@ -16,8 +17,9 @@ struct InputSource {
     int fd;
     struct libevdev* dev;
     bool grabbed;
+    int consecutive_read_failures;  // Maintained by EpollLoop while draining
     
-    InputSource() : fd(-1), dev(nullptr), grabbed(false) {}
+    InputSource() : fd(-1), dev(nullptr), grabbed(false), consecutive_read_failures(0) {}
     
     int open_and_init(bool grab_enabled) {
         // Call close_and_free() first
@@ -41,8 +43,14 @@ struct InputSource {
         if (rc < 0) {
             close(fd);
             fd = -1;
+            dev = nullptr;
             return -1;
         }
+        consecutive_read_failures = 0;
+        
+        // Timestamp events on the monotonic clock so latency can be measured
+        // against clock_gettime(CLOCK_MONOTONIC) without wall-clock jumps
+        libevdev_set_clock_id(dev, CLOCK_MONOTONIC);
         
         // Grab if enabled
         if (grab_enabled) {
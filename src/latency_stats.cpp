@@ -0,0 +1,137 @@
+#include "latency_stats.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <unistd.h>
+
+size_t LatencyHistogram::bucket_for(uint64_t latency_us) {
+    if (latency_us < LINEAR_BUCKETS) {
+        return static_cast<size_t>(latency_us);
+    }
+    
+    int exponent = 63 - std::countl_zero(latency_us);  // >= 4
+    if (exponent >= 32) {
+        return BUCKET_COUNT - 1;
+    }
+    size_t sub = static_cast<size_t>(latency_us >> (exponent - 3)) & (SUB_BUCKETS - 1);
+    return LINEAR_BUCKETS + static_cast<size_t>(exponent - 4) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t bucket) {
+    if (bucket < LINEAR_BUCKETS) {
+        return bucket;
+    }
+    
+    int exponent = 4 + static_cast<int>((bucket - LINEAR_BUCKETS) / SUB_BUCKETS);
+    uint64_t sub = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+    uint64_t width = uint64_t{1} << (exponent - 3);
+    return (SUB_BUCKETS + sub) * width + width - 1;
+}
+
+void LatencyHistogram::record(uint64_t latency_us) {
+    // Single writer: plain load/store instead of locked read-modify-write
+    auto& bucket = buckets[bucket_for(latency_us)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (latency_us > max_us.load(std::memory_order_relaxed)) {
+        max_us.store(latency_us, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double quantile) const {
+    uint64_t samples = count();
+    if (samples == 0) {
+        return 0;
+    }
+    
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(samples - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucket_upper_bound(i), max());
+        }
+    }
+    return max();
+}
+
+LatencyStats::LatencyStats()
+    : start_time(std::chrono::steady_clock::now()), last_report_time(start_time) {}
+
+size_t LatencyStats::add_source(const std::string& label) {
+    auto source = std::make_unique<Source>();
+    source->label = label;
+    sources.push_back(std::move(source));
+    return sources.size() - 1;
+}
+
+std::string LatencyStats::format_report() {
+    auto now = std::chrono::steady_clock::now();
+    double interval = std::chrono::duration<double>(now - last_report_time).count();
+    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - start_time).count();
+    last_report_time = now;
+    
+    std::ostringstream report;
+    report << "=== Latency Stats (uptime " << uptime << "s) ===\n";
+    for (auto& source : sources) {
+        uint64_t events = source->events.load(std::memory_order_relaxed);
+        double rate = interval > 0 ? (events - source->reported_events) / interval : 0.0;
+        source->reported_events = events;
+        
+        const LatencyHistogram& latency = source->latency;
+        report << "  " << source->label << ": events=" << events
+               << " rate=" << std::fixed << std::setprecision(1) << rate << "/s"
+               << " frames=" << latency.count()
+               << " resyncs=" << source->resyncs.load(std::memory_order_relaxed);
+        if (latency.count() > 0) {
+            report << " p50=" << latency.percentile(0.50) << "us"
+                   << " p99=" << latency.percentile(0.99) << "us"
+                   << " max=" << latency.max() << "us";
+        }
+        report << "\n";
+    }
+    return report.str();
+}
+
+bool LatencyStats::write_report_file(const std::string& path, const std::string& report) const {
+    // Write to a temp file and rename so readers never see a partial report
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << report;
+        if (!file.good()) {
+            return false;
+        }
+    }
+    if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string LatencyStats::get_stats_path() {
+    const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir && runtime_dir[0] != '\0') {
+        return std::string(runtime_dir) + "/twcs-mapper-stats.txt";
+    }
+    return "/tmp/twcs-mapper-stats-" + std::to_string(getuid()) + ".txt";
+}
+
+uint64_t LatencyStats::now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000 + static_cast<uint64_t>(ts.tv_nsec) / 1000;
+}
+
+uint64_t LatencyStats::event_time_us(const struct input_event& ev) {
+    return static_cast<uint64_t>(ev.input_event_sec) * 1000000 + static_cast<uint64_t>(ev.input_event_usec);
+}
@@ -0,0 +1,88 @@
+#ifndef LATENCY_STATS_HPP
+#define LATENCY_STATS_HPP
+
+#include <linux/input.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Log-linear latency histogram in microseconds: exact below 16us, then 8
+// sub-buckets per power of two (<= 12.5% error). Written by one thread with
+// relaxed atomics, so other threads can read it without locks.
+class LatencyHistogram {
+public:
+    static constexpr size_t LINEAR_BUCKETS = 16;
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t BUCKET_COUNT = LINEAR_BUCKETS + (32 - 4) * SUB_BUCKETS;
+    
+    void record(uint64_t latency_us);
+    
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_us.load(std::memory_order_relaxed); }
+    // Upper bound of the bucket holding the given quantile (0..1), capped at max()
+    uint64_t percentile(double quantile) const;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> max_us{0};
+    
+    static size_t bucket_for(uint64_t latency_us);
+    static uint64_t bucket_upper_bound(size_t bucket);
+};
+
+// Per-device event counters and input-to-uinput latency. A frame's latency runs
+// from the kernel timestamp of its events (CLOCK_MONOTONIC, see InputSource) to
+// the write() that emitted the resulting virtual frame.
+class LatencyStats {
+public:
+    LatencyStats();
+    
+    // Sources are registered once at startup; the returned index is stable
+    size_t add_source(const std::string& label);
+    
+    void count_event(size_t source) {
+        auto& events = sources[source]->events;
+        events.store(events.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    void record_frame(size_t source, uint64_t latency_us) { sources[source]->latency.record(latency_us); }
+    // Kernel buffer overflows (SYN_DROPPED), each recovered with one state resync
+    void count_resync(size_t source) {
+        auto& resyncs = sources[source]->resyncs;
+        resyncs.store(resyncs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    uint64_t events(size_t source) const { return sources[source]->events.load(std::memory_order_relaxed); }
+    uint64_t frames(size_t source) const { return sources[source]->latency.count(); }
+    uint64_t resyncs(size_t source) const { return sources[source]->resyncs.load(std::memory_order_relaxed); }
+    
+    // Text report; events/sec is measured since the previous report
+    std::string format_report();
+    bool write_report_file(const std::string& path, const std::string& report) const;
+    
+    // $XDG_RUNTIME_DIR/twcs-mapper-stats.txt (falls back to /tmp)
+    static std::string get_stats_path();
+    
+    static uint64_t now_us();
+    static uint64_t event_time_us(const struct input_event& ev);
+
+private:
+    struct Source {
+        std::string label;
+        std::atomic<uint64_t> events{0};
+        std::atomic<uint64_t> resyncs{0};
+        LatencyHistogram latency;
+        uint64_t reported_events = 0;  // Report thread only
+    };
+    
+    std::vector<std::unique_ptr<Source>> sources;
+    std::chrono::steady_clock::time_point start_time;
+    std::chrono::steady_clock::time_point last_report_time;
+};
+
+#endif // LATENCY_STATS_HPP
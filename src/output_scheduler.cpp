@@ -0,0 +1,157 @@
+#include "output_scheduler.hpp"
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+OutputScheduler::OutputScheduler(VirtualDevice& device) : device(device) {
+}
+
+OutputScheduler::~OutputScheduler() {
+    cleanup();
+}
+
+bool OutputScheduler::initialize(float hysteresis_percent, int max_rate_hz) {
+    for (int i = 0; i < VIRTUAL_AXIS_COUNT; i++) {
+        uint16_t code = VIRTUAL_AXIS_CODES[i];
+        if (code == ABS_HAT0X || code == ABS_HAT0Y) {
+            // D-pad hats are edges like buttons: never filtered
+            range_min[i] = -1;
+            range_max[i] = 1;
+            thresholds[i] = 0;
+            continue;
+        }
+        bool trigger = (code == ABS_Z || code == ABS_RZ);
+        range_min[i] = trigger ? 0 : -32768;
+        range_max[i] = trigger ? 255 : 32767;
+        
+        // A band under one output count filters nothing
+        double band = (static_cast<double>(range_max[i]) - range_min[i]) * hysteresis_percent / 100.0;
+        thresholds[i] = band >= 1.0 ? static_cast<int32_t>(std::lround(band)) : 0;
+    }
+    
+    min_interval_us = max_rate_hz > 0 ? 1000000 / static_cast<uint64_t>(max_rate_hz) : 0;
+    if (min_interval_us == 0) {
+        return true;
+    }
+    
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0) {
+        perror("Failed to create output rate timer");
+        min_interval_us = 0;
+        return false;
+    }
+    return true;
+}
+
+void OutputScheduler::cleanup() {
+    if (timer_fd >= 0) {
+        close(timer_fd);
+        timer_fd = -1;
+    }
+    timer_armed = false;
+}
+
+bool OutputScheduler::passes_hysteresis(int axis, int32_t value) const {
+    if (thresholds[axis] == 0 || !(has_reference & (1u << axis))) {
+        return true;
+    }
+    
+    // Range ends and the stick center always get through, so the game can still
+    // see full deflection and an exact return to rest
+    if (value == range_min[axis] || value == range_max[axis] || (range_min[axis] < 0 && value == 0)) {
+        return true;
+    }
+    return std::abs(value - reference[axis]) >= thresholds[axis];
+}
+
+void OutputScheduler::submit(std::span<const PendingEvent> events) {
+    for (const auto& [slot, value] : events) {
+        if (slot.kind == SrcKind::Key) {
+            device.queue_event(EV_KEY, slot.code, value);
+            edge_queued = true;
+            continue;
+        }
+        
+        int axis = virtual_axis_index(slot.code);
+        if (axis < 0) continue;
+        
+        if (!passes_hysteresis(axis, value)) {
+            continue;
+        }
+        reference[axis] = value;
+        has_reference |= static_cast<uint8_t>(1u << axis);
+        
+        if (slot.code == ABS_HAT0X || slot.code == ABS_HAT0Y) {
+            device.queue_event(EV_ABS, slot.code, value);
+            edge_queued = true;
+        } else if (min_interval_us == 0) {
+            device.queue_event(EV_ABS, slot.code, value);
+        } else {
+            // Latest-value coalescing until the frame is due
+            staged[axis] = value;
+            staged_axes |= static_cast<uint8_t>(1u << axis);
+        }
+    }
+}
+
+bool OutputScheduler::emit(uint64_t now_us) {
+    for (int i = 0; i < VIRTUAL_AXIS_COUNT; i++) {
+        if (staged_axes & (1u << i)) {
+            device.queue_event(EV_ABS, VIRTUAL_AXIS_CODES[i], staged[i]);
+        }
+    }
+    staged_axes = 0;
+    edge_queued = false;
+    
+    if (device.queued_events() == 0) {
+        return false;
+    }
+    device.flush_frame();
+    last_frame_us = now_us;
+    return true;
+}
+
+bool OutputScheduler::flush(uint64_t now_us) {
+    if (staged_axes == 0 || edge_queued || now_us - last_frame_us >= min_interval_us) {
+        if (timer_armed) disarm_timer();
+        return emit(now_us);
+    }
+    
+    // Axis-only frame inside the rate interval: hold it until the timer fires
+    if (!timer_armed) {
+        arm_timer(last_frame_us + min_interval_us);
+    }
+    return false;
+}
+
+bool OutputScheduler::on_timer(uint64_t now_us) {
+    uint64_t expirations;
+    while (read(timer_fd, &expirations, sizeof(expirations)) > 0) {}
+    timer_armed = false;
+    return emit(now_us);
+}
+
+void OutputScheduler::arm_timer(uint64_t due_us) {
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = static_cast<time_t>(due_us / 1000000);
+    spec.it_value.tv_nsec = static_cast<long>((due_us % 1000000) * 1000);
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+        // Can't wait; emit late rather than never
+        perror("Failed to arm output rate timer");
+        emit(due_us);
+        return;
+    }
+    timer_armed = true;
+}
+
+void OutputScheduler::disarm_timer() {
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    timerfd_settime(timer_fd, 0, &spec, nullptr);
+    timer_armed = false;
+}
@@ -0,0 +1,63 @@
+#ifndef OUTPUT_SCHEDULER_HPP
+#define OUTPUT_SCHEDULER_HPP
+
+#include "bindings.hpp"
+#include "virtual_device.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+
+// Sits between the resolver and VirtualDevice and decides when analog axis
+// changes reach the game. Axis changes smaller than the hysteresis band are
+// dropped, and with a max rate set, axis-only frames are coalesced to the
+// latest values and emitted at most once per interval (via a timerfd). Button
+// and hat changes are never delayed: they flush everything staged with them.
+// With both knobs at 0 it is a pass-through.
+class OutputScheduler {
+public:
+    explicit OutputScheduler(VirtualDevice& device);
+    ~OutputScheduler();
+    
+    // hysteresis_percent of each axis's output range; max_rate_hz 0 = unlimited
+    bool initialize(float hysteresis_percent, int max_rate_hz);
+    void cleanup();
+    
+    // Expires when rate-limited axis values are due; register with EpollLoop::add_fd
+    // and call on_timer(). -1 when no rate limit is configured.
+    int get_timer_fd() const { return timer_fd; }
+    
+    // One resolver drain
+    void submit(std::span<const PendingEvent> events);
+    
+    // End of an input batch: writes a frame if anything is due, otherwise arms the
+    // timer for staged axes. Returns true if a frame was written.
+    bool flush(uint64_t now_us);
+    bool on_timer(uint64_t now_us);
+    
+    // Axis values staged but not yet written
+    bool has_pending() const { return staged_axes != 0; }
+
+private:
+    VirtualDevice& device;
+    int timer_fd = -1;
+    bool timer_armed = false;
+    uint64_t min_interval_us = 0;
+    uint64_t last_frame_us = 0;
+    bool edge_queued = false;  // A button or hat change is queued in VirtualDevice
+    
+    // Per virtual axis (VIRTUAL_AXIS_CODES order)
+    std::array<int32_t, VIRTUAL_AXIS_COUNT> thresholds{};
+    std::array<int32_t, VIRTUAL_AXIS_COUNT> range_min{};
+    std::array<int32_t, VIRTUAL_AXIS_COUNT> range_max{};
+    std::array<int32_t, VIRTUAL_AXIS_COUNT> reference{};  // Last value let through the band
+    std::array<int32_t, VIRTUAL_AXIS_COUNT> staged{};
+    uint8_t has_reference = 0;
+    uint8_t staged_axes = 0;
+    
+    bool passes_hysteresis(int axis, int32_t value) const;
+    bool emit(uint64_t now_us);
+    void arm_timer(uint64_t due_us);
+    void disarm_timer();
+};
+
+#endif // OUTPUT_SCHEDULER_HPP
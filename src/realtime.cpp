@@ -0,0 +1,59 @@
+#include "realtime.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+bool make_current_thread_realtime(int priority, int cpu) {
+    bool ok = true;
+    
+    int min_priority = sched_get_priority_min(SCHED_FIFO);
+    int max_priority = sched_get_priority_max(SCHED_FIFO);
+    if (priority < min_priority || priority > max_priority) {
+        std::cerr << "WARNING: realtime_priority " << priority << " out of range ("
+                  << min_priority << "-" << max_priority << "), using " << max_priority / 2 << "\n";
+        priority = max_priority / 2;
+    }
+    
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0) {
+        std::cerr << "WARNING: Failed to set SCHED_FIFO priority " << priority << ": " << strerror(rc)
+                  << " (needs CAP_SYS_NICE or LimitRTPRIO)\n";
+        ok = false;
+    }
+    
+    // CPU_SET doesn't bounds-check; an id past the configured CPUs can't be pinned anyway
+    long cpu_count = sysconf(_SC_NPROCESSORS_CONF);
+    if (cpu >= CPU_SETSIZE || (cpu_count > 0 && cpu >= cpu_count)) {
+        std::cerr << "WARNING: realtime_cpu " << cpu << " out of range (0-"
+                  << std::min<long>(CPU_SETSIZE, cpu_count > 0 ? cpu_count : CPU_SETSIZE) - 1
+                  << "), not pinning the event thread\n";
+        ok = false;
+    } else if (cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (rc != 0) {
+            std::cerr << "WARNING: Failed to pin event thread to CPU " << cpu << ": " << strerror(rc) << "\n";
+            ok = false;
+        }
+    }
+    
+    return ok;
+}
+
+bool lock_process_memory() {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << "WARNING: mlockall failed: " << strerror(errno) << " (raise LimitMEMLOCK)\n";
+        return false;
+    }
+    return true;
+}
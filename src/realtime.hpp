@@ -0,0 +1,15 @@
+#ifndef REALTIME_HPP
+#define REALTIME_HPP
+
+// Scheduling helpers for the opt-in real-time mode. Each one reports why it
+// failed on stderr and returns false; the mapper keeps running either way.
+
+// SCHED_FIFO at the given priority (1-99) for the calling thread, pinned to
+// cpu unless it is negative. Needs CAP_SYS_NICE or RLIMIT_RTPRIO >= priority.
+bool make_current_thread_realtime(int priority, int cpu);
+
+// mlockall(MCL_CURRENT | MCL_FUTURE) so the event path never page-faults.
+// Needs RLIMIT_MEMLOCK (LimitMEMLOCK= in the service) above the process size.
+bool lock_process_memory();
+
+#endif // REALTIME_HPP
@@ -0,0 +1,517 @@
+#include "soak_test.hpp"
+#include "virtual_device.hpp"
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+
+namespace {
+
+constexpr const char* VENDOR_ID = "044f";  // Thrustmaster
+constexpr uint64_t SPARE_TOGGLE_TICKS = 4;  // A spare button toggles every this many frames
+constexpr uint64_t SETTLE_US = 2000000;     // Reader gives up this long after its last frame
+
+const char* role_name(Role role) {
+    switch (role) {
+        case Role::Stick: return "stick";
+        case Role::Throttle: return "throttle";
+        case Role::Rudder: return "rudder";
+    }
+    return "stick";
+}
+
+uint64_t gray_encode(uint64_t value) {
+    return value ^ (value >> 1);
+}
+
+uint64_t gray_decode(uint64_t gray) {
+    uint64_t value = gray;
+    for (uint64_t shift = gray >> 1; shift != 0; shift >>= 1) {
+        value ^= shift;
+    }
+    return value;
+}
+
+std::vector<uint16_t> button_range(uint16_t first, int count) {
+    std::vector<uint16_t> buttons;
+    for (int i = 0; i < count; i++) {
+        buttons.push_back(static_cast<uint16_t>(first + i));
+    }
+    return buttons;
+}
+
+} // namespace
+
+SoakTest::SoakTest(const SoakSettings& settings) : settings(settings) {
+    // Axis and button layouts of the real devices, roughly as the kernel reports them
+    sources.push_back(Source(Role::Stick, "Thrustmaster T.16000M (soak)", 0xb10a,
+                             {{ABS_X, 0, 16383}, {ABS_Y, 0, 16383}, {ABS_RZ, 0, 255}, {ABS_THROTTLE, 0, 255},
+                              {ABS_HAT0X, -1, 1}, {ABS_HAT0Y, -1, 1}},
+                             button_range(BTN_TRIGGER, 16)));
+    sources.push_back(Source(Role::Throttle, "Thrustmaster TWCS Throttle (soak)", 0xb687,
+                             {{ABS_X, 0, 1023}, {ABS_Y, 0, 1023}, {ABS_Z, 0, 65535}, {ABS_RX, 0, 1023},
+                              {ABS_RY, 0, 1023}, {ABS_RZ, 0, 1023}, {ABS_THROTTLE, 0, 1023},
+                              {ABS_HAT0X, -1, 1}, {ABS_HAT0Y, -1, 1}},
+                             button_range(BTN_TRIGGER, 14)));
+    sources.push_back(Source(Role::Rudder, "Thrustmaster T-Rudder (soak)", 0xb679,
+                             {{ABS_X, 0, 1023}, {ABS_Y, 0, 1023}, {ABS_RZ, 0, 1023}},
+                             {}));
+}
+
+SoakTest::~SoakTest() {
+    stop();
+}
+
+bool SoakTest::create_sources(Config& config) {
+    for (auto& source : sources) {
+        if (!create_source(source)) {
+            destroy_sources();
+            return false;
+        }
+        
+        char product[8];
+        snprintf(product, sizeof(product), "%04x", source.product);
+        DeviceConfig& device = config.devices[role_name(source.role)];
+        device.role = role_name(source.role);
+        device.by_id = source.node;
+        device.vendor = VENDOR_ID;
+        device.product = product;
+        device.optional = false;
+        std::cout << "Soak source " << device.role << ": " << source.name << " at " << source.node << "\n";
+    }
+    
+    config.uinput_name += " (soak)";
+    for (auto& output : config.outputs) {
+        output.uinput_name += " (soak)";
+    }
+    return true;
+}
+
+bool SoakTest::create_source(Source& source) {
+    source.fd = open("/dev/uinput", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (source.fd < 0) {
+        perror("Failed to open uinput for soak source");
+        return false;
+    }
+    
+    bool enabled = ioctl(source.fd, UI_SET_EVBIT, EV_ABS) == 0;
+    if (!source.buttons.empty()) {
+        enabled = enabled && ioctl(source.fd, UI_SET_EVBIT, EV_KEY) == 0;
+    }
+    for (uint16_t code : source.buttons) {
+        enabled = enabled && ioctl(source.fd, UI_SET_KEYBIT, code) == 0;
+    }
+    for (const auto& axis : source.axes) {
+        enabled = enabled && ioctl(source.fd, UI_SET_ABSBIT, axis.code) == 0;
+    }
+    if (!enabled) {
+        perror("Failed to set soak source capabilities");
+        return false;
+    }
+    
+    struct uinput_user_dev uidev;
+    memset(&uidev, 0, sizeof(uidev));
+    strncpy(uidev.name, source.name.c_str(), UINPUT_MAX_NAME_SIZE - 1);
+    uidev.id.bustype = BUS_USB;
+    uidev.id.vendor = 0x044f;
+    uidev.id.product = source.product;
+    uidev.id.version = 1;
+    for (const auto& axis : source.axes) {
+        uidev.absmin[axis.code] = axis.minimum;
+        uidev.absmax[axis.code] = axis.maximum;
+    }
+    if (write(source.fd, &uidev, sizeof(uidev)) < 0 || ioctl(source.fd, UI_DEV_CREATE) < 0) {
+        perror("Failed to create soak source");
+        return false;
+    }
+    
+    // devtmpfs adds the node right away, but udev may still be setting permissions
+    for (int attempt = 0; attempt < 100; attempt++) {
+        source.node = uinput_event_node(source.fd);
+        if (!source.node.empty() && access(source.node.c_str(), R_OK) == 0) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::cerr << "Soak source " << source.name << " has no readable event node\n";
+    return false;
+}
+
+void SoakTest::destroy_sources() {
+    for (auto& source : sources) {
+        if (source.fd >= 0) {
+            ioctl(source.fd, UI_DEV_DESTROY);
+            close(source.fd);
+            source.fd = -1;
+        }
+        source.node.clear();
+    }
+}
+
+bool SoakTest::plan(const std::vector<Binding>& bindings, const std::vector<PhysicalInput>& excluded) {
+    auto source_of = [&](Role role) {
+        for (size_t i = 0; i < sources.size(); i++) {
+            if (sources[i].role == role) return i;
+        }
+        return sources.size();
+    };
+    auto has_button = [&](const PhysicalInput& input) {
+        size_t index = source_of(input.role);
+        return index < sources.size() &&
+               std::find(sources[index].buttons.begin(), sources[index].buttons.end(), input.code) !=
+                   sources[index].buttons.end();
+    };
+    
+    // Key sources per virtual button on the first output, and how many buttons each one reaches
+    std::map<uint16_t, std::vector<PhysicalInput>> sources_by_button;
+    std::map<PhysicalInput, int> targets;
+    for (const auto& binding : bindings) {
+        if (binding.output != 0 || binding.src.kind != SrcKind::Key || binding.dst.kind != SrcKind::Key ||
+            virtual_button_index(binding.dst.code) < 0) {
+            continue;
+        }
+        sources_by_button[binding.dst.code].push_back(binding.src);
+        targets[binding.src]++;
+    }
+    
+    // A counter bit needs a driver that reaches only its button, on a button the
+    // virtual controller emits. Every other source of that button is held
+    // released, so it can't OR into the bit.
+    std::set<PhysicalInput> reserved(excluded.begin(), excluded.end());
+    counter.clear();
+    for (uint16_t code : VIRTUAL_BUTTON_CODES) {
+        auto it = sources_by_button.find(code);
+        if (counter.size() == static_cast<size_t>(MAX_COUNTER_BITS) || it == sources_by_button.end() ||
+            !virtual_button_emits_key(code)) {
+            continue;
+        }
+        auto driver = std::find_if(it->second.begin(), it->second.end(), [&](const PhysicalInput& input) {
+            return !reserved.count(input) && targets[input] == 1 && has_button(input);
+        });
+        if (driver == it->second.end()) {
+            continue;
+        }
+        counter.push_back({{source_of(driver->role), driver->code}, code});
+        reserved.insert(it->second.begin(), it->second.end());
+    }
+    if (counter.size() < static_cast<size_t>(MIN_COUNTER_BITS)) {
+        std::cerr << "Soak test needs " << MIN_COUNTER_BITS << " buttons that each reach one virtual button "
+                  << "in the active profile, found " << counter.size() << "\n";
+        return false;
+    }
+    
+    // Everything else toggles, bound or not; unbound buttons must simply be ignored
+    spare_buttons.clear();
+    size_t axis_count = 0;
+    for (size_t i = 0; i < sources.size(); i++) {
+        for (uint16_t code : sources[i].buttons) {
+            if (!reserved.count({sources[i].role, SrcKind::Key, code})) {
+                spare_buttons.push_back({i, code});
+            }
+        }
+        axis_count += sources[i].axes.size();
+    }
+    spare_pressed.assign(spare_buttons.size(), 0);
+    
+    counter_modulus = 1ull << counter.size();
+    send_times = std::make_unique<std::atomic<uint64_t>[]>(counter_modulus);
+    std::cout << "Soak plan: " << counter.size() << " counter buttons, " << spare_buttons.size()
+              << " spare buttons, " << axis_count << " axes at " << settings.rate_hz << " Hz for "
+              << settings.duration_s << "s\n";
+    return true;
+}
+
+bool SoakTest::start(const std::string& output_node) {
+    reader_fd = output_node.empty() ? -1 : open(output_node.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (reader_fd < 0) {
+        perror(("Failed to open virtual controller for soak reader: " + output_node).c_str());
+        return false;
+    }
+    // Same clock as the send times, like the mapper's own input devices
+    int clock_id = CLOCK_MONOTONIC;
+    if (ioctl(reader_fd, EVIOCSCLOCKID, &clock_id) < 0) {
+        perror("Failed to set soak reader clock");
+        close(reader_fd);
+        reader_fd = -1;
+        return false;
+    }
+    
+    // Each axis sweeps its range once every 1-4 seconds, no two at the same speed
+    size_t axis_index = 0;
+    for (auto& source : sources) {
+        for (auto& axis : source.axes) {
+            uint64_t period_ms = 1000 + (axis_index++ * 370) % 3000;
+            axis.period_ticks = std::max<uint64_t>(2, static_cast<uint64_t>(settings.rate_hz) * period_ms / 1000);
+            axis.last_value = axis.minimum;
+        }
+    }
+    
+    reader_thread = std::thread(&SoakTest::reader_loop, this);
+    generator_thread = std::thread(&SoakTest::generator_loop, this);
+    return true;
+}
+
+void SoakTest::stop() {
+    stop_requested = true;
+    if (generator_thread.joinable()) generator_thread.join();
+    if (reader_thread.joinable()) reader_thread.join();
+    if (reader_fd >= 0) {
+        close(reader_fd);
+        reader_fd = -1;
+    }
+    destroy_sources();
+}
+
+void SoakTest::write_frame(Source& source, uint64_t tick) {
+    std::array<struct input_event, ABS_CNT + 3> events{};
+    size_t count = 0;
+    
+    // Triangle sweep
+    for (auto& axis : source.axes) {
+        uint64_t span = static_cast<uint64_t>(axis.maximum - axis.minimum);
+        uint64_t position = (tick % axis.period_ticks) * 2 * span / axis.period_ticks;
+        int value = axis.minimum + static_cast<int>(position <= span ? position : 2 * span - position);
+        if (value == axis.last_value) continue;
+        axis.last_value = value;
+        events[count].type = EV_ABS;
+        events[count].code = axis.code;
+        events[count].value = value;
+        count++;
+    }
+    for (size_t i = 0; i < source.pending_key_count; i++) {
+        events[count].type = EV_KEY;
+        events[count].code = source.pending_keys[i].first;
+        events[count].value = source.pending_keys[i].second;
+        count++;
+    }
+    source.pending_key_count = 0;
+    if (count == 0) {
+        return;
+    }
+    input_events += count;
+    events[count].type = EV_SYN;
+    events[count].code = SYN_REPORT;
+    count++;
+    
+    if (write(source.fd, events.data(), count * sizeof(events[0])) != static_cast<ssize_t>(count * sizeof(events[0]))) {
+        write_errors++;
+    }
+}
+
+void SoakTest::generator_loop() {
+    const uint64_t interval_ns = 1000000000ull / static_cast<uint64_t>(settings.rate_hz);
+    const uint64_t window = counter_modulus / 2;
+    const uint64_t start_us = LatencyStats::now_us();
+    const uint64_t end_us = start_us + static_cast<uint64_t>(settings.duration_s) * 1000000;
+    uint32_t rng = 0x9e3779b9;
+    
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    uint64_t tick = 0;
+    while (!stop_requested.load(std::memory_order_relaxed) && LatencyStats::now_us() < end_us) {
+        // The reader can only tell counter values apart within half the counter's range
+        if (tick + 1 - received_frames.load(std::memory_order_acquire) >= window) {
+            throttled_ticks++;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            clock_gettime(CLOCK_MONOTONIC, &next);
+            continue;
+        }
+        tick++;
+        
+        // Exactly one counter bit changes between consecutive Gray codes
+        uint64_t code = gray_encode(tick % counter_modulus);
+        uint64_t changed = code ^ gray_encode((tick - 1) % counter_modulus);
+        const CounterBit& bit = counter[__builtin_ctzll(changed)];
+        Source& counter_source = sources[bit.driver.source];
+        counter_source.pending_keys[counter_source.pending_key_count++] = {bit.driver.code, (code & changed) ? 1 : 0};
+        
+        if (!spare_buttons.empty() && tick % SPARE_TOGGLE_TICKS == 0) {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            size_t spare = rng % spare_buttons.size();
+            spare_pressed[spare] ^= 1;
+            Source& spare_source = sources[spare_buttons[spare].source];
+            spare_source.pending_keys[spare_source.pending_key_count++] = {spare_buttons[spare].code, spare_pressed[spare]};
+        }
+        
+        // The counter's source goes first; its write starts the frame's latency.
+        // sent_frames is published before the write so the reader never sees a
+        // value it would consider unsent.
+        send_times[tick % counter_modulus].store(LatencyStats::now_us(), std::memory_order_relaxed);
+        sent_frames.store(tick, std::memory_order_release);
+        write_frame(counter_source, tick);
+        for (auto& source : sources) {
+            if (&source != &counter_source) {
+                write_frame(source, tick);
+            }
+        }
+        
+        // Fixed schedule; a generator that fell behind restarts from now instead of bursting
+        next.tv_nsec += static_cast<long>(interval_ns);
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > next.tv_sec || (now.tv_sec == next.tv_sec && now.tv_nsec > next.tv_nsec)) {
+            late_ticks++;
+            next = now;
+        } else {
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr) == EINTR) {}
+        }
+    }
+    
+    generated_seconds = static_cast<double>(LatencyStats::now_us() - start_us) / 1e6;
+    generator_done.store(true, std::memory_order_release);
+}
+
+void SoakTest::decode_frame(uint16_t counter_state, uint64_t frame_time_us) {
+    output_frames++;
+    uint64_t previous = received_frames.load(std::memory_order_relaxed);
+    uint64_t step = (gray_decode(counter_state) - previous) & (counter_modulus - 1);
+    if (step == 0) {
+        uncounted_frames++;
+        return;
+    }
+    if (step >= counter_modulus / 2) {
+        reordered++;
+        return;
+    }
+    if (previous + step > sent_frames.load(std::memory_order_acquire)) {
+        corrupt++;
+        return;
+    }
+    
+    // Frames merged into this one waited longer; each counts with its own send time
+    for (uint64_t frame = previous + 1; frame <= previous + step; frame++) {
+        uint64_t sent_us = send_times[frame % counter_modulus].load(std::memory_order_relaxed);
+        latency.record(frame_time_us > sent_us ? frame_time_us - sent_us : 0);
+    }
+    merged_frames += step - 1;
+    received_frames.store(previous + step, std::memory_order_release);
+}
+
+void SoakTest::reader_loop() {
+    uint16_t counter_state = 0;
+    bool dropped = false;
+    uint64_t settle_deadline_us = 0;
+    
+    struct input_event events[256];
+    while (!stop_requested.load(std::memory_order_relaxed)) {
+        struct pollfd pfd = {reader_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 50) > 0) {
+            ssize_t bytes = read(reader_fd, events, sizeof(events));
+            if (bytes < 0 && errno != EAGAIN && errno != EINTR) {
+                perror("Soak reader failed");
+                break;
+            }
+            for (ssize_t i = 0; i < bytes / static_cast<ssize_t>(sizeof(events[0])); i++) {
+                const auto& ev = events[i];
+                if (ev.type == EV_SYN) {
+                    if (ev.code == SYN_DROPPED) {
+                        reader_overflows++;
+                        dropped = true;
+                    } else if (ev.code == SYN_REPORT) {
+                        if (dropped) {
+                            // Events up to here are incomplete; take the buttons from the kernel
+                            uint8_t keys[KEY_CNT / 8] = {};
+                            ioctl(reader_fd, EVIOCGKEY(sizeof(keys)), keys);
+                            counter_state = 0;
+                            for (size_t b = 0; b < counter.size(); b++) {
+                                uint16_t code = counter[b].virtual_code;
+                                if (keys[code / 8] & (1u << (code % 8))) counter_state |= 1u << b;
+                            }
+                            dropped = false;
+                        }
+                        decode_frame(counter_state, LatencyStats::event_time_us(ev));
+                        settle_deadline_us = 0;
+                    }
+                    continue;
+                }
+                output_events++;
+                if (ev.type != EV_KEY || dropped) continue;
+                for (size_t b = 0; b < counter.size(); b++) {
+                    if (counter[b].virtual_code != ev.code) continue;
+                    if (ev.value) {
+                        counter_state |= static_cast<uint16_t>(1u << b);
+                    } else {
+                        counter_state &= static_cast<uint16_t>(~(1u << b));
+                    }
+                }
+            }
+        }
+        
+        if (generator_done.load(std::memory_order_acquire)) {
+            uint64_t now_us = LatencyStats::now_us();
+            if (settle_deadline_us == 0) settle_deadline_us = now_us + SETTLE_US;
+            if (received_frames.load(std::memory_order_relaxed) == sent_frames.load(std::memory_order_relaxed) ||
+                now_us >= settle_deadline_us) {
+                break;
+            }
+        }
+    }
+    reader_done.store(true, std::memory_order_release);
+}
+
+int SoakTest::report() const {
+    uint64_t sent = sent_frames.load();
+    uint64_t received = received_frames.load();
+    uint64_t lost = sent - received;
+    double seconds = generated_seconds > 0 ? generated_seconds : 1.0;
+    
+    std::cout << "\nSoak test results\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  Generated: " << sent << " frames in " << generated_seconds << "s ("
+              << sent / seconds << " frames/s, target " << settings.rate_hz << "), "
+              << input_events << " input events (" << input_events / seconds << " events/s)\n";
+    std::cout << "  Generator: " << late_ticks << " late ticks, " << throttled_ticks
+              << " ticks waiting on the pipeline, " << write_errors << " write errors\n";
+    std::cout << "  Virtual controller: " << output_frames << " frames, " << output_events << " events, "
+              << uncounted_frames << " without a counter step\n";
+    std::cout << "  Counter: " << received << " of " << sent << " frames seen, " << merged_frames
+              << " merged into a later output frame, " << lost << " lost, " << reordered
+              << " out of order, " << corrupt << " corrupt\n";
+    if (latency.count() > 0) {
+        std::cout << "  Latency (source write to virtual event): p50 " << latency.percentile(0.50)
+                  << "us, p90 " << latency.percentile(0.90) << "us, p99 " << latency.percentile(0.99)
+                  << "us, p99.9 " << latency.percentile(0.999) << "us, max " << latency.max() << "us\n";
+    }
+    if (reader_overflows > 0) {
+        std::cout << "  Reader overflowed " << reader_overflows << " times (SYN_DROPPED)\n";
+    }
+    
+    std::vector<std::string> failures;
+    if (sent == 0 || latency.count() == 0) failures.push_back("no frames made it through");
+    if (lost > 0) failures.push_back("frames lost");
+    if (reordered > 0) failures.push_back("frames out of order");
+    if (corrupt > 0) failures.push_back("corrupt frames");
+    if (write_errors > 0) failures.push_back("source write errors");
+    if (reader_overflows > 0) failures.push_back("reader overflowed");
+    if (settings.max_p99_us > 0 && latency.percentile(0.99) > settings.max_p99_us) {
+        failures.push_back("p99 above " + std::to_string(settings.max_p99_us) + "us");
+    }
+    
+    if (failures.empty()) {
+        std::cout << "Soak test PASSED\n";
+        return 0;
+    }
+    std::cout << "Soak test FAILED:";
+    for (size_t i = 0; i < failures.size(); i++) {
+        std::cout << (i == 0 ? " " : ", ") << failures[i];
+    }
+    std::cout << "\n";
+    return 1;
+}
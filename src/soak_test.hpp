@@ -0,0 +1,137 @@
+#ifndef SOAK_TEST_HPP
+#define SOAK_TEST_HPP
+
+#include "bindings.hpp"
+#include "config.hpp"
+#include "latency_stats.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct SoakSettings {
+    int duration_s = 60;
+    int rate_hz = 1000;        // Synthetic frames per second on every source
+    uint64_t max_p99_us = 0;   // Fail above this end-to-end p99; 0 for no limit
+};
+
+// Headless end-to-end check of the normal mapper pipeline. Three uinput
+// devices stand in for the T.16000M, TWCS and T-Rudder (same ids, so device
+// validation passes) and are driven at a fixed rate: every axis sweeps, spare
+// buttons toggle, and a frame counter is Gray-coded onto buttons that each
+// reach exactly one virtual button, so every frame flips one of them. A reader
+// on the virtual controller decodes the counter to check ordering and loss and
+// to time each frame from its source write to the virtual event.
+class SoakTest {
+public:
+    static constexpr int MAX_COUNTER_BITS = 10;
+    static constexpr int MIN_COUNTER_BITS = 6;
+    
+    explicit SoakTest(const SoakSettings& settings);
+    ~SoakTest();
+    SoakTest(const SoakTest&) = delete;
+    SoakTest& operator=(const SoakTest&) = delete;
+    
+    // Creates the synthetic devices and points every role in config at them.
+    // Virtual controllers get a " (soak)" suffix so nothing mistakes them for the real ones.
+    bool create_sources(Config& config);
+    
+    // Picks counter and spare buttons from the key bindings of the first output.
+    // excluded are source buttons the generator must never press (profile switch combo).
+    bool plan(const std::vector<Binding>& bindings, const std::vector<PhysicalInput>& excluded);
+    
+    // Starts the reader on the virtual controller's node, then the generator
+    bool start(const std::string& output_node);
+    // True once the generator is done and the reader has seen its last frame (or gave up)
+    bool finished() const { return reader_done.load(std::memory_order_acquire); }
+    void stop();
+    
+    // Prints the results; 0 if the run passed, 1 otherwise
+    int report() const;
+
+private:
+    struct AxisSpec {
+        uint16_t code;
+        int minimum;
+        int maximum;
+        uint64_t period_ticks = 0;  // One full sweep, set when the run starts
+        int last_value = 0;
+    };
+    
+    struct Source {
+        Role role;
+        std::string name;
+        uint16_t product;
+        std::vector<AxisSpec> axes;
+        std::vector<uint16_t> buttons;
+        int fd = -1;
+        std::string node;
+        // Key changes for the next frame (a spare toggle and a counter flip at most)
+        std::array<std::pair<uint16_t, int>, 2> pending_keys{};
+        size_t pending_key_count = 0;
+        
+        Source(Role role, std::string name, uint16_t product, std::vector<AxisSpec> axes,
+               std::vector<uint16_t> buttons)
+            : role(role), name(std::move(name)), product(product), axes(std::move(axes)),
+              buttons(std::move(buttons)) {}
+    };
+    
+    struct SourceButton {
+        size_t source;
+        uint16_t code;
+    };
+    
+    // One counter bit: the source button that drives it and the virtual button it shows on
+    struct CounterBit {
+        SourceButton driver;
+        uint16_t virtual_code;
+    };
+    
+    SoakSettings settings;
+    std::vector<Source> sources;
+    std::vector<CounterBit> counter;
+    std::vector<SourceButton> spare_buttons;
+    std::vector<uint8_t> spare_pressed;
+    uint64_t counter_modulus = 1;  // 2^counter bits
+    
+    std::thread generator_thread;
+    std::thread reader_thread;
+    std::atomic<bool> stop_requested{false};
+    std::atomic<bool> generator_done{false};
+    std::atomic<bool> reader_done{false};
+    std::atomic<uint64_t> sent_frames{0};
+    std::atomic<uint64_t> received_frames{0};  // Last counter value the reader decoded
+    // Send time of each counter value still in flight, indexed modulo counter_modulus
+    std::unique_ptr<std::atomic<uint64_t>[]> send_times;
+    int reader_fd = -1;
+    
+    // Generator results, read after stop()
+    uint64_t input_events = 0;
+    uint64_t late_ticks = 0;
+    uint64_t throttled_ticks = 0;
+    uint64_t write_errors = 0;
+    double generated_seconds = 0.0;
+    
+    // Reader results, read after stop()
+    uint64_t output_frames = 0;
+    uint64_t output_events = 0;
+    uint64_t uncounted_frames = 0;  // Output frames without a counter step (axes, spare buttons)
+    uint64_t merged_frames = 0;   // Input frames that shared an output frame with a later one
+    uint64_t reordered = 0;       // Counter went backwards
+    uint64_t corrupt = 0;         // Counter ahead of anything sent
+    uint64_t reader_overflows = 0;
+    LatencyHistogram latency;
+    
+    bool create_source(Source& source);
+    void destroy_sources();
+    void generator_loop();
+    void reader_loop();
+    void write_frame(Source& source, uint64_t tick);
+    void decode_frame(uint16_t counter_state, uint64_t frame_time_us);
+};
+
+#endif // SOAK_TEST_HPP
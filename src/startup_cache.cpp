@@ -0,0 +1,325 @@
+#include "startup_cache.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include <type_traits>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// Bump whenever the layout below changes; older snapshots are then ignored
+constexpr uint32_t SNAPSHOT_MAGIC = 0x53435754;  // "TWCS"
+constexpr uint32_t SNAPSHOT_VERSION = 7;
+
+class Writer {
+public:
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        data.append(bytes, sizeof(T));
+    }
+    
+    void put_string(const std::string& str) {
+        put(static_cast<uint32_t>(str.size()));
+        data.append(str);
+    }
+    
+    std::string data;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::string& data) : data(data) {}
+    
+    template <typename T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (data.size() - offset < sizeof(T)) return false;
+        memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+    
+    bool get_string(std::string& str) {
+        uint32_t len;
+        if (!get(len) || data.size() - offset < len) return false;
+        str.assign(data, offset, len);
+        offset += len;
+        return true;
+    }
+    
+    bool at_end() const { return offset == data.size(); }
+    
+private:
+    const std::string& data;
+    size_t offset = 0;
+};
+
+bool read_file(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+} // namespace
+
+uint64_t StartupCache::fnv1a(const void* data, size_t len, uint64_t hash) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool StartupCache::hash_file(const std::string& path, uint64_t& hash) {
+    std::string contents;
+    if (!read_file(path, contents)) {
+        return false;
+    }
+    hash = fnv1a(contents.data(), contents.size());
+    return true;
+}
+
+std::string StartupCache::get_cache_path() {
+    const char* cache_home = getenv("XDG_CACHE_HOME");
+    if (cache_home && cache_home[0] != '\0') {
+        return std::string(cache_home) + "/twcs-mapper/startup.bin";
+    }
+    
+    const char* home = getenv("HOME");
+    if (!home) {
+        return "";
+    }
+    return std::string(home) + "/.cache/twcs-mapper/startup.bin";
+}
+
+std::optional<StartupSnapshot> StartupCache::load(const std::string& cache_path) {
+    std::string contents;
+    if (cache_path.empty() || !read_file(cache_path, contents)) {
+        return std::nullopt;
+    }
+    
+    Reader in(contents);
+    uint32_t magic, version;
+    if (!in.get(magic) || !in.get(version) || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+        return std::nullopt;
+    }
+    
+    StartupSnapshot snapshot;
+    Config& config = snapshot.config;
+    uint8_t grab, realtime, lock_memory, raw_read;
+    int32_t output_max_rate_hz;
+    int32_t realtime_priority, realtime_cpu;
+    uint32_t device_count;
+    if (!in.get(snapshot.config_hash) || !in.get(snapshot.caps_hash) ||
+        !in.get_string(config.uinput_name) || !in.get(grab) ||
+        !in.get(realtime) || !in.get(realtime_priority) || !in.get(realtime_cpu) || !in.get(lock_memory) ||
+        !in.get(raw_read) || !in.get(config.output_hysteresis) || !in.get(output_max_rate_hz) ||
+        !in.get_string(config.active_profile) || !in.get_string(config.profile_switch.role)) {
+        return std::nullopt;
+    }
+    uint32_t switch_button_count;
+    if (!in.get(switch_button_count)) {
+        return std::nullopt;
+    }
+    for (uint32_t i = 0; i < switch_button_count; i++) {
+        int32_t code;
+        if (!in.get(code)) {
+            return std::nullopt;
+        }
+        config.profile_switch.buttons.push_back(code);
+    }
+    if (!in.get(device_count)) {
+        return std::nullopt;
+    }
+    config.grab = (grab != 0);
+    config.realtime = (realtime != 0);
+    config.realtime_priority = realtime_priority;
+    config.realtime_cpu = realtime_cpu;
+    config.lock_memory = (lock_memory != 0);
+    config.raw_read = (raw_read != 0);
+    config.output_max_rate_hz = output_max_rate_hz;
+    
+    for (uint32_t i = 0; i < device_count; i++) {
+        std::string key;
+        DeviceConfig device;
+        uint8_t optional;
+        if (!in.get_string(key) || !in.get_string(device.role) || !in.get_string(device.by_id) ||
+            !in.get_string(device.vendor) || !in.get_string(device.product) || !in.get(optional)) {
+            return std::nullopt;
+        }
+        device.optional = (optional != 0);
+        config.devices[key] = device;
+    }
+    
+    uint32_t output_count;
+    if (!in.get(output_count)) {
+        return std::nullopt;
+    }
+    for (uint32_t i = 0; i < output_count; i++) {
+        OutputConfig output;
+        if (!in.get_string(output.uinput_name)) {
+            return std::nullopt;
+        }
+        config.outputs.push_back(output);
+    }
+    
+    uint32_t calibration_count;
+    if (!in.get(calibration_count)) {
+        return std::nullopt;
+    }
+    for (uint32_t i = 0; i < calibration_count; i++) {
+        std::string role;
+        int32_t axis_code;
+        AxisCalibration cal;
+        if (!in.get_string(role) || !in.get(axis_code) || !in.get(cal)) {
+            return std::nullopt;
+        }
+        config.calibrations[role][axis_code] = cal;
+    }
+    
+    uint32_t profile_count;
+    if (!in.get(profile_count)) {
+        return std::nullopt;
+    }
+    for (uint32_t p = 0; p < profile_count; p++) {
+        std::string profile_name;
+        uint32_t binding_count;
+        if (!in.get_string(profile_name) || !in.get(binding_count)) {
+            return std::nullopt;
+        }
+        std::vector<Binding>& bindings = snapshot.profile_bindings[profile_name];
+        bindings.reserve(binding_count);
+        for (uint32_t i = 0; i < binding_count; i++) {
+            uint8_t role, src_kind, dst_kind, invert;
+            Binding binding;
+            if (!in.get(role) || !in.get(src_kind) || !in.get(binding.src.code) ||
+                !in.get(dst_kind) || !in.get(binding.dst.code) ||
+                !in.get(invert) || !in.get(binding.xform.deadzone) || !in.get(binding.xform.scale) ||
+                !in.get(binding.xform.min_out) || !in.get(binding.xform.max_out) || !in.get(binding.xform.expo) ||
+                !in.get(binding.xform.s_curve) || !in.get(binding.xform.smoothing) || !in.get(binding.output)) {
+                return std::nullopt;
+            }
+            if (role >= ROLE_COUNT || src_kind > 1 || dst_kind > 1) {
+                return std::nullopt;
+            }
+            binding.src.role = static_cast<Role>(role);
+            binding.src.kind = static_cast<SrcKind>(src_kind);
+            binding.dst.kind = static_cast<SrcKind>(dst_kind);
+            binding.xform.invert = (invert != 0);
+            bindings.push_back(binding);
+        }
+    }
+    
+    if (!in.at_end()) {
+        return std::nullopt;
+    }
+    return snapshot;
+}
+
+bool StartupCache::save(const std::string& cache_path, const StartupSnapshot& snapshot) {
+    if (cache_path.empty()) {
+        return false;
+    }
+    
+    const Config& config = snapshot.config;
+    Writer out;
+    out.put(SNAPSHOT_MAGIC);
+    out.put(SNAPSHOT_VERSION);
+    out.put(snapshot.config_hash);
+    out.put(snapshot.caps_hash);
+    out.put_string(config.uinput_name);
+    out.put(static_cast<uint8_t>(config.grab));
+    out.put(static_cast<uint8_t>(config.realtime));
+    out.put(static_cast<int32_t>(config.realtime_priority));
+    out.put(static_cast<int32_t>(config.realtime_cpu));
+    out.put(static_cast<uint8_t>(config.lock_memory));
+    out.put(static_cast<uint8_t>(config.raw_read));
+    out.put(config.output_hysteresis);
+    out.put(static_cast<int32_t>(config.output_max_rate_hz));
+    out.put_string(config.active_profile);
+    out.put_string(config.profile_switch.role);
+    out.put(static_cast<uint32_t>(config.profile_switch.buttons.size()));
+    for (int code : config.profile_switch.buttons) {
+        out.put(static_cast<int32_t>(code));
+    }
+    
+    out.put(static_cast<uint32_t>(config.devices.size()));
+    for (const auto& [key, device] : config.devices) {
+        out.put_string(key);
+        out.put_string(device.role);
+        out.put_string(device.by_id);
+        out.put_string(device.vendor);
+        out.put_string(device.product);
+        out.put(static_cast<uint8_t>(device.optional));
+    }
+    
+    out.put(static_cast<uint32_t>(config.outputs.size()));
+    for (const auto& output : config.outputs) {
+        out.put_string(output.uinput_name);
+    }
+    
+    uint32_t calibration_count = 0;
+    for (const auto& [role, axes] : config.calibrations) {
+        calibration_count += static_cast<uint32_t>(axes.size());
+    }
+    out.put(calibration_count);
+    for (const auto& [role, axes] : config.calibrations) {
+        for (const auto& [axis_code, cal] : axes) {
+            out.put_string(role);
+            out.put(static_cast<int32_t>(axis_code));
+            out.put(cal);
+        }
+    }
+    
+    out.put(static_cast<uint32_t>(snapshot.profile_bindings.size()));
+    for (const auto& [profile_name, bindings] : snapshot.profile_bindings) {
+        out.put_string(profile_name);
+        out.put(static_cast<uint32_t>(bindings.size()));
+        for (const auto& binding : bindings) {
+            out.put(static_cast<uint8_t>(binding.src.role));
+            out.put(static_cast<uint8_t>(binding.src.kind));
+            out.put(binding.src.code);
+            out.put(static_cast<uint8_t>(binding.dst.kind));
+            out.put(binding.dst.code);
+            out.put(static_cast<uint8_t>(binding.xform.invert));
+            out.put(binding.xform.deadzone);
+            out.put(binding.xform.scale);
+            out.put(binding.xform.min_out);
+            out.put(binding.xform.max_out);
+            out.put(binding.xform.expo);
+            out.put(binding.xform.s_curve);
+            out.put(binding.xform.smoothing);
+            out.put(binding.output);
+        }
+    }
+    
+    // Write to a temp file and rename so a crash never leaves a torn snapshot
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(cache_path).parent_path(), ec);
+    
+    std::string tmp_path = cache_path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(out.data.data(), static_cast<std::streamsize>(out.data.size()));
+        if (!file.good()) {
+            return false;
+        }
+    }
+    
+    if (rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef STARTUP_CACHE_HPP
+#define STARTUP_CACHE_HPP
+
+#include "config.hpp"
+#include "bindings.hpp"
+#include <string>
+#include <vector>
+#include <optional>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+// Everything the mapper derives from config.json and the attached devices
+// before it can emit events. Only the settings, outputs, devices, active
+// profile name and calibrations of `config` are stored; profiles are kept
+// only as the bindings they compiled to.
+struct StartupSnapshot {
+    uint64_t config_hash = 0;   // FNV-1a of the raw config.json bytes
+    uint64_t caps_hash = 0;     // Device presence + capabilities the bindings were filtered against
+    Config config;
+    std::map<std::string, std::vector<Binding>> profile_bindings;  // Profile name -> bindings after validate_and_filter_bindings
+};
+
+class StartupCache {
+public:
+    static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+    
+    static uint64_t fnv1a(const void* data, size_t len, uint64_t hash = FNV_OFFSET);
+    static bool hash_file(const std::string& path, uint64_t& hash);
+    
+    // $XDG_CACHE_HOME/twcs-mapper/startup.bin (falls back to ~/.cache)
+    static std::string get_cache_path();
+    static std::optional<StartupSnapshot> load(const std::string& cache_path);
+    static bool save(const std::string& cache_path, const StartupSnapshot& snapshot);
+};
+
+#endif // STARTUP_CACHE_HPP
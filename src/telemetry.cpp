@@ -0,0 +1,169 @@
+#include "telemetry.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+std::string TelemetryWriter::get_shm_name() {
+    return "/twcs-mapper-telemetry-" + std::to_string(getuid());
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    close();
+}
+
+bool TelemetryWriter::open(const std::vector<std::string>& labels, const std::vector<std::string>& by_ids) {
+    close();
+    
+    std::string name = get_shm_name();
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        perror("Failed to create telemetry shared memory");
+        return false;
+    }
+    if (ftruncate(fd, sizeof(TelemetryBlock)) < 0) {
+        perror("Failed to size telemetry shared memory");
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        perror("Failed to map telemetry shared memory");
+        return false;
+    }
+    
+    // Invalidate first so a reader of a leftover block never mixes old and new layouts
+    block = static_cast<TelemetryBlock*>(mapping);
+    block->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    block->version = TELEMETRY_VERSION;
+    block->writer_pid = getpid();
+    block->source_count = static_cast<uint32_t>(std::min(labels.size(), TELEMETRY_MAX_SOURCES));
+    memset(block->labels, 0, sizeof(block->labels));
+    memset(block->by_id, 0, sizeof(block->by_id));
+    for (size_t i = 0; i < block->source_count; i++) {
+        strncpy(block->labels[i], labels[i].c_str(), sizeof(block->labels[i]) - 1);
+        if (i < by_ids.size()) {
+            strncpy(block->by_id[i], by_ids[i].c_str(), sizeof(block->by_id[i]) - 1);
+        }
+    }
+    block->published.store(0, std::memory_order_relaxed);
+    for (auto& slot : block->slots) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+    
+    std::atomic_thread_fence(std::memory_order_release);
+    block->magic = TELEMETRY_MAGIC;
+    return true;
+}
+
+void TelemetryWriter::close() {
+    if (!block) return;
+    
+    block->magic = 0;
+    munmap(block, sizeof(TelemetryBlock));
+    block = nullptr;
+    shm_unlink(get_shm_name().c_str());
+}
+
+void TelemetryWriter::publish(uint64_t now_us) {
+    if (!block) return;
+    
+    working.time_us = now_us;
+    uint64_t index = block->published.load(std::memory_order_relaxed);
+    TelemetryBlock::Slot& slot = block->slots[index % TELEMETRY_SLOTS];
+    
+    // Seqlock write: odd sequence while the frame is inconsistent
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.frame, &working, sizeof(working));
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    
+    block->published.store(index + 1, std::memory_order_release);
+}
+
+TelemetryReader::~TelemetryReader() {
+    close();
+}
+
+bool TelemetryReader::open() {
+    close();
+    
+    int fd = shm_open(TelemetryWriter::get_shm_name().c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(TelemetryBlock)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    
+    block = static_cast<const TelemetryBlock*>(mapping);
+    if (block->magic != TELEMETRY_MAGIC || block->version != TELEMETRY_VERSION) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TelemetryReader::close() {
+    if (!block) return;
+    munmap(const_cast<TelemetryBlock*>(block), sizeof(TelemetryBlock));
+    block = nullptr;
+}
+
+bool TelemetryReader::writer_alive() const {
+    if (!block || block->magic != TELEMETRY_MAGIC) return false;
+    return kill(block->writer_pid, 0) == 0 || errno == EPERM;
+}
+
+uint64_t TelemetryReader::published() const {
+    return block ? block->published.load(std::memory_order_acquire) : 0;
+}
+
+size_t TelemetryReader::source_count() const {
+    return block ? std::min<size_t>(block->source_count, TELEMETRY_MAX_SOURCES) : 0;
+}
+
+std::string TelemetryReader::label(size_t source) const {
+    if (source >= source_count()) return "";
+    return std::string(block->labels[source], strnlen(block->labels[source], sizeof(block->labels[source])));
+}
+
+std::string TelemetryReader::by_id(size_t source) const {
+    if (source >= source_count()) return "";
+    return std::string(block->by_id[source], strnlen(block->by_id[source], sizeof(block->by_id[source])));
+}
+
+bool TelemetryReader::read(TelemetryFrame& out) const {
+    if (!block) return false;
+    
+    for (int attempt = 0; attempt < 16; attempt++) {
+        uint64_t published_count = block->published.load(std::memory_order_acquire);
+        if (published_count == 0) return false;
+    
+        const TelemetryBlock::Slot& slot = block->slots[(published_count - 1) % TELEMETRY_SLOTS];
+        uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        memcpy(&out, &slot.frame, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,118 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include "bindings.hpp"
+#include <linux/input.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Shared-memory view of the running mapper: the physical state of every input
+// device, the virtual controller state actually written to uinput, and the
+// stats counters. The mapper writes frames into a small ring of seqlocked
+// slots with plain stores (no syscalls); readers copy the newest slot and
+// retry if the writer lapped them mid-copy.
+
+constexpr uint32_t TELEMETRY_MAGIC = 0x4c545754;  // "TWTL"
+constexpr uint32_t TELEMETRY_VERSION = 1;
+constexpr size_t TELEMETRY_MAX_SOURCES = 4;
+constexpr size_t TELEMETRY_SLOTS = 4;
+constexpr size_t TELEMETRY_KEY_WORDS = (KEY_CNT + 63) / 64;
+
+struct TelemetrySource {
+    int32_t abs[ABS_CNT];
+    uint64_t keys[TELEMETRY_KEY_WORDS];
+    uint64_t events;   // LatencyStats counters
+    uint64_t frames;
+    uint64_t resyncs;
+    uint8_t online;
+
+    bool key_pressed(int code) const {
+        return code >= 0 && code < KEY_CNT && (keys[code / 64] & (1ull << (code % 64)));
+    }
+};
+
+struct TelemetryFrame {
+    uint64_t time_us;  // CLOCK_MONOTONIC at publish
+    TelemetrySource sources[TELEMETRY_MAX_SOURCES];
+    int32_t virtual_buttons[VIRTUAL_BUTTON_COUNT];  // VIRTUAL_BUTTON_CODES order
+    int32_t virtual_axes[VIRTUAL_AXIS_COUNT];       // VIRTUAL_AXIS_CODES order
+};
+
+struct TelemetryBlock {
+    uint32_t magic;
+    uint32_t version;
+    int32_t writer_pid;
+    uint32_t source_count;
+    char labels[TELEMETRY_MAX_SOURCES][32];
+    char by_id[TELEMETRY_MAX_SOURCES][256];
+    std::atomic<uint64_t> published;  // Frames published; the newest is in slot (published - 1) % TELEMETRY_SLOTS
+
+    struct Slot {
+        std::atomic<uint32_t> sequence;  // Odd while being written
+        TelemetryFrame frame;
+    } slots[TELEMETRY_SLOTS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "telemetry atomics must be address-free to live in shared memory");
+
+class TelemetryWriter {
+public:
+    ~TelemetryWriter();
+
+    // Creates (or takes over) the shared-memory block; sources are fixed from here on
+    bool open(const std::vector<std::string>& labels, const std::vector<std::string>& by_ids);
+    void close();
+    bool is_open() const { return block != nullptr; }
+
+    // Working copy, updated in place by the event thread between publishes
+    TelemetryFrame& frame() { return working; }
+
+    void record_event(size_t source, const struct input_event& ev) {
+        if (source >= TELEMETRY_MAX_SOURCES) return;
+        TelemetrySource& state = working.sources[source];
+        if (ev.type == EV_ABS && ev.code < ABS_CNT) {
+            state.abs[ev.code] = ev.value;
+        } else if (ev.type == EV_KEY && ev.code < KEY_CNT) {
+            uint64_t mask = 1ull << (ev.code % 64);
+            state.keys[ev.code / 64] = ev.value ? (state.keys[ev.code / 64] | mask) : (state.keys[ev.code / 64] & ~mask);
+        }
+    }
+
+    // Copies the working frame into the next ring slot
+    void publish(uint64_t now_us);
+
+    static std::string get_shm_name();
+
+private:
+    TelemetryBlock* block = nullptr;
+    TelemetryFrame working{};
+};
+
+class TelemetryReader {
+public:
+    ~TelemetryReader();
+
+    // Maps the block read-only; fails if no mapper has created one
+    bool open();
+    void close();
+    bool is_open() const { return block != nullptr; }
+
+    // False when the block is stale (writer gone) or incompatible
+    bool writer_alive() const;
+    uint64_t published() const;
+    size_t source_count() const;
+    std::string label(size_t source) const;
+    std::string by_id(size_t source) const;
+
+    // Newest consistent frame; false if none was published yet or the writer kept lapping us
+    bool read(TelemetryFrame& out) const;
+
+private:
+    const TelemetryBlock* block = nullptr;
+};
+
+#endif // TELEMETRY_HPP
@@ -0,0 +1,199 @@
+#include "trace.hpp"
+#include <array>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+std::atomic<uint32_t> trace::enabled_categories{0};
+
+namespace {
+
+constexpr size_t RING_SIZE = 1024;  // Power of two
+constexpr size_t RECORD_SIZE = 192;
+constexpr auto WRITER_INTERVAL = std::chrono::milliseconds(20);
+
+struct CategoryName {
+    TraceCategory category;
+    const char* name;
+};
+
+constexpr std::array<CategoryName, 3> CATEGORY_NAMES = {{
+    {TRACE_BINDINGS, "bindings"},
+    {TRACE_AXES, "axes"},
+    {TRACE_CALIBRATION, "calibration"},
+}};
+
+const char* category_name(TraceCategory category) {
+    for (const auto& entry : CATEGORY_NAMES) {
+        if (entry.category == category) return entry.name;
+    }
+    return "trace";
+}
+
+// Bounded multi-producer ring (per-slot sequence numbers). Producers claim a
+// slot with one CAS and never wait on the writer; a full ring drops the record.
+struct Slot {
+    std::atomic<size_t> sequence;
+    TraceCategory category;
+    char text[RECORD_SIZE];
+};
+
+class TraceWriter {
+public:
+    TraceWriter() {
+        for (size_t i = 0; i < RING_SIZE; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    ~TraceWriter() { stop(); }
+    
+    void start() {
+        if (thread.joinable()) return;
+        running.store(true, std::memory_order_release);
+        thread = std::thread([this]() { run(); });
+    }
+    
+    void stop() {
+        if (!thread.joinable()) return;
+        running.store(false, std::memory_order_release);
+        thread.join();
+    }
+    
+    Slot* claim() {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & (RING_SIZE - 1)];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return &slot;
+                }
+            } else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    void publish(Slot* slot) {
+        size_t seq = slot->sequence.load(std::memory_order_relaxed);
+        slot->sequence.store(seq + 1, std::memory_order_release);
+    }
+    
+private:
+    std::array<Slot, RING_SIZE> slots;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) size_t dequeue_pos = 0;  // Writer thread only
+    std::atomic<uint64_t> dropped{0};
+    uint64_t reported_dropped = 0;
+    std::atomic<bool> running{false};
+    std::thread thread;
+    
+    void drain() {
+        for (;;) {
+            Slot& slot = slots[dequeue_pos & (RING_SIZE - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) break;
+            
+            fprintf(stderr, "[%s] %s", category_name(slot.category), slot.text);
+            slot.sequence.store(dequeue_pos + RING_SIZE, std::memory_order_release);
+            dequeue_pos++;
+        }
+        
+        uint64_t total_dropped = dropped.load(std::memory_order_relaxed);
+        if (total_dropped != reported_dropped) {
+            fprintf(stderr, "[trace] dropped %llu records (ring full)\n",
+                    static_cast<unsigned long long>(total_dropped - reported_dropped));
+            reported_dropped = total_dropped;
+        }
+        fflush(stderr);
+    }
+    
+    void run() {
+        while (running.load(std::memory_order_acquire)) {
+            drain();
+            std::this_thread::sleep_for(WRITER_INTERVAL);
+        }
+        drain();
+    }
+};
+
+TraceWriter& writer() {
+    static TraceWriter instance;
+    return instance;
+}
+
+uint32_t parse_categories(const char* list) {
+    uint32_t mask = 0;
+    std::string remaining(list);
+    size_t start = 0;
+    while (start <= remaining.size()) {
+        size_t end = remaining.find(',', start);
+        if (end == std::string::npos) end = remaining.size();
+        std::string name = remaining.substr(start, end - start);
+        
+        if (name == "all") {
+            mask |= TRACE_ALL;
+        } else if (!name.empty()) {
+            bool known = false;
+            for (const auto& entry : CATEGORY_NAMES) {
+                if (name == entry.name) {
+                    mask |= entry.category;
+                    known = true;
+                }
+            }
+            if (!known) {
+                fprintf(stderr, "WARNING: Unknown TWCS_TRACE category: %s\n", name.c_str());
+            }
+        }
+        start = end + 1;
+    }
+    return mask;
+}
+
+} // namespace
+
+uint32_t trace::init_from_env() {
+    uint32_t mask = 0;
+    
+    const char* trace_env = getenv("TWCS_TRACE");
+    if (trace_env) {
+        mask |= parse_categories(trace_env);
+    }
+    
+    const char* debug_env = getenv("TWCS_DEBUG_BINDINGS");
+    if (debug_env && strcmp(debug_env, "1") == 0) {
+        mask |= TRACE_BINDINGS;
+    }
+    
+    if (mask != 0) {
+        writer().start();
+    }
+    enabled_categories.store(mask, std::memory_order_relaxed);
+    return mask;
+}
+
+void trace::shutdown() {
+    enabled_categories.store(0, std::memory_order_relaxed);
+    writer().stop();
+}
+
+void trace::write(TraceCategory category, const char* format, ...) {
+    Slot* slot = writer().claim();
+    if (!slot) return;
+    
+    va_list args;
+    va_start(args, format);
+    vsnprintf(slot->text, sizeof(slot->text), format, args);
+    va_end(args);
+    
+    slot->category = category;
+    writer().publish(slot);
+}
@@ -0,0 +1,47 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+
+// Runtime-selectable trace categories, enabled with TWCS_TRACE=<list> where
+// <list> is a comma-separated set of category names or "all".
+enum TraceCategory : uint32_t {
+    TRACE_BINDINGS    = 1u << 0,  // "bindings": resolver dispatch and output changes
+    TRACE_AXES        = 1u << 1,  // "axes": raw -> transformed value for every axis event
+    TRACE_CALIBRATION = 1u << 2,  // "calibration": float-path calibration math and missing calibrations
+    TRACE_ALL         = TRACE_BINDINGS | TRACE_AXES | TRACE_CALIBRATION
+};
+
+namespace trace {
+
+extern std::atomic<uint32_t> enabled_categories;
+
+inline bool enabled(uint32_t categories) {
+    return (enabled_categories.load(std::memory_order_relaxed) & categories) != 0;
+}
+
+// Parses TWCS_TRACE (and the legacy TWCS_DEBUG_BINDINGS=1) and starts the
+// writer thread if anything is enabled. Returns the enabled category mask.
+uint32_t init_from_env();
+
+// Flushes pending records and stops the writer thread. Also runs at exit.
+void shutdown();
+
+// Formats one record into a ring buffer slot; a background thread writes it to
+// stderr. Never blocks: when the ring is full the record is dropped and counted.
+void write(TraceCategory category, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+} // namespace trace
+
+#ifdef TWCS_NO_TRACE
+// Arguments stay type-checked (and "used") but the call is dead code
+#define TRACE(category, ...) do { if (false) trace::write(category, __VA_ARGS__); } while (0)
+#else
+#define TRACE(category, ...) \
+    do { \
+        if (__builtin_expect(trace::enabled(category), 0)) trace::write(category, __VA_ARGS__); \
+    } while (0)
+#endif
+
+#endif // TRACE_HPP
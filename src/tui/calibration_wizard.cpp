@@ -52,16 +52,24 @@ std::vector<CalibrationWizard::CalibItem> CalibrationWizard::get_calibration_ite
 CalibrationWizard::CalibrationWizard(TUI* parent) : View(parent, ViewType::CALIBRATION), 
                                  state(State::SELECT_DEVICE),
                                  selected_axis(-1),
-                                 sample_duration_ms(5000) {
+                                 sample_duration_ms(5000),
+                                 sampler_stop(false),
+                                 sampler_lost(false),
+                                 mapper_stopped(false) {
     reset_calibration();
 }
 
+CalibrationWizard::~CalibrationWizard() {
+    stop_sampler();
+    restart_mapper();
+}
+
 void CalibrationWizard::reset_calibration() {
+    stop_sampler();
+    restart_mapper();
     state = State::SELECT_DEVICE;
     selected_role.clear();
     selected_axis = -1;
-    center_samples.clear();
-    range_samples.clear();
     current_calibration = AxisCalibration{0, 0, 65535, 32768, 0};
 }
 
@@ -230,22 +238,15 @@ void CalibrationWizard::draw_center_sampling(Window* main_win) {
               elapsed / 1000.0f, sample_duration_ms / 1000.0f);
     
     // Live samples
-    if (!center_samples.empty()) {
-        int current = center_samples.back();
-        double sum = 0;
-        for (int v : center_samples) sum += v;
-        int avg = static_cast<int>(sum / center_samples.size());
-        
-        mvwprintw(main_win->get(), 10, 2, "Current: %6d  Average: %6d  Samples: %zu",
-                  current, avg, center_samples.size());
+    AxisStats stats = sampled_stats();
+    if (stats.count() > 0) {
+        mvwprintw(main_win->get(), 10, 2, "Current: %6d  Center: %6d  Noise: %6.1f  Samples: %llu",
+                  stats.last(), stats.center(), stats.stddev(), static_cast<unsigned long long>(stats.count()));
     }
     
     // Auto-advance when done
     if (progress >= 1.0f) {
         finish_center_sampling();
-    } else {
-        // Continue sampling
-        sample_axis_value();
     }
     
     main_win->print(13, 2, "[S]kip  [R]estart  [ESC] Cancel");
@@ -282,21 +283,15 @@ void CalibrationWizard::draw_range_sampling(Window* main_win) {
               elapsed / 1000.0f, sample_duration_ms / 1000.0f);
     
     // Show current range
-    if (!range_samples.empty()) {
-        int current = range_samples.back();
-        int min_val = *std::min_element(range_samples.begin(), range_samples.end());
-        int max_val = *std::max_element(range_samples.begin(), range_samples.end());
-        
-        mvwprintw(main_win->get(), 10, 2, "Current: %6d  Min: %6d  Max: %6d",
-                  current, min_val, max_val);
+    AxisStats stats = sampled_stats();
+    if (stats.count() > 0) {
+        mvwprintw(main_win->get(), 10, 2, "Current: %6d  Min: %6d  Max: %6d  Samples: %llu",
+                  stats.last(), stats.min(), stats.max(), static_cast<unsigned long long>(stats.count()));
     }
     
     // Auto-advance when done
     if (progress >= 1.0f) {
         finish_range_sampling();
-    } else {
-        // Continue sampling
-        sample_axis_value();
     }
     
     main_win->print(13, 2, "[S]kip  [R]estart  [ESC] Cancel");
@@ -467,6 +462,7 @@ void CalibrationWizard::handle_center_sampling(int ch) {
             break;
         case 'r':
         case 'R':
+            stop_sampler();
             state = State::READY_CENTER;
             needs_redraw = true;
             break;
@@ -501,6 +497,7 @@ void CalibrationWizard::handle_range_sampling(int ch) {
             break;
         case 'r':
         case 'R':
+            stop_sampler();
             state = State::READY_RANGE;
             needs_redraw = true;
             break;
@@ -523,8 +520,6 @@ void CalibrationWizard::handle_review(int ch) {
             // Retry goes back through ready gates
             if (selected_item >= 0 && selected_item < static_cast<int>(get_calibration_items().size())) {
                 state = State::READY_CENTER;
-                center_samples.clear();
-                range_samples.clear();
                 needs_redraw = true;
             }
             break;
@@ -541,53 +536,91 @@ void CalibrationWizard::start_calibration() {
         selected_axis = items[selected_item].src_axis;
         state = State::READY_CENTER;
         needs_redraw = true;
+        
+        // Stop mapper so we can read from devices it had grabbed
+        if (!mapper_stopped && stop_mapper_service()) {
+            mapper_stopped = true;
+            tui->scan_devices();
+        }
     }
 }
 
 void CalibrationWizard::start_center_sampling() {
+    if (!start_sampler()) return;
     state = State::CENTER_SAMPLE;
-    center_samples.clear();
     sample_start = std::chrono::steady_clock::now();
     needs_redraw = true;
 }
 
 void CalibrationWizard::start_range_sampling() {
+    if (!start_sampler()) return;
     state = State::RANGE_SAMPLE;
-    range_samples.clear();
     sample_start = std::chrono::steady_clock::now();
     needs_redraw = true;
 }
 
-void CalibrationWizard::sample_axis_value() {
-    // Find device and read axis
-    auto& devices = tui->get_devices();
-    for (const auto& dev : devices) {
-        if (dev->has_role(selected_role) && dev->online && dev->fd >= 0) {
-            struct input_absinfo absinfo;
-            if (ioctl(dev->fd, EVIOCGABS(selected_axis), &absinfo) == 0) {
-                if (state == State::CENTER_SAMPLE) {
-                    center_samples.push_back(absinfo.value);
-                } else if (state == State::RANGE_SAMPLE) {
-                    range_samples.push_back(absinfo.value);
-                }
-            }
+bool CalibrationWizard::start_sampler() {
+    stop_sampler();
+    
+    for (const auto& dev : tui->get_devices()) {
+        if (!dev->has_role(selected_role) || !dev->online) continue;
+        
+        if (!sampler.open(dev->path) || !sampler.has_axis(selected_axis)) {
+            sampler.close();
             break;
         }
+        status_message.clear();
+        sampler_stop = false;
+        sampler_lost = false;
+        sampler_thread = std::thread(&CalibrationWizard::sampler_loop, this);
+        return true;
+    }
+    
+    status_message = "Cannot read axis from the " + selected_role + " device";
+    needs_redraw = true;
+    return false;
+}
+
+void CalibrationWizard::stop_sampler() {
+    if (sampler_thread.joinable()) {
+        sampler_stop = true;
+        sampler.wake();
+        sampler_thread.join();
     }
+    sampler.close();
+}
+
+void CalibrationWizard::sampler_loop() {
+    while (!sampler_stop.load(std::memory_order_relaxed)) {
+        if (!sampler.wait(-1)) continue;
+        
+        std::lock_guard<std::mutex> lock(sampler_mutex);
+        if (!sampler.read_events()) {
+            sampler_lost = true;
+            return;
+        }
+    }
+}
+
+AxisStats CalibrationWizard::sampled_stats() {
+    if (!sampler.is_open()) return AxisStats{};
+    
+    if (sampler_lost) {
+        status_message = "Device disconnected during sampling";
+    }
+    std::lock_guard<std::mutex> lock(sampler_mutex);
+    return sampler.stats(selected_axis);
 }
 
 void CalibrationWizard::finish_center_sampling() {
-    // Calculate center from samples
-    if (!center_samples.empty()) {
-        long long sum = 0;
-        for (int v : center_samples) sum += v;
-        current_calibration.center_value = static_cast<int>(sum / center_samples.size());
+    AxisStats stats = sampled_stats();
+    stop_sampler();
+    
+    // Center from the densest part of the samples; deadzone covers the resting noise
+    if (stats.count() > 0) {
+        current_calibration.center_value = stats.center();
         current_calibration.src_code = selected_axis;
-        
-        // Calculate deadzone from variance
-        int min_sample = *std::min_element(center_samples.begin(), center_samples.end());
-        int max_sample = *std::max_element(center_samples.begin(), center_samples.end());
-        current_calibration.deadzone_radius = (max_sample - min_sample) / 2 + 10;
+        current_calibration.deadzone_radius = (stats.max() - stats.min()) / 2 + 10;
     }
     
     state = State::READY_RANGE;
@@ -595,10 +628,21 @@ void CalibrationWizard::finish_center_sampling() {
 }
 
 void CalibrationWizard::finish_range_sampling() {
-    // Calculate range from samples
-    if (!range_samples.empty()) {
-        current_calibration.observed_min = *std::min_element(range_samples.begin(), range_samples.end());
-        current_calibration.observed_max = *std::max_element(range_samples.begin(), range_samples.end());
+    AxisStats stats = sampled_stats();
+    stop_sampler();
+    
+    // Skipping from the ready screen keeps the current range; a sample must have seen the axis move
+    bool sampled = state == State::RANGE_SAMPLE;
+    if (sampled && (stats.count() < MIN_RANGE_SAMPLES || stats.max() <= stats.min())) {
+        status_message = "Only " + std::to_string(stats.count()) +
+                         " samples, axis did not move. Is another program grabbing the device?";
+        state = State::READY_RANGE;
+        needs_redraw = true;
+        return;
+    }
+    if (stats.count() > 0) {
+        current_calibration.observed_min = stats.min();
+        current_calibration.observed_max = stats.max();
     }
     
     state = State::REVIEW;
@@ -613,3 +657,10 @@ void CalibrationWizard::save_calibration() {
     std::string config_path = get_config_path();
     ConfigManager::save(config_path, config);
 }
+
+void CalibrationWizard::restart_mapper() {
+    if (mapper_stopped) {
+        start_mapper_service();
+        mapper_stopped = false;
+    }
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "tui.hpp"
+#include "axis_sampler.hpp"
+#include <atomic>
+#include <mutex>
 
 class CalibrationWizard : public View {
 private:
@@ -20,16 +23,29 @@ private:
     std::string selected_role;
     int selected_axis;
     AxisCalibration current_calibration;
-    std::vector<int> center_samples;
-    std::vector<int> range_samples;
     std::chrono::steady_clock::time_point sample_start;
     int sample_duration_ms;
     std::string status_message;
     
+    // The sampler thread blocks on the device and feeds every event; the UI
+    // thread copies the selected axis's stats under the mutex to draw them
+    AxisSampler sampler;
+    std::mutex sampler_mutex;
+    std::thread sampler_thread;
+    std::atomic<bool> sampler_stop;
+    std::atomic<bool> sampler_lost;
+    // Set while the wizard has the mapper stopped so it doesn't hold the device grabbed
+    bool mapper_stopped;
+    
+    // A full sweep yields hundreds; fewer means the axis didn't move or another
+    // process grabbed the device and the sampler never saw its events
+    static constexpr uint64_t MIN_RANGE_SAMPLES = 20;
+    
     std::vector<CalibItem> get_calibration_items();
     
 public:
     CalibrationWizard(TUI* parent);
+    ~CalibrationWizard();
     
     void reset_calibration();
     void draw() override;
@@ -54,8 +70,12 @@ private:
     void start_calibration();
     void start_center_sampling();
     void start_range_sampling();
-    void sample_axis_value();
+    bool start_sampler();
+    void stop_sampler();
+    AxisStats sampled_stats();
+    void sampler_loop();
     void finish_center_sampling();
     void finish_range_sampling();
     void save_calibration();
+    void restart_mapper();
 };
@@ -1,4 +1,16 @@
 #include "live_monitor.hpp"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <cerrno>
+
+// Telemetry is published without waking anyone; poll at about twice the redraw rate
+static constexpr int TELEMETRY_POLL_MS = 16;
+
+static int bar_position(int value, int minimum, int maximum, int bar_width) {
+    if (maximum <= minimum) return 0;
+    float percent = std::clamp(static_cast<float>(value - minimum) / (maximum - minimum), 0.0f, 1.0f);
+    return std::clamp(static_cast<int>(bar_width * percent), 0, bar_width);
+}
 
 bool LiveMonitor::is_monitored(const std::shared_ptr<DeviceInfo>& dev) {
     return dev->online && dev->dev && !dev->roles.empty();
@@ -34,77 +46,93 @@ std::string LiveMonitor::friendly_button_name(const std::string& role, int btn)
 }
 
 void LiveMonitor::draw_axes_panel(Window* win, int start_col, int panel_width, int start_row, int max_row) {
-    auto& devices = tui->get_devices();
-    
-    int label_width = std::max(14, (panel_width - 12) * 40 / 100);
+    int label_width = std::max(14, (panel_width - 19) * 40 / 100);
     int col_bar = start_col + label_width;
-    int bar_width = std::max(10, panel_width - label_width - 10);
+    int bar_width = std::max(10, panel_width - label_width - 17);
     int col_value = col_bar + bar_width + 1;
     
     win->print(start_row - 1, start_col - 2, "Axes", A_BOLD | A_UNDERLINE);
     int row = start_row;
     
-    for (const auto& dev : devices) {
-        if (!is_monitored(dev) || dev->axes.empty()) continue;
+    for (const auto& device : monitored) {
+        if (device->axes.empty()) continue;
+        const auto& dev = device->info;
         
         win->print(row++, start_col - 2, (get_role_icons(dev->roles) + " " + dev->roles_str() + ":").c_str(),
-                   COLOR_PAIR(CP_HEADER));
+                   COLOR_PAIR(device->online ? CP_HEADER : CP_OFFLINE));
         
-        for (int axis : dev->axes) {
+        for (const auto& axis : device->axes) {
             if (row >= max_row) break;
             
-            struct input_absinfo absinfo_buf;
-            if (dev->fd >= 0 && ioctl(dev->fd, EVIOCGABS(axis), &absinfo_buf) == 0) {
-                int value = absinfo_buf.value;
-                
-                // Apply invert/scale from active bindings so monitor matches mapper output
-                for (const auto& role : dev->roles) {
-                    auto active_abs = tui->get_config().get_active_bindings_abs();
-                    for (const auto& ab : active_abs) {
-                        if (ab.role == role && ab.src == axis) {
-                            if (ab.invert) {
-                                value = absinfo_buf.maximum + absinfo_buf.minimum - value;
-                            }
-                            break;
-                        }
-                    }
-                    break; // use first role
-                }
-                
-                last_values[dev->roles_str() + "." + std::to_string(axis)] = value;
-                
-                const char* name = libevdev_event_code_get_name(EV_ABS, axis);
-                std::string axis_name = name ? name : ("ABS_" + std::to_string(axis));
-                if (static_cast<int>(axis_name.length()) > label_width - 2)
-                    axis_name = axis_name.substr(0, label_width - 5) + "...";
-                
-                mvwprintw(win->get(), row, start_col, "%-*s", label_width, axis_name.c_str());
-                
-                float percent = 0.0f;
-                if (absinfo_buf.maximum > absinfo_buf.minimum) {
-                    percent = std::clamp(static_cast<float>(value - absinfo_buf.minimum) /
-                                         (absinfo_buf.maximum - absinfo_buf.minimum), 0.0f, 1.0f);
-                }
-                
-                int filled = std::clamp(static_cast<int>(bar_width * percent), 0, bar_width);
-                std::string bar(filled, '#');
-                bar += std::string(bar_width - filled, '-');
-                
-                wattron(win->get(), COLOR_PAIR(CP_AXIS));
-                mvwprintw(win->get(), row, col_bar, "%s", bar.c_str());
-                wattroff(win->get(), COLOR_PAIR(CP_AXIS));
-                
-                mvwprintw(win->get(), row, col_value, "%6d", value);
-                row++;
-            }
+            int value = axis.value.load(std::memory_order_relaxed);
+            
+            const char* name = libevdev_event_code_get_name(EV_ABS, axis.code);
+            std::string axis_name = name ? name : ("ABS_" + std::to_string(axis.code));
+            if (static_cast<int>(axis_name.length()) > label_width - 2)
+                axis_name = axis_name.substr(0, label_width - 5) + "...";
+            
+            mvwprintw(win->get(), row, start_col, "%-*s", label_width, axis_name.c_str());
+            
+            auto bar_pos = [&](int v) { return bar_position(v, axis.minimum, axis.maximum, bar_width); };
+            
+            int filled = bar_pos(value);
+            std::string bar(filled, '#');
+            bar += std::string(bar_width - filled, '-');
+            
+            // Mark the travel seen since monitoring started
+            int min_pos = std::min(bar_pos(axis.observed_min.load(std::memory_order_relaxed)), bar_width - 1);
+            int max_pos = std::min(bar_pos(axis.observed_max.load(std::memory_order_relaxed)), bar_width - 1);
+            bar[min_pos] = '[';
+            bar[max_pos] = ']';
+            
+            wattron(win->get(), COLOR_PAIR(CP_AXIS));
+            mvwprintw(win->get(), row, col_bar, "%s", bar.c_str());
+            wattroff(win->get(), COLOR_PAIR(CP_AXIS));
+            
+            mvwprintw(win->get(), row, col_value, "%6d %5u/s", value, axis.rate.load(std::memory_order_relaxed));
+            row++;
         }
         row++;
     }
+    
+    if (telemetry_mode) {
+        draw_virtual_axes(win, start_col, label_width, bar_width, row, max_row);
+    }
 }
 
-void LiveMonitor::draw_buttons_panel(Window* win, int start_col, int panel_width, int start_row, int max_row) {
-    auto& devices = tui->get_devices();
+int LiveMonitor::draw_virtual_axes(Window* win, int start_col, int label_width, int bar_width, int row, int max_row) {
+    if (row >= max_row) return row;
+    win->print(row++, start_col - 2, "Mapper output:", COLOR_PAIR(CP_HEADER));
     
+    for (int i = 0; i < VIRTUAL_AXIS_COUNT && row < max_row; i++) {
+        uint16_t code = VIRTUAL_AXIS_CODES[i];
+        int minimum = -32768, maximum = 32767;
+        if (code == ABS_Z || code == ABS_RZ) {
+            minimum = 0;
+            maximum = 255;
+        } else if (code == ABS_HAT0X || code == ABS_HAT0Y) {
+            minimum = -1;
+            maximum = 1;
+        }
+        int value = virtual_state.axes[i].load(std::memory_order_relaxed);
+        
+        const char* name = libevdev_event_code_get_name(EV_ABS, code);
+        mvwprintw(win->get(), row, start_col, "%-*s", label_width, name ? name : "?");
+        
+        int filled = bar_position(value, minimum, maximum, bar_width);
+        std::string bar(filled, '#');
+        bar += std::string(bar_width - filled, '-');
+        wattron(win->get(), COLOR_PAIR(CP_AXIS));
+        mvwprintw(win->get(), row, start_col + label_width, "%s", bar.c_str());
+        wattroff(win->get(), COLOR_PAIR(CP_AXIS));
+        
+        mvwprintw(win->get(), row, start_col + label_width + bar_width + 1, "%6d", value);
+        row++;
+    }
+    return row;
+}
+
+void LiveMonitor::draw_buttons_panel(Window* win, int start_col, int panel_width, int start_row, int max_row) {
     const int state_width = 9; // "[PRESSED]"
     // Cap usable width so dots don't stretch on wide terminals
     int usable = std::min(panel_width, 40);
@@ -115,16 +143,12 @@ void LiveMonitor::draw_buttons_panel(Window* win, int start_col, int panel_width
     win->print(start_row - 1, start_col - 1, "Buttons", A_BOLD | A_UNDERLINE);
     int row = start_row;
     
-    unsigned char key_state[KEY_MAX / 8 + 1];
-    
-    for (const auto& dev : devices) {
-        if (!is_monitored(dev) || dev->buttons.empty()) continue;
+    for (const auto& device : monitored) {
+        const auto& dev = device->info;
+        if (dev->buttons.empty()) continue;
         
         win->print(row++, start_col - 1, (get_role_icons(dev->roles) + " " + dev->roles_str() + ":").c_str(),
-                   COLOR_PAIR(CP_HEADER));
-        
-        memset(key_state, 0, sizeof(key_state));
-        bool have_state = (dev->fd >= 0 && ioctl(dev->fd, EVIOCGKEY(sizeof(key_state)), key_state) >= 0);
+                   COLOR_PAIR(device->online ? CP_HEADER : CP_OFFLINE));
         
         for (int btn : dev->buttons) {
             if (row >= max_row) break;
@@ -135,7 +159,7 @@ void LiveMonitor::draw_buttons_panel(Window* win, int start_col, int panel_width
                 btn_name = btn_name.substr(0, name_max - 5) + "...";
             blen = static_cast<int>(btn_name.length());
             
-            bool pressed = have_state && (key_state[btn / 8] & (1 << (btn % 8)));
+            bool pressed = btn < KEY_CNT && device->key_pressed(btn);
             
             // Name
             mvwprintw(win->get(), row, start_col, "%s", btn_name.c_str());
@@ -164,15 +188,49 @@ void LiveMonitor::draw_buttons_panel(Window* win, int start_col, int panel_width
         }
         row++;
     }
+    
+    if (telemetry_mode) {
+        draw_virtual_buttons(win, start_col, col_state, row, max_row);
+    }
 }
 
-LiveMonitor::LiveMonitor(TUI* parent) : View(parent, ViewType::MONITOR), monitoring(false) {}
+int LiveMonitor::draw_virtual_buttons(Window* win, int start_col, int col_state, int row, int max_row) {
+    if (row >= max_row) return row;
+    win->print(row++, start_col - 1, "Mapper output:", COLOR_PAIR(CP_HEADER));
+    
+    uint32_t buttons = virtual_state.buttons.load(std::memory_order_relaxed);
+    for (int i = 0; i < VIRTUAL_BUTTON_COUNT && row < max_row; i++) {
+        const char* name = libevdev_event_code_get_name(EV_KEY, VIRTUAL_BUTTON_CODES[i]);
+        mvwprintw(win->get(), row, start_col, "%s", name ? name : "?");
+        
+        if (buttons & (1u << i)) {
+            wattron(win->get(), COLOR_PAIR(CP_ONLINE) | A_BOLD);
+            mvwprintw(win->get(), row, col_state, "[PRESSED]");
+            wattroff(win->get(), COLOR_PAIR(CP_ONLINE) | A_BOLD);
+        } else {
+            wattron(win->get(), A_DIM);
+            mvwprintw(win->get(), row, col_state, "    -    ");
+            wattroff(win->get(), A_DIM);
+        }
+        row++;
+    }
+    return row;
+}
+
+LiveMonitor::LiveMonitor(TUI* parent)
+    : View(parent, ViewType::MONITOR), monitoring(false), telemetry_mode(false), epoll_fd(-1), wake_fd(-1),
+      stop_requested(false), generation(0), drawn_generation(0) {}
 
 LiveMonitor::~LiveMonitor() {
     stop_monitoring();
 }
 
 void LiveMonitor::draw() {
+    // Redraw only when the reader thread published something new (or the view asked)
+    uint64_t current_generation = generation.load(std::memory_order_acquire);
+    if (!needs_redraw && current_generation == drawn_generation) return;
+    drawn_generation = current_generation;
+    
     auto* main_win = tui->get_main_win();
     int height = main_win->get_height();
     int width = main_win->get_width();
@@ -186,6 +244,9 @@ void LiveMonitor::draw() {
         wattron(main_win->get(), COLOR_PAIR(CP_ONLINE));
         wprintw(main_win->get(), "MONITORING");
         wattroff(main_win->get(), COLOR_PAIR(CP_ONLINE));
+        if (telemetry_mode) {
+            wprintw(main_win->get(), telemetry.writer_alive() ? "  (via twcs_mapper)" : "  (twcs_mapper stopped)");
+        }
         
         int divider = width / 2;
         int max_row = height - 4;
@@ -209,7 +270,7 @@ void LiveMonitor::draw() {
     main_win->print(height - 2, 2, monitoring ? "[SPACE] Stop  [r] Refresh" : "[SPACE] Start", A_DIM);
     
     main_win->refresh();
-    needs_redraw = true;
+    needs_redraw = false;
 }
 
 void LiveMonitor::handle_input(int ch) {
@@ -230,10 +291,347 @@ void LiveMonitor::handle_input(int ch) {
     }
 }
 
+bool LiveMonitor::open_device(const std::shared_ptr<DeviceInfo>& dev, const std::vector<BindingConfigAbs>& active_abs,
+                              int telemetry_source) {
+    int fd = open(dev->path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return false;
+    
+    auto device = std::make_unique<DeviceState>();
+    device->info = dev;
+    device->fd = fd;
+    device->telemetry_source = telemetry_source;
+    device->axis_slots.fill(-1);
+    device->axes = std::vector<AxisState>(dev->axes.size());
+    
+    for (size_t i = 0; i < dev->axes.size(); i++) {
+        AxisState& axis = device->axes[i];
+        axis.code = dev->axes[i];
+        if (axis.code < 0 || axis.code >= ABS_CNT) continue;
+        device->axis_slots[axis.code] = static_cast<int16_t>(i);
+        
+        struct input_absinfo absinfo_buf;
+        if (ioctl(fd, EVIOCGABS(axis.code), &absinfo_buf) == 0) {
+            axis.minimum = absinfo_buf.minimum;
+            axis.maximum = absinfo_buf.maximum;
+        }
+        
+        // Apply invert from the first role's binding so the monitor matches mapper output
+        if (!dev->roles.empty()) {
+            for (const auto& ab : active_abs) {
+                if (ab.role == dev->roles[0] && ab.src == axis.code) {
+                    axis.invert = ab.invert;
+                    break;
+                }
+            }
+        }
+    }
+    
+    read_current_state(*device);
+    for (auto& axis : device->axes) {
+        int value = axis.value.load(std::memory_order_relaxed);
+        axis.observed_min.store(value, std::memory_order_relaxed);
+        axis.observed_max.store(value, std::memory_order_relaxed);
+    }
+    
+    // With telemetry the fd was only needed for the axis ranges and initial state
+    if (telemetry_source >= 0) {
+        close(fd);
+        device->fd = -1;
+        monitored.push_back(std::move(device));
+        return true;
+    }
+    
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = device.get();
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        close(fd);
+        return false;
+    }
+    
+    monitored.push_back(std::move(device));
+    return true;
+}
+
+void LiveMonitor::read_current_state(DeviceState& device) {
+    for (auto& axis : device.axes) {
+        struct input_absinfo absinfo_buf;
+        if (ioctl(device.fd, EVIOCGABS(axis.code), &absinfo_buf) == 0) {
+            int value = axis.invert ? axis.maximum + axis.minimum - absinfo_buf.value : absinfo_buf.value;
+            axis.value.store(value, std::memory_order_relaxed);
+        }
+    }
+    
+    unsigned char key_state[KEY_MAX / 8 + 1];
+    memset(key_state, 0, sizeof(key_state));
+    if (ioctl(device.fd, EVIOCGKEY(sizeof(key_state)), key_state) < 0) return;
+    for (size_t word = 0; word < device.keys.size(); word++) {
+        uint64_t bits = 0;
+        for (int bit = 0; bit < 64; bit++) {
+            int code = static_cast<int>(word * 64) + bit;
+            if (code < KEY_CNT && (key_state[code / 8] & (1 << (code % 8)))) bits |= 1ull << bit;
+        }
+        device.keys[word].store(bits, std::memory_order_relaxed);
+    }
+}
+
+// Drains one device; returns false once it is gone
+bool LiveMonitor::read_events(DeviceState& device) {
+    struct input_event events[64];
+    bool changed = false;
+    
+    while (true) {
+        ssize_t bytes = read(device.fd, events, sizeof(events));
+        if (bytes < 0 && errno == EINTR) continue;
+        if (bytes < 0 && errno == EAGAIN) break;
+        if (bytes <= 0) return false;
+        
+        size_t count = static_cast<size_t>(bytes) / sizeof(struct input_event);
+        for (size_t i = 0; i < count; i++) {
+            const struct input_event& ev = events[i];
+            
+            if (ev.type == EV_ABS && ev.code < ABS_CNT && device.axis_slots[ev.code] >= 0) {
+                AxisState& axis = device.axes[device.axis_slots[ev.code]];
+                int value = axis.invert ? axis.maximum + axis.minimum - ev.value : ev.value;
+                axis.value.store(value, std::memory_order_relaxed);
+                if (value < axis.observed_min.load(std::memory_order_relaxed)) {
+                    axis.observed_min.store(value, std::memory_order_relaxed);
+                }
+                if (value > axis.observed_max.load(std::memory_order_relaxed)) {
+                    axis.observed_max.store(value, std::memory_order_relaxed);
+                }
+                axis.events++;
+                changed = true;
+            } else if (ev.type == EV_KEY && ev.code < KEY_CNT) {
+                uint64_t mask = 1ull << (ev.code % 64);
+                if (ev.value) {
+                    device.keys[ev.code / 64].fetch_or(mask, std::memory_order_relaxed);
+                } else {
+                    device.keys[ev.code / 64].fetch_and(~mask, std::memory_order_relaxed);
+                }
+                changed = true;
+            } else if (ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+                // Buffer overflowed; the kernel's current state replaces what was lost
+                read_current_state(device);
+                changed = true;
+            }
+        }
+    }
+    
+    if (changed) {
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    return true;
+}
+
+void LiveMonitor::monitor_loop() {
+    auto last_rate_update = std::chrono::steady_clock::now();
+    
+    while (!stop_requested.load(std::memory_order_relaxed)) {
+        struct epoll_event events[8];
+        int nfds = epoll_wait(epoll_fd, events, 8, 1000);
+        if (nfds < 0 && errno != EINTR) break;
+        
+        for (int i = 0; i < nfds; i++) {
+            if (events[i].data.ptr == nullptr) continue;  // wake_fd
+            
+            auto* device = static_cast<DeviceState*>(events[i].data.ptr);
+            if (!read_events(*device)) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, device->fd, nullptr);
+                device->online.store(false, std::memory_order_relaxed);
+                generation.fetch_add(1, std::memory_order_release);
+            }
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - last_rate_update).count();
+        if (elapsed < 1.0) continue;
+        last_rate_update = now;
+        
+        if (update_axis_rates(elapsed)) {
+            generation.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
+// Returns true if any displayed rate changed
+bool LiveMonitor::update_axis_rates(double elapsed) {
+    bool rates_changed = false;
+    for (auto& device : monitored) {
+        for (auto& axis : device->axes) {
+            uint32_t rate = static_cast<uint32_t>(axis.events / elapsed + 0.5);
+            axis.events = 0;
+            if (rate != axis.rate.load(std::memory_order_relaxed)) {
+                axis.rate.store(rate, std::memory_order_relaxed);
+                rates_changed = true;
+            }
+        }
+    }
+    return rates_changed;
+}
+
+// Copies one mapper frame into the displayed state; returns true if anything changed.
+// Axis rates here count value changes between polled frames, not raw events.
+bool LiveMonitor::apply_telemetry(const TelemetryFrame& frame) {
+    bool changed = false;
+    
+    for (auto& device : monitored) {
+        if (device->telemetry_source < 0) continue;
+        const TelemetrySource& source = frame.sources[device->telemetry_source];
+        
+        bool online = source.online != 0;
+        if (online != device->online.load(std::memory_order_relaxed)) {
+            device->online.store(online, std::memory_order_relaxed);
+            changed = true;
+        }
+        
+        for (auto& axis : device->axes) {
+            int value = axis.invert ? axis.maximum + axis.minimum - source.abs[axis.code] : source.abs[axis.code];
+            if (value == axis.value.load(std::memory_order_relaxed)) continue;
+            axis.value.store(value, std::memory_order_relaxed);
+            if (value < axis.observed_min.load(std::memory_order_relaxed)) {
+                axis.observed_min.store(value, std::memory_order_relaxed);
+            }
+            if (value > axis.observed_max.load(std::memory_order_relaxed)) {
+                axis.observed_max.store(value, std::memory_order_relaxed);
+            }
+            axis.events++;
+            changed = true;
+        }
+        
+        for (size_t word = 0; word < device->keys.size(); word++) {
+            if (source.keys[word] != device->keys[word].load(std::memory_order_relaxed)) {
+                device->keys[word].store(source.keys[word], std::memory_order_relaxed);
+                changed = true;
+            }
+        }
+    }
+    
+    for (int i = 0; i < VIRTUAL_AXIS_COUNT; i++) {
+        if (frame.virtual_axes[i] != virtual_state.axes[i].load(std::memory_order_relaxed)) {
+            virtual_state.axes[i].store(frame.virtual_axes[i], std::memory_order_relaxed);
+            changed = true;
+        }
+    }
+    uint32_t buttons = 0;
+    for (int i = 0; i < VIRTUAL_BUTTON_COUNT; i++) {
+        if (frame.virtual_buttons[i]) buttons |= 1u << i;
+    }
+    if (buttons != virtual_state.buttons.load(std::memory_order_relaxed)) {
+        virtual_state.buttons.store(buttons, std::memory_order_relaxed);
+        changed = true;
+    }
+    return changed;
+}
+
+void LiveMonitor::telemetry_loop() {
+    auto last_rate_update = std::chrono::steady_clock::now();
+    uint64_t seen = 0;
+    bool writer_gone = false;
+    TelemetryFrame frame;
+    
+    while (!stop_requested.load(std::memory_order_relaxed)) {
+        // Only wake_fd is registered; the timeout is the poll interval
+        struct epoll_event events[1];
+        int nfds = epoll_wait(epoll_fd, events, 1, TELEMETRY_POLL_MS);
+        if (nfds < 0 && errno != EINTR) break;
+        
+        uint64_t published = telemetry.published();
+        if (published != seen && telemetry.read(frame)) {
+            seen = published;
+            if (apply_telemetry(frame)) {
+                generation.fetch_add(1, std::memory_order_release);
+            }
+        } else if (!writer_gone && !telemetry.writer_alive()) {
+            // Mapper exited; keep the last frame on screen, shown as offline
+            writer_gone = true;
+            for (auto& device : monitored) {
+                device->online.store(false, std::memory_order_relaxed);
+            }
+            generation.fetch_add(1, std::memory_order_release);
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - last_rate_update).count();
+        if (elapsed < 1.0) continue;
+        last_rate_update = now;
+        
+        if (update_axis_rates(elapsed)) {
+            generation.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
 void LiveMonitor::start_monitoring() {
+    if (monitoring) return;
+    
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0) {
+        stop_monitoring();
+        return;
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+    
+    // A running mapper usually grabs the devices; read its telemetry instead,
+    // which also shows what it actually sends to the game
+    telemetry_mode = telemetry.open() && telemetry.writer_alive();
+    if (!telemetry_mode) {
+        telemetry.close();
+    }
+    
+    // Resolve bindings once for the whole session rather than per axis per redraw
+    auto active_abs = tui->get_config().get_active_bindings_abs();
+    for (const auto& dev : tui->get_devices()) {
+        if (!is_monitored(dev)) continue;
+        
+        int telemetry_source = -1;
+        if (telemetry_mode) {
+            for (size_t source = 0; source < telemetry.source_count(); source++) {
+                if (!dev->by_id.empty() && telemetry.by_id(source) == dev->by_id) {
+                    telemetry_source = static_cast<int>(source);
+                    break;
+                }
+            }
+            // Not driven by this mapper: there is nothing to show for it
+            if (telemetry_source < 0) continue;
+        }
+        open_device(dev, active_abs, telemetry_source);
+    }
+    
+    stop_requested = false;
     monitoring = true;
+    monitor_thread = std::thread(telemetry_mode ? &LiveMonitor::telemetry_loop : &LiveMonitor::monitor_loop, this);
 }
 
 void LiveMonitor::stop_monitoring() {
+    if (monitor_thread.joinable()) {
+        stop_requested = true;
+        // Wake epoll_wait now; without it the loop still notices within a second
+        uint64_t one = 1;
+        ssize_t written = write(wake_fd, &one, sizeof(one));
+        (void)written;
+        monitor_thread.join();
+    }
+    
+    for (auto& device : monitored) {
+        if (device->fd >= 0) close(device->fd);
+    }
+    monitored.clear();
+    if (wake_fd >= 0) {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    telemetry.close();
+    telemetry_mode = false;
     monitoring = false;
 }
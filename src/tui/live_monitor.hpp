@@ -1,18 +1,74 @@
 #pragma once
 
 #include "tui.hpp"
+#include "telemetry.hpp"
+#include <atomic>
 
 class LiveMonitor : public View {
 private:
+    // Published by the reader thread with relaxed atomics (one writer); the
+    // TUI thread reads them while drawing without taking a lock. The reader
+    // either owns device fds or, while the mapper runs, polls its telemetry.
+    struct AxisState {
+        int code = 0;
+        bool invert = false;  // From the active profile, resolved when monitoring starts
+        int minimum = 0;      // Kernel-reported axis range
+        int maximum = 0;
+        std::atomic<int> value{0};
+        std::atomic<int> observed_min{0};
+        std::atomic<int> observed_max{0};
+        std::atomic<uint32_t> rate{0};  // Events per second over the last second
+        uint32_t events = 0;            // Reader thread only
+    };
+    
+    struct DeviceState {
+        std::shared_ptr<DeviceInfo> info;
+        int fd = -1;  // The reader's own fd, so other views' reads aren't affected
+        int telemetry_source = -1;  // Mapper source index in telemetry mode
+        std::atomic<bool> online{true};
+        std::vector<AxisState> axes;
+        std::array<int16_t, ABS_CNT> axis_slots{};  // ABS code -> index into axes, or -1
+        std::array<std::atomic<uint64_t>, (KEY_CNT + 63) / 64> keys{};
+        
+        bool key_pressed(int code) const {
+            return keys[code / 64].load(std::memory_order_relaxed) & (1ull << (code % 64));
+        }
+    };
+    
+    // Virtual controller as written by the mapper (telemetry mode only)
+    struct VirtualState {
+        std::array<std::atomic<int>, VIRTUAL_AXIS_COUNT> axes{};
+        std::atomic<uint32_t> buttons{0};  // Bit per VIRTUAL_BUTTON_CODES entry
+    };
+    
     bool monitoring;
+    bool telemetry_mode;
+    TelemetryReader telemetry;
+    VirtualState virtual_state;
     std::thread monitor_thread;
-    std::map<std::string, int> last_values;
+    std::vector<std::unique_ptr<DeviceState>> monitored;
+    int epoll_fd;
+    int wake_fd;
+    std::atomic<bool> stop_requested;
+    std::atomic<uint64_t> generation;  // Bumped whenever published state changes
+    uint64_t drawn_generation;
     
     static bool is_monitored(const std::shared_ptr<DeviceInfo>& dev);
     static std::string friendly_button_name(const std::string& role, int btn);
     void draw_axes_panel(Window* win, int start_col, int panel_width, int start_row, int max_row);
     void draw_buttons_panel(Window* win, int start_col, int panel_width, int start_row, int max_row);
+    int draw_virtual_axes(Window* win, int start_col, int label_width, int bar_width, int row, int max_row);
+    int draw_virtual_buttons(Window* win, int start_col, int col_state, int row, int max_row);
     
+    bool open_device(const std::shared_ptr<DeviceInfo>& dev, const std::vector<BindingConfigAbs>& active_abs,
+                     int telemetry_source);
+    void read_current_state(DeviceState& device);
+    bool read_events(DeviceState& device);
+    bool apply_telemetry(const TelemetryFrame& frame);
+    bool update_axis_rates(double elapsed);
+    void monitor_loop();
+    void telemetry_loop();
+
 public:
     LiveMonitor(TUI* parent);
     ~LiveMonitor();
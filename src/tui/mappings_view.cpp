@@ -1,4 +1,5 @@
 #include "mappings_view.hpp"
+#include <cmath>
 
 int MappingsView::count_sources(int code, SrcKind kind) {
     int count = 0;
@@ -150,12 +151,20 @@ void MappingsView::draw() {
                 // Settings (only for single-source axis bindings)
                 if (drow.alt_code == -1 && drow.virtual_kind == SrcKind::Abs && drow.source_count == 1) {
                     std::string info;
-                    if (bd->invert) info += "Inverted";
-                    if (bd->scale != 1.0f) {
+                    auto add_info = [&info](const std::string& item) {
                         if (!info.empty()) info += ", ";
-                        std::ostringstream ss;
-                        ss << "Scale: " << bd->scale << "x";
-                        info += ss.str();
+                        info += item;
+                    };
+                    if (bd->invert) add_info("Inverted");
+                    if (bd->deadzone > 0) add_info("DZ " + std::to_string(bd->deadzone) + "%");
+                    std::ostringstream ss;
+                    ss << std::setprecision(2);
+                    if (bd->expo > 0.0f) { ss.str(""); ss << "Expo " << bd->expo; add_info(ss.str()); }
+                    if (bd->s_curve > 0.0f) { ss.str(""); ss << "S " << bd->s_curve; add_info(ss.str()); }
+                    if (bd->scale != 1.0f) { ss.str(""); ss << "Scale: " << bd->scale << "x"; add_info(ss.str()); }
+                    if (bd->smoothing > 0.0f) { ss.str(""); ss << "Smooth " << bd->smoothing; add_info(ss.str()); }
+                    if (static_cast<int>(info.length()) > width - col_xform - 2) {
+                        info = info.substr(0, std::max(0, width - col_xform - 5)) + "...";
                     }
                     mvwprintw(main_win->get(), row, col_xform, "%s", info.c_str());
                 }
@@ -882,51 +891,139 @@ void MappingsView::show_edit_binding_dialog() {
     }
     if (!target) return;
     
-    // Edit dialog with fields
-    int h = 14, w = 50;
+    // Edit dialog with fields and a preview of the compiled response
+    int h = 24, w = 60;
     int starty = (tui->get_screen_height() - h) / 2;
     int startx = (tui->get_screen_width() - w) / 2;
     
-    int field = 0; // 0=invert, 1=scale
+    // Live input comes from the mapper's telemetry while it runs, else from the device
+    TelemetryReader telemetry;
+    telemetry.open();
+    
+    const int field_count = 6;
+    int field = 0; // 0=invert, 1=deadzone, 2=expo, 3=s-curve, 4=scale, 5=smoothing
     
     while (true) {
-        Window dialog(h, w, starty, startx, " Edit Axis Transform ");
+        Window dialog(h, w, starty, startx, " Edit Axis Response ");
         
         std::string slot_name = get_slot_name(target->dst, SrcKind::Abs);
         dialog.print(2, 2, "Slot: " + slot_name, COLOR_PAIR(CP_HEADER));
         dialog.print(3, 2, "Source: " + target->role + ".ABS_" + std::to_string(target->src));
         
-        int attr0 = (field == 0) ? COLOR_PAIR(CP_SELECTED) : 0;
-        int attr1 = (field == 1) ? COLOR_PAIR(CP_SELECTED) : 0;
-        
-        dialog.print(5, 2, "Invert:   " + std::string(target->invert ? "YES" : "NO "), attr0);
+        char buf[6][48];
+        snprintf(buf[0], sizeof(buf[0]), "Invert:     %s", target->invert ? "YES" : "NO ");
+        snprintf(buf[1], sizeof(buf[1]), "Deadzone:   %d%%", target->deadzone);
+        snprintf(buf[2], sizeof(buf[2]), "Expo:       %.2f", target->expo);
+        snprintf(buf[3], sizeof(buf[3]), "S-curve:    %.2f", target->s_curve);
+        snprintf(buf[4], sizeof(buf[4]), "Scale:      %.2f", target->scale);
+        snprintf(buf[5], sizeof(buf[5]), "Smoothing:  %.2f", target->smoothing);
+        for (int i = 0; i < field_count; i++) {
+            dialog.print(5 + i, 2, buf[i], (field == i) ? COLOR_PAIR(CP_SELECTED) : 0);
+        }
         
-        char scale_buf[32];
-        snprintf(scale_buf, sizeof(scale_buf), "%.2f", target->scale);
-        dialog.print(6, 2, "Scale:    " + std::string(scale_buf), attr1);
+        draw_response_preview(dialog, 12, 8, *target, read_live_axis(target->role, target->src, telemetry));
         
-        dialog.print(8, 2, "[Up/Down] Select  [+/-] Adjust  [ESC] Done", A_DIM);
+        dialog.print(h - 2, 2, "[Up/Down] Select  [+/-] Adjust  [ESC] Done", A_DIM);
         
         dialog.refresh();
         
         int ch = getch();
         if (ch == 27) break;
         if (ch == KEY_UP || ch == 'k') { if (field > 0) field--; }
-        if (ch == KEY_DOWN || ch == 'j') { if (field < 1) field++; }
-        if (ch == '+' || ch == '=' || ch == '\n' || ch == '\r' || ch == KEY_ENTER) {
-            if (field == 0) { target->invert = !target->invert; tui->mark_modified(); }
-            if (field == 1) { target->scale += 0.1f; tui->mark_modified(); }
-        }
-        if (ch == '-') {
-            if (field == 0) { target->invert = !target->invert; tui->mark_modified(); }
-            if (field == 1) { target->scale = std::max(0.1f, target->scale - 0.1f); tui->mark_modified(); }
+        if (ch == KEY_DOWN || ch == 'j') { if (field < field_count - 1) field++; }
+        
+        int step = 0;
+        if (ch == '+' || ch == '=' || ch == '\n' || ch == '\r' || ch == KEY_ENTER) step = 1;
+        if (ch == '-') step = -1;
+        if (step == 0) continue;
+        
+        auto adjust = [step](float value, float amount, float lo, float hi) {
+            return std::clamp(std::round((value + step * amount) * 100.0f) / 100.0f, lo, hi);
+        };
+        switch (field) {
+            case 0: target->invert = !target->invert; break;
+            case 1: target->deadzone = std::clamp(target->deadzone + step, 0, 50); break;
+            case 2: target->expo = adjust(target->expo, 0.05f, 0.0f, 1.0f); break;
+            case 3: target->s_curve = adjust(target->s_curve, 0.05f, 0.0f, 1.0f); break;
+            case 4: target->scale = adjust(target->scale, 0.1f, 0.1f, 5.0f); break;
+            case 5: target->smoothing = adjust(target->smoothing, 0.05f, 0.0f, 0.95f); break;
         }
+        tui->mark_modified();
     }
     
     tui->refresh_bindings();
     needs_redraw = true;
 }
 
+std::optional<int> MappingsView::read_live_axis(const std::string& role, int code, TelemetryReader& telemetry) {
+    for (const auto& dev : tui->get_devices()) {
+        if (!dev->has_role(role)) continue;
+        
+        if (telemetry.is_open() && telemetry.writer_alive()) {
+            TelemetryFrame frame;
+            for (size_t source = 0; source < telemetry.source_count(); source++) {
+                if (!dev->by_id.empty() && telemetry.by_id(source) == dev->by_id && telemetry.read(frame) &&
+                    frame.sources[source].online && code >= 0 && code < ABS_CNT) {
+                    return frame.sources[source].abs[code];
+                }
+            }
+        }
+        if (dev->dev && libevdev_has_event_code(dev->dev, EV_ABS, code)) {
+            struct input_event ev;
+            while (libevdev_next_event(dev->dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {}
+            return libevdev_get_event_value(dev->dev, EV_ABS, code);
+        }
+    }
+    return std::nullopt;
+}
+
+// Plots output against input through the same compiled resolver the mapper
+// runs (calibration, then the response stages), over the calibrated range
+void MappingsView::draw_response_preview(Window& dialog, int start_row, int rows, const BindingConfigAbs& binding,
+                                         std::optional<int> live_input) {
+    auto bindings = make_bindings_from_config({}, {binding});
+    if (bindings.empty()) return;
+    
+    BindingResolver resolver(bindings);
+    PhysicalInput input = bindings[0].src;
+    int in_lo = 0, in_hi = 65535;
+    if (auto cal = tui->get_config().get_calibration(binding.role, binding.src)) {
+        resolver.set_calibration(input.role, binding.src, *cal);
+        in_lo = cal->observed_min;
+        in_hi = std::max(cal->observed_max, in_lo + 1);
+    }
+    int out_lo = bindings[0].xform.min_out;
+    int out_hi = std::max(bindings[0].xform.max_out, out_lo + 1);
+    
+    int cols = std::min(48, dialog.get_width() - 8);
+    auto input_at = [&](int col) { return in_lo + static_cast<int>(static_cast<int64_t>(in_hi - in_lo) * col / (cols - 1)); };
+    auto row_of = [&](int output) {
+        int row = static_cast<int>(static_cast<int64_t>(output - out_lo) * (rows - 1) / (out_hi - out_lo));
+        return start_row + (rows - 1) - std::clamp(row, 0, rows - 1);
+    };
+    
+    dialog.print(start_row - 1, 2, "Response (input ->, output ^):", A_BOLD);
+    for (int r = 0; r < rows; r++) {
+        dialog.print(start_row + r, 3, "|", A_DIM);
+    }
+    for (int col = 0; col < cols; col++) {
+        int output = resolver.preview_axis(input, input_at(col)).value_or(out_lo);
+        dialog.print(row_of(output), 4 + col, "*", COLOR_PAIR(CP_HEADER));
+    }
+    
+    if (!live_input) {
+        dialog.print(start_row + rows, 2, "Live: (device not available)", A_DIM);
+        return;
+    }
+    int output = resolver.preview_axis(input, *live_input).value_or(out_lo);
+    int col = static_cast<int>(static_cast<int64_t>(std::clamp(*live_input, in_lo, in_hi) - in_lo) * (cols - 1) / (in_hi - in_lo));
+    dialog.print(row_of(output), 4 + col, "@", COLOR_PAIR(CP_SUCCESS) | A_BOLD);
+    
+    char live_buf[64];
+    snprintf(live_buf, sizeof(live_buf), "Live: input %6d -> output %6d", *live_input, output);
+    dialog.print(start_row + rows, 2, live_buf, COLOR_PAIR(CP_SUCCESS));
+}
+
 void MappingsView::show_edit_merged_sources_dialog(const DisplayRow& drow) {
     auto& config = tui->get_config();
     std::string dst_name = drow.display_name;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tui.hpp"
+#include "telemetry.hpp"
 
 class MappingsView : public View {
 private:
@@ -46,5 +47,8 @@ private:
     void show_edit_merged_sources_dialog(const DisplayRow& drow);
     void show_edit_axis_sources_dialog(int dst_code);
     void show_edit_button_sources_dialog(int dst_code);
+    std::optional<int> read_live_axis(const std::string& role, int code, TelemetryReader& telemetry);
+    void draw_response_preview(Window& dialog, int start_row, int rows, const BindingConfigAbs& binding,
+                               std::optional<int> live_input);
     void delete_selected_binding();
 };
@@ -89,8 +89,65 @@ void TUI::save_config() {
 }
 
 void TUI::scan_devices() {
+    // Devices whose node is unchanged keep their DeviceInfo (and open handle)
+    std::map<std::string, std::shared_ptr<DeviceInfo>> previous;
+    for (auto& dev : devices) {
+        if (dev->online && !dev->by_id.empty()) {
+            previous[dev->by_id] = dev;
+        }
+    }
     devices.clear();
     
+    // Configured devices plus everything else under /dev/input/by-id, probed in one pass
+    std::vector<std::string> links;
+    auto add_link = [&links](const std::string& link) {
+        if (!link.empty() && std::find(links.begin(), links.end(), link) == links.end()) {
+            links.push_back(link);
+        }
+    };
+    for (const auto& [role, input] : config.devices) {
+        add_link(input.by_id);
+    }
+    for (const auto& link : DeviceDiscovery::list_event_links()) {
+        add_link(link);
+    }
+    std::map<std::string, ProbedDevice> probed;
+    for (auto& device : discovery.scan(links)) {
+        std::string by_id = device.by_id;
+        probed.emplace(by_id, std::move(device));
+    }
+    
+    // Online DeviceInfo for a link, or nullptr if it couldn't be opened
+    auto attach = [&](const std::string& by_id) -> std::shared_ptr<DeviceInfo> {
+        auto it = probed.find(by_id);
+        if (it == probed.end() || !it->second.ok()) return nullptr;
+        ProbedDevice& probe = it->second;
+        
+        std::shared_ptr<DeviceInfo> dev;
+        auto held = previous.find(by_id);
+        if (!probe.dev && held != previous.end() && held->second->path == probe.path) {
+            dev = held->second;
+            dev->roles.clear();
+        } else {
+            if (!probe.dev && !DeviceDiscovery::open_handle(probe)) return nullptr;
+            dev = std::make_shared<DeviceInfo>();
+            dev->fd = probe.fd;
+            dev->dev = probe.dev;
+            probe.fd = -1;
+            probe.dev = nullptr;
+        }
+        dev->by_id = by_id;
+        dev->path = probe.path;
+        dev->name = probe.name;
+        dev->vendor = probe.vendor;
+        dev->product = probe.product;
+        dev->axes = probe.axes;
+        dev->buttons = probe.buttons;
+        dev->online = true;
+        probed.erase(it);
+        return dev;
+    };
+    
     // Scan from config.devices (new format)
     // Merge entries with the same by_id into one DeviceInfo with multiple roles
     for (const auto& [role, input] : config.devices) {
@@ -113,108 +170,31 @@ void TUI::scan_devices() {
             continue;
         }
         
-        auto dev = std::make_shared<DeviceInfo>();
+        auto dev = attach(input.by_id);
+        if (!dev) {
+            dev = std::make_shared<DeviceInfo>();
+            dev->by_id = input.by_id;
+        }
         dev->roles.push_back(role);
-        dev->by_id = input.by_id;
-        dev->vendor = input.vendor;
-        dev->product = input.product;
+        if (!input.vendor.empty()) dev->vendor = input.vendor;
+        if (!input.product.empty()) dev->product = input.product;
         dev->optional = input.optional;
         
-        // Try to open and validate
-        if (!input.by_id.empty()) {
-            char real_path[PATH_MAX];
-            if (realpath(input.by_id.c_str(), real_path) != nullptr) {
-                int fd = open(real_path, O_RDONLY | O_NONBLOCK);
-                if (fd >= 0) {
-                    struct libevdev* d = nullptr;
-                    if (libevdev_new_from_fd(fd, &d) == 0) {
-                        dev->fd = fd;
-                        dev->dev = d;
-                        dev->path = real_path;
-                        dev->name = libevdev_get_name(d) ? libevdev_get_name(d) : "Unknown";
-                        dev->online = true;
-                        
-                        // Enumerate capabilities
-                        for (int code = 0; code <= ABS_MAX; code++) {
-                            if (libevdev_has_event_code(d, EV_ABS, code)) {
-                                dev->axes.push_back(code);
-                            }
-                        }
-                        for (int code = BTN_JOYSTICK; code < BTN_DIGI; code++) {
-                            if (libevdev_has_event_code(d, EV_KEY, code)) {
-                                dev->buttons.push_back(code);
-                            }
-                        }
-                    } else {
-                        close(fd);
-                    }
-                }
-            }
-        }
-        
         devices.push_back(dev);
     }
     
-    // Also scan /dev/input/by-id for new devices
-    scan_new_devices();
-}
-
-void TUI::scan_new_devices() {
-    DIR* dir = opendir("/dev/input/by-id");
-    if (!dir) return;
-    
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (strstr(entry->d_name, "event") == nullptr) continue;
-        
-        std::string path = std::string("/dev/input/by-id/") + entry->d_name;
-        
-        // Check if already known
-        bool known = false;
-        for (const auto& dev : devices) {
-            if (dev->by_id == path) {
-                known = true;
-                break;
-            }
-        }
-        
-        if (!known) {
-            // Add as unassigned device for user to configure
-            auto dev = std::make_shared<DeviceInfo>();
-            dev->by_id = path;
-            
-            char real_path[PATH_MAX];
-            if (realpath(path.c_str(), real_path) != nullptr) {
-                int fd = open(real_path, O_RDONLY | O_NONBLOCK);
-                if (fd >= 0) {
-                    struct libevdev* d = nullptr;
-                    if (libevdev_new_from_fd(fd, &d) == 0) {
-                        dev->fd = fd;
-                        dev->dev = d;
-                        dev->path = real_path;
-                        dev->name = libevdev_get_name(d) ? libevdev_get_name(d) : "Unknown";
-                        dev->online = true;
-                        
-                        for (int code = 0; code <= ABS_MAX; code++) {
-                            if (libevdev_has_event_code(d, EV_ABS, code)) {
-                                dev->axes.push_back(code);
-                            }
-                        }
-                        for (int code = BTN_JOYSTICK; code < BTN_DIGI; code++) {
-                            if (libevdev_has_event_code(d, EV_KEY, code)) {
-                                dev->buttons.push_back(code);
-                            }
-                        }
-                        
-                        devices.push_back(dev);
-                    } else {
-                        close(fd);
-                    }
-                }
-            }
+    // The rest are unassigned devices for the user to configure
+    for (const auto& link : links) {
+        if (auto dev = attach(link)) {
+            devices.push_back(dev);
         }
     }
-    closedir(dir);
+    
+    // Handles from probes that didn't become a device
+    for (auto& [by_id, probe] : probed) {
+        if (probe.dev) libevdev_free(probe.dev);
+        if (probe.fd >= 0) close(probe.fd);
+    }
 }
 
 void TUI::refresh_bindings() {
@@ -236,6 +216,9 @@ void TUI::refresh_bindings() {
         bd.invert = false;
         bd.deadzone = 0;
         bd.scale = 1.0f;
+        bd.expo = 0.0f;
+        bd.s_curve = 0.0f;
+        bd.smoothing = 0.0f;
         bd.is_valid = true;
         bindings.push_back(bd);
     }
@@ -251,6 +234,9 @@ void TUI::refresh_bindings() {
         bd.invert = abs_binding.invert;
         bd.deadzone = abs_binding.deadzone;
         bd.scale = abs_binding.scale;
+        bd.expo = abs_binding.expo;
+        bd.s_curve = abs_binding.s_curve;
+        bd.smoothing = abs_binding.smoothing;
         bd.is_valid = true;
         bindings.push_back(bd);
     }
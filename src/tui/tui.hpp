@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tui_common.hpp"
+#include "device_discovery.hpp"
 
 // Main TUI class
 class TUI {
@@ -10,6 +11,7 @@ private:
     std::vector<std::unique_ptr<View>> views;
     Config config;
     std::vector<std::shared_ptr<DeviceInfo>> devices;
+    DeviceDiscovery discovery;
     std::vector<BindingDisplay> bindings;
     bool config_modified;
     
@@ -29,7 +31,6 @@ public:
     void save_config();
     void create_views();
     void scan_devices();
-    void scan_new_devices();
     void refresh_bindings();
     void draw_header();
     void draw_status();
@@ -230,6 +230,9 @@ struct BindingDisplay {
     bool invert;
     int deadzone;
     float scale;
+    float expo;
+    float s_curve;
+    float smoothing;
     bool is_valid;
 };
 
@@ -2,6 +2,17 @@
 #include "bindings.hpp"
 #include "virtual_device.hpp"
 #include "epoll_loop.hpp"
+#include "hotplug_monitor.hpp"
+#include "device_identity.hpp"
+#include "startup_cache.hpp"
+#include "trace.hpp"
+#include "latency_stats.hpp"
+#include "event_recorder.hpp"
+#include "realtime.hpp"
+#include "output_scheduler.hpp"
+#include "telemetry.hpp"
+#include "config_watcher.hpp"
+#include "soak_test.hpp"
 #include <linux/input.h>
 #include <linux/input-event-codes.h>
 #include <linux/uinput.h>
@@ -9,7 +20,9 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <signal.h>
+#include <cerrno>
 #include <cstring>
+#include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
 #include <sys/ioctl.h>
@@ -22,36 +35,55 @@
 #include <map>
 #include <vector>
 #include <set>
+#include <bitset>
+#include <memory>
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <poll.h>
+#include <pthread.h>
+#include <span>
+#include <iomanip>
 
 static volatile sig_atomic_t running = 1;
 static volatile sig_atomic_t reload_config = 0;
+static volatile sig_atomic_t dump_stats = 0;
 
 void signal_handler(int sig) {
     if (sig == SIGHUP) {
         reload_config = 1;
+    } else if (sig == SIGUSR1) {
+        dump_stats = 1;
     } else {
         running = 0;
     }
 }
 
-// Device mapping structures
-struct InputDevice {
+// Role per source code for event routing when multiple roles share one device.
+// Stored as Role + 1 so that 0 (the default) means the code is not routed.
+struct DeviceRoutes {
+    std::array<uint8_t, KEY_CNT> keys{};
+    std::array<uint8_t, ABS_CNT> abs{};
+};
+
+// Device mapping structures. The fd/libevdev handle, by-id path
+// (InputSource::by_id) and resolved node (InputSource::resolved_path) live in
+// InputSource so EpollLoop can drive the device directly.
+struct InputDevice : InputSource {
     std::vector<std::string> roles;
-    int fd;
-    struct libevdev* dev;
-    std::string path;
-    std::string by_id_path;
     std::string vendor;
     std::string product;
-    bool optional;
-    bool online;
-    int consecutive_read_failures;
+    bool optional = false;
+    bool online = false;
+    // Reconnect scheduling, owned by housekeeping
     std::chrono::steady_clock::time_point last_reconnect_attempt;
-    int reconnect_backoff_ms;
-    // Map from (kind, code) to role for event routing when multiple roles share one device
-    std::map<std::pair<SrcKind, uint16_t>, std::string> code_to_role;
+    int reconnect_backoff_ms = 500;
+    DeviceRoutes routes;
+    // Latency accounting: LatencyStats source index, and the kernel timestamp of
+    // the oldest input not yet emitted (0 when nothing is pending)
+    size_t stats_source = 0;
+    uint64_t frame_time_us = 0;
 
     bool has_role(const std::string& r) const {
         for (const auto& role : roles) {
@@ -63,6 +95,19 @@ struct InputDevice {
     std::string primary_role() const {
         return roles.empty() ? "unknown" : roles[0];
     }
+
+    // Resolve the role for an incoming event code; false if nothing is bound to it
+    bool route(SrcKind kind, uint16_t code, Role& role) const {
+        uint8_t entry = 0;
+        if (kind == SrcKind::Key) {
+            if (code < KEY_CNT) entry = routes.keys[code];
+        } else {
+            if (code < ABS_CNT) entry = routes.abs[code];
+        }
+        if (entry == 0) return false;
+        role = static_cast<Role>(entry - 1);
+        return true;
+    }
 };
 
 Role string_to_role(const std::string& role_str) {
@@ -72,150 +117,191 @@ Role string_to_role(const std::string& role_str) {
     return Role::Stick; // fallback
 }
 
-std::string get_udev_property(const std::string& device_path, const std::string& property) {
-    std::string cmd = "udevadm info -q property -n " + device_path + " 2>/dev/null";
-    FILE* pipe = popen(cmd.c_str(), "r");
-    if (!pipe) {
-        return "";
-    }
-    
-    std::string output;
-    std::array<char, 128> buffer;
-    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-        output += buffer.data();
-    }
-    pclose(pipe);
+DeviceRoutes compute_device_routes(const std::vector<std::string>& roles, const std::vector<Binding>& bindings) {
+    DeviceRoutes routes;
     
-    std::istringstream iss(output);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.substr(0, property.length() + 1) == property + "=") {
-            return line.substr(property.length() + 1);
+    // Later bindings win when two roles share a device and bind the same code
+    for (const auto& binding : bindings) {
+        std::string binding_role_str = (binding.src.role == Role::Stick) ? "stick" :
+                                      (binding.src.role == Role::Throttle) ? "throttle" : "rudder";
+        if (std::find(roles.begin(), roles.end(), binding_role_str) == roles.end()) {
+            continue;
+        }
+        
+        uint8_t entry = static_cast<uint8_t>(static_cast<int>(binding.src.role) + 1);
+        if (binding.src.kind == SrcKind::Key) {
+            if (binding.src.code < KEY_CNT) routes.keys[binding.src.code] = entry;
+        } else {
+            if (binding.src.code < ABS_CNT) routes.abs[binding.src.code] = entry;
         }
     }
-    return "";
+    return routes;
 }
 
-bool validate_device(const std::string& device_path, const std::string& expected_vendor, const std::string& expected_product) {
-    std::string vendor_id = get_udev_property(device_path, "ID_VENDOR_ID");
-    std::string product_id = get_udev_property(device_path, "ID_MODEL_ID");
-    
-    return (vendor_id == expected_vendor && product_id == expected_product);
+void build_device_routes(InputDevice& device, const std::vector<Binding>& bindings) {
+    device.routes = compute_device_routes(device.roles, bindings);
 }
 
-bool reopen_device(InputDevice& device) {
-    // Close existing fd if open
-    if (device.fd >= 0) {
-        if (device.dev) {
-            libevdev_free(device.dev);
-            device.dev = nullptr;
-        }
-        close(device.fd);
-        device.fd = -1;
-    }
-    
-    // Try to resolve the by-id path
-    char real_path[PATH_MAX];
-    if (realpath(device.by_id_path.c_str(), real_path) == nullptr) {
-        return false;
-    }
-    
-    // Try to open the device
-    int fd = open(real_path, O_RDONLY | O_NONBLOCK);
-    if (fd < 0) {
-        return false;
-    }
-    
-    // Initialize libevdev
-    struct libevdev* dev = nullptr;
-    int rc = libevdev_new_from_fd(fd, &dev);
-    if (rc < 0) {
-        close(fd);
+// Check that a by-id path still points at the configured vendor/product
+bool validate_device(const std::string& by_id_path, const std::string& expected_vendor, const std::string& expected_product) {
+    auto identity = lookup_device_identity(by_id_path);
+    return identity && identity->vendor == expected_vendor && identity->product == expected_product;
+}
+
+// Open device.by_id and check it is still the configured vendor/product
+bool open_input_device(InputDevice& device, bool grab) {
+    if (device.open_and_init(grab) < 0) {
         return false;
     }
     
-    // Validate device
-    if (!validate_device(real_path, device.vendor, device.product)) {
-        libevdev_free(dev);
-        close(fd);
+    if (!validate_device(device.by_id, device.vendor, device.product)) {
+        device.close_and_free();
         return false;
     }
     
-    // Update device state
-    device.fd = fd;
-    device.dev = dev;
-    device.path = real_path;
     device.online = true;
-    device.consecutive_read_failures = 0;
-    device.reconnect_backoff_ms = 500; // Reset to initial backoff
-    
-    std::cout << "Successfully reconnected " << device.primary_role() << ": " << real_path << "\n";
     return true;
 }
 
-void handle_device_error(InputDevice& device) {
-    device.consecutive_read_failures++;
+// Status lines from the event thread, printed by housekeeping so the real-time
+// thread never blocks on a terminal. One producer, one consumer; a full ring
+// drops the line and counts it.
+class EventThreadLog {
+public:
+    void line(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        size_t head = write_pos.load(std::memory_order_relaxed);
+        if (head - read_pos.load(std::memory_order_acquire) == SLOTS) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        va_list args;
+        va_start(args, format);
+        vsnprintf(slots[head % SLOTS].data(), LINE_SIZE, format, args);
+        va_end(args);
+        write_pos.store(head + 1, std::memory_order_release);
+    }
     
-    // Mark offline if we get specific errors or repeated failures
-    if (errno == ENODEV || errno == EIO || device.consecutive_read_failures >= 3) {
-        if (device.online) {
-            std::cout << device.primary_role() << " device disconnected (errno=" << errno 
-                      << ", failures=" << device.consecutive_read_failures << ")\n";
-            device.online = false;
+    void drain(std::ostream& out) {
+        size_t tail = read_pos.load(std::memory_order_relaxed);
+        size_t head = write_pos.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            out << slots[tail % SLOTS].data() << "\n";
         }
+        read_pos.store(tail, std::memory_order_release);
         
-        // Close the device
-        if (device.dev) {
-            libevdev_free(device.dev);
-            device.dev = nullptr;
-        }
-        if (device.fd >= 0) {
-            close(device.fd);
-            device.fd = -1;
+        uint64_t total_dropped = dropped.load(std::memory_order_relaxed);
+        if (total_dropped != reported_dropped) {
+            out << "(" << total_dropped - reported_dropped << " event thread messages dropped)\n";
+            reported_dropped = total_dropped;
         }
     }
-}
 
-void attempt_device_reconnection(InputDevice& device) {
+private:
+    static constexpr size_t SLOTS = 32;
+    static constexpr size_t LINE_SIZE = 160;
+    std::array<std::array<char, LINE_SIZE>, SLOTS> slots{};
+    std::atomic<size_t> write_pos{0};
+    std::atomic<size_t> read_pos{0};
+    std::atomic<uint64_t> dropped{0};
+    uint64_t reported_dropped = 0;  // Consumer only
+};
+
+// Disconnect callback for EpollLoop: the loop has already removed and closed the device.
+// The mapper loop queues the message on its EventThreadLog; other modes print it directly.
+void mark_device_offline(InputDevice& device, int error, EventThreadLog* log = nullptr) {
     if (device.online) {
-        return;
+        char message[160];
+        snprintf(message, sizeof(message), "%s device disconnected (errno=%d, failures=%d)",
+                 device.primary_role().c_str(), error, device.consecutive_read_failures);
+        if (log) {
+            log->line("%s", message);
+        } else {
+            std::cout << message << "\n";
+        }
+        device.online = false;
     }
-    
+    device.consecutive_read_failures = 0;
+}
+
+// Housekeeping: once device's backoff has passed, open its node into reopened.
+// Only device's identity and backoff are touched, so the event thread can keep
+// using the rest of it until the handles are handed over.
+bool attempt_device_reconnection(InputDevice& device, InputDevice& reopened, bool grab) {
     auto now = std::chrono::steady_clock::now();
     auto time_since_attempt = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - device.last_reconnect_attempt).count();
     
-    if (time_since_attempt >= device.reconnect_backoff_ms) {
-        device.last_reconnect_attempt = now;
-        
-        if (reopen_device(device)) {
-            // Successfully reconnected
-            device.reconnect_backoff_ms = 500; // Reset backoff
-        } else {
-            // Failed to reconnect, increase backoff (max 2 seconds)
-            device.reconnect_backoff_ms = std::min(2000, device.reconnect_backoff_ms * 2);
-        }
+    if (time_since_attempt < device.reconnect_backoff_ms) {
+        return false;
+    }
+    
+    device.last_reconnect_attempt = now;
+    
+    reopened.by_id = device.by_id;
+    reopened.vendor = device.vendor;
+    reopened.product = device.product;
+    reopened.roles = device.roles;
+    if (open_input_device(reopened, grab)) {
+        device.reconnect_backoff_ms = 500; // Reset to initial backoff
+        std::cout << "Successfully reconnected " << device.primary_role() << ": " << reopened.resolved_path << "\n";
+        return true;
+    }
+    
+    // Failed to reconnect, increase backoff (100ms after a hotplug retry, max 2 seconds)
+    device.reconnect_backoff_ms = std::min(2000, std::max(100, device.reconnect_backoff_ms * 2));
+    return false;
+}
+
+// What validate_and_filter_bindings needs from a device. Captured when the device is
+// opened so a config reload can filter bindings without touching the libevdev handle.
+struct DeviceCapabilities {
+    std::vector<std::string> roles;
+    bool opened = false;
+    std::bitset<KEY_CNT> keys;
+    std::bitset<ABS_CNT> abs;
+    
+    bool has_role(const std::string& r) const {
+        return std::find(roles.begin(), roles.end(), r) != roles.end();
+    }
+    
+    std::string primary_role() const {
+        return roles.empty() ? "unknown" : roles[0];
+    }
+};
+
+DeviceCapabilities capture_device_capabilities(const InputDevice& device) {
+    DeviceCapabilities caps;
+    caps.roles = device.roles;
+    caps.opened = device.dev != nullptr;
+    if (!device.dev) return caps;
+    
+    for (unsigned int code = 0; code < KEY_CNT; code++) {
+        caps.keys[code] = libevdev_has_event_code(device.dev, EV_KEY, code);
+    }
+    for (unsigned int code = 0; code < ABS_CNT; code++) {
+        caps.abs[code] = libevdev_has_event_code(device.dev, EV_ABS, code);
     }
+    return caps;
 }
 
-bool device_supports_code(const InputDevice& device, SrcKind kind, uint16_t code) {
-    if (!device.dev) return false;
+bool device_supports_code(const DeviceCapabilities& device, SrcKind kind, uint16_t code) {
+    if (!device.opened) return false;
     
     if (kind == SrcKind::Key) {
-        return libevdev_has_event_code(device.dev, EV_KEY, code);
+        return code < KEY_CNT && device.keys[code];
     } else {
-        return libevdev_has_event_code(device.dev, EV_ABS, code);
+        return code < ABS_CNT && device.abs[code];
     }
 }
 
-void validate_and_filter_bindings(std::vector<Binding>& bindings, const std::vector<InputDevice>& devices) {
+void validate_and_filter_bindings(std::vector<Binding>& bindings, const std::vector<DeviceCapabilities>& devices) {
     std::set<std::tuple<std::string, SrcKind, uint16_t>> logged_missing_codes;
     
     for (auto it = bindings.begin(); it != bindings.end();) {
         bool binding_valid = true;
         
         // Find the source device for this binding
-        const InputDevice* source_device = nullptr;
+        const DeviceCapabilities* source_device = nullptr;
         std::string binding_role_str = (it->src.role == Role::Stick ? "stick" : 
                                        it->src.role == Role::Throttle ? "throttle" : "rudder");
         for (const auto& device : devices) {
@@ -228,7 +314,7 @@ void validate_and_filter_bindings(std::vector<Binding>& bindings, const std::vec
         if (!source_device) {
             // Role device not available/configured
             binding_valid = false;
-        } else if (!source_device->dev) {
+        } else if (!source_device->opened) {
             // Device exists but isn't opened in this context (e.g. diagnostics mode).
             // Keep binding since we can't validate capabilities here.
             binding_valid = true;
@@ -262,57 +348,347 @@ void validate_and_filter_bindings(std::vector<Binding>& bindings, const std::vec
     }
 }
 
-int discovery_mode(const Config& config) {
-    std::vector<InputDevice> devices;
+void validate_and_filter_bindings(std::vector<Binding>& bindings, const std::vector<InputDevice>& devices) {
+    std::vector<DeviceCapabilities> caps;
+    for (const auto& device : devices) {
+        caps.push_back(capture_device_capabilities(device));
+    }
+    validate_and_filter_bindings(bindings, caps);
+}
+
+// Hash of what validate_and_filter_bindings depends on besides the config:
+// which devices are online and which codes each one reports
+uint64_t hash_device_capabilities(const std::vector<InputDevice>& devices) {
+    uint64_t hash = StartupCache::FNV_OFFSET;
+    for (const auto& device : devices) {
+        hash = StartupCache::fnv1a(device.by_id.data(), device.by_id.size(), hash);
+        uint8_t online = device.online ? 1 : 0;
+        hash = StartupCache::fnv1a(&online, sizeof(online), hash);
+        if (!device.online || !device.dev) continue;
+        
+        std::array<uint8_t, (KEY_CNT + ABS_CNT + 7) / 8> caps{};
+        for (unsigned int code = 0; code < KEY_CNT; code++) {
+            if (libevdev_has_event_code(device.dev, EV_KEY, code)) caps[code / 8] |= 1 << (code % 8);
+        }
+        for (unsigned int code = 0; code < ABS_CNT; code++) {
+            unsigned int bit = KEY_CNT + code;
+            if (libevdev_has_event_code(device.dev, EV_ABS, code)) caps[bit / 8] |= 1 << (bit % 8);
+        }
+        hash = StartupCache::fnv1a(caps.data(), caps.size(), hash);
+    }
+    return hash;
+}
+
+// Bindings from one profile, falling back to the defaults when it has none or
+// all of them violate the virtual controller contract
+std::vector<Binding> load_profile_bindings(const Config& config, const std::string& profile_name) {
+    std::vector<Binding> bindings;
     
-    // Open all configured devices
-    for (const auto& [role_str, input_config] : config.devices) {
-        if (input_config.by_id.empty()) {
-            std::cout << "Skipping " << input_config.role << " (not present)\n";
-            continue;
+    auto profile = config.profiles.find(profile_name);
+    if (profile != config.profiles.end() &&
+        (!profile->second.bindings_keys.empty() || !profile->second.bindings_abs.empty())) {
+        auto config_bindings = make_bindings_from_config(profile->second.bindings_keys, profile->second.bindings_abs);
+        
+        // Validate config bindings and filter out invalid ones
+        std::vector<Binding> valid_config_bindings;
+        for (const auto& binding : config_bindings) {
+            if (validate_bindings({binding})) {
+                valid_config_bindings.push_back(binding);
+            } else {
+                std::cout << "WARNING: Ignored invalid binding targeting virtual controller contract violation\n";
+            }
         }
         
-        char real_path[PATH_MAX];
-        if (realpath(input_config.by_id.c_str(), real_path) == nullptr) {
-            std::cerr << "Failed to resolve " << input_config.role << " path: " << input_config.by_id << "\n";
-            continue;
+        if (!valid_config_bindings.empty()) {
+            bindings = valid_config_bindings;
+            std::cout << "Loaded " << bindings.size() << " bindings from profile " << profile_name << "\n";
+        } else {
+            std::cout << "WARNING: All bindings in profile " << profile_name << " were invalid, falling back to defaults\n";
+            bindings = make_default_bindings();
         }
+    } else {
+        bindings = make_default_bindings();
+        std::cout << "Loaded " << bindings.size() << " default bindings for profile " << profile_name << "\n";
+    }
+    
+    return bindings;
+}
+
+std::vector<Binding> load_active_bindings(const Config& config) {
+    return load_profile_bindings(config, config.active_profile);
+}
+
+// Filtered bindings for every profile, keyed by name, which is also the switching
+// order. The active profile is always included, even without an entry of its own.
+std::map<std::string, std::vector<Binding>> load_all_profile_bindings(const Config& config,
+                                                                      const std::vector<DeviceCapabilities>& devices) {
+    std::map<std::string, std::vector<Binding>> profile_bindings;
+    for (const auto& [name, profile] : config.profiles) {
+        profile_bindings[name] = load_profile_bindings(config, name);
+    }
+    if (!profile_bindings.count(config.active_profile)) {
+        profile_bindings[config.active_profile] = load_profile_bindings(config, config.active_profile);
+    }
+    for (auto& [name, bindings] : profile_bindings) {
+        validate_and_filter_bindings(bindings, devices);
+    }
+    return profile_bindings;
+}
+
+void apply_config_calibrations(BindingResolver& resolver, const Config& config, bool log = true) {
+    for (const auto& [role_str, axes] : config.calibrations) {
+        Role role;
+        if (role_str == "stick") role = Role::Stick;
+        else if (role_str == "throttle") role = Role::Throttle;
+        else if (role_str == "rudder") role = Role::Rudder;
+        else continue;
         
-        int fd = open(real_path, O_RDONLY);
-        if (fd < 0) {
-            std::cerr << "Failed to open " << input_config.role << ": " << input_config.by_id << "\n";
-            continue;
+        for (const auto& [axis_code, cal] : axes) {
+            resolver.set_calibration(role, cal.src_code, cal);
+            if (!log) continue;
+            std::cout << "Loaded calibration for " << role_str << " axis " << cal.src_code 
+                     << " (range: " << cal.observed_min << "-" << cal.observed_max << ")\n";
         }
+    }
+}
 
-        struct libevdev* dev = nullptr;
-        int rc = libevdev_new_from_fd(fd, &dev);
-        if (rc < 0) {
-            std::cerr << "Failed to init " << input_config.role << "\n";
-            close(fd);
-            continue;
+// One resolver per virtual output, each compiled from only the bindings that
+// target it and calibrated the same way. Bindings for outputs past output_count
+// are dropped.
+std::vector<std::unique_ptr<BindingResolver>> build_output_resolvers(const std::vector<Binding>& bindings,
+                                                                     const Config& config, size_t output_count,
+                                                                     bool log = true) {
+    std::vector<std::vector<Binding>> output_bindings(output_count);
+    size_t dropped = 0;
+    for (const auto& binding : bindings) {
+        if (binding.output < output_count) {
+            output_bindings[binding.output].push_back(binding);
+        } else {
+            dropped++;
+        }
+    }
+    if (dropped > 0) {
+        std::cout << "WARNING: Ignored " << dropped << " binding(s) for outputs that were not created\n";
+    }
+    
+    std::vector<std::unique_ptr<BindingResolver>> resolvers;
+    for (size_t i = 0; i < output_count; i++) {
+        resolvers.push_back(std::make_unique<BindingResolver>(output_bindings[i]));
+        apply_config_calibrations(*resolvers.back(), config, log && i == 0);
+    }
+    return resolvers;
+}
+
+std::vector<std::unique_ptr<BindingResolver>> clone_resolvers(const std::vector<std::unique_ptr<BindingResolver>>& resolvers) {
+    std::vector<std::unique_ptr<BindingResolver>> copies;
+    for (const auto& resolver : resolvers) {
+        copies.push_back(std::make_unique<BindingResolver>(*resolver));
+    }
+    return copies;
+}
+
+// One profile ready to go live: per-device routes and one resolver per output.
+// The mapper compiles all of them up front, so a switch only changes which one
+// the event thread feeds.
+struct CompiledProfile {
+    std::string name;
+    std::vector<DeviceRoutes> routes;  // Parallel to the mapper's input devices
+    std::vector<std::unique_ptr<BindingResolver>> resolvers;  // Parallel to outputs
+};
+
+CompiledProfile clone_profile(const CompiledProfile& profile) {
+    return {profile.name, profile.routes, clone_resolvers(profile.resolvers)};
+}
+
+CompiledProfile* find_profile(std::vector<CompiledProfile>& profiles, const std::string& name) {
+    for (auto& profile : profiles) {
+        if (profile.name == name) return &profile;
+    }
+    return nullptr;
+}
+
+// The profile switch combo, watched on its device's key events. Once it fires,
+// its buttons are masked from the resolvers until each one is released, so the
+// profile switched to never sees them pressed.
+struct ProfileSwitchCombo {
+    const InputDevice* device = nullptr;  // nullptr when switching is off
+    std::vector<uint16_t> buttons;        // At most 32
+    uint32_t held = 0;                    // Bit per buttons entry
+    uint32_t masked = 0;
+    
+    // Returns true when this event completes the combo. Sets mask if the event
+    // must not reach the resolvers, which includes the completing press.
+    bool process(const struct input_event& ev, bool& mask) {
+        mask = false;
+        if (ev.type != EV_KEY) return false;
+        auto it = std::find(buttons.begin(), buttons.end(), ev.code);
+        if (it == buttons.end()) return false;
+        
+        uint32_t bit = 1u << (it - buttons.begin());
+        uint32_t all = static_cast<uint32_t>((1ull << buttons.size()) - 1);
+        bool was_complete = held == all;
+        held = ev.value ? (held | bit) : (held & ~bit);
+        if (masked & bit) {
+            mask = true;
+            if (ev.value == 0) masked &= ~bit;
         }
+        if (was_complete || held != all) return false;
         
-        if (!validate_device(real_path, input_config.vendor, input_config.product)) {
-            std::cerr << "Device validation failed for " << input_config.role << "\n";
-            libevdev_free(dev);
-            close(fd);
+        masked = held;
+        mask = true;
+        return true;
+    }
+    
+    void reset() {
+        held = 0;
+        masked = 0;
+    }
+};
+
+// Calibrations in next that are new or differ from current, for applying on top of
+// a resolver built from current. False if one was removed, which needs a rebuild.
+bool collect_changed_calibrations(const Config& current, const Config& next,
+                                  std::vector<std::pair<Role, AxisCalibration>>& changed) {
+    for (const auto& [role_str, axes] : current.calibrations) {
+        for (const auto& [axis_code, cal] : axes) {
+            if (!next.get_calibration(role_str, axis_code)) return false;
+        }
+    }
+    for (const auto& [role_str, axes] : next.calibrations) {
+        if (role_str != "stick" && role_str != "throttle" && role_str != "rudder") continue;
+        for (const auto& [axis_code, cal] : axes) {
+            auto previous = current.get_calibration(role_str, axis_code);
+            if (!previous || !(*previous == cal)) {
+                changed.push_back({string_to_role(role_str), cal});
+            }
+        }
+    }
+    return true;
+}
+
+// Devices and settings are applied at startup only
+bool restart_settings_changed(Config current, Config next) {
+    for (Config* config : {&current, &next}) {
+        config->profiles.clear();
+        config->calibrations.clear();
+        config->active_profile.clear();
+    }
+    return !(current == next);
+}
+
+// Routes one evdev event from a device into the resolver. Returns true at the
+// end of an input frame (SYN_REPORT), when the caller should resolve.
+bool feed_resolver(BindingResolver& resolver, const InputDevice& device, const struct input_event& ev) {
+    Role role;
+    switch (ev.type) {
+        case EV_ABS:
+            // Route by code to the owning role (supports multiple roles per device)
+            if (device.route(SrcKind::Abs, ev.code, role)) {
+                resolver.process_input({role, SrcKind::Abs, static_cast<uint16_t>(ev.code)}, ev.value);
+            }
+            return false;
+        
+        case EV_KEY:
+            if (device.route(SrcKind::Key, ev.code, role)) {
+                resolver.process_input({role, SrcKind::Key, static_cast<uint16_t>(ev.code)}, ev.value);
+            }
+            return false;
+        
+        case EV_SYN:
+            return ev.code == SYN_REPORT;
+    }
+    return false;
+}
+
+// Replays the key and axis state libevdev tracks for a device into the resolver,
+// for every routed code, so a freshly built resolver starts from what is held now
+void seed_resolver_from_device(BindingResolver& resolver, const InputDevice& device) {
+    if (!device.online || !device.dev) return;
+    
+    for (unsigned int code = 0; code < KEY_CNT; code++) {
+        uint8_t entry = device.routes.keys[code];
+        if (entry == 0 || !libevdev_has_event_code(device.dev, EV_KEY, code)) continue;
+        resolver.process_input({static_cast<Role>(entry - 1), SrcKind::Key, static_cast<uint16_t>(code)},
+                               libevdev_get_event_value(device.dev, EV_KEY, code));
+    }
+    for (unsigned int code = 0; code < ABS_CNT; code++) {
+        uint8_t entry = device.routes.abs[code];
+        if (entry == 0 || !libevdev_has_event_code(device.dev, EV_ABS, code)) continue;
+        resolver.process_input({static_cast<Role>(entry - 1), SrcKind::Abs, static_cast<uint16_t>(code)},
+                               libevdev_get_event_value(device.dev, EV_ABS, code));
+    }
+}
+
+// Telemetry only sees events after this, so start from the device's current state
+void seed_telemetry_from_device(TelemetryWriter& telemetry, const InputDevice& device) {
+    if (!device.online || !device.dev || device.stats_source >= TELEMETRY_MAX_SOURCES) return;
+    
+    TelemetrySource& source = telemetry.frame().sources[device.stats_source];
+    for (unsigned int code = 0; code < ABS_CNT; code++) {
+        source.abs[code] = libevdev_has_event_code(device.dev, EV_ABS, code) ?
+            libevdev_get_event_value(device.dev, EV_ABS, code) : 0;
+    }
+    memset(source.keys, 0, sizeof(source.keys));
+    for (unsigned int code = 0; code < KEY_CNT; code++) {
+        if (libevdev_has_event_code(device.dev, EV_KEY, code) &&
+            libevdev_get_event_value(device.dev, EV_KEY, code)) {
+            source.keys[code / 64] |= 1ull << (code % 64);
+        }
+    }
+}
+
+// Queues everything the resolver changed since the last call; returns the event count
+size_t queue_resolver_output(BindingResolver& resolver, VirtualDevice& virtual_device,
+                             std::span<PendingEvent> pending_events) {
+    size_t pending_count = resolver.get_pending_events(pending_events);
+    for (size_t i = 0; i < pending_count; i++) {
+        const auto& [slot, value] = pending_events[i];
+        virtual_device.queue_event((slot.kind == SrcKind::Key) ? EV_KEY : EV_ABS, slot.code, value);
+    }
+    resolver.clear_pending_events();
+    return pending_count;
+}
+
+std::string device_label(const InputDevice& device) {
+    std::string label;
+    for (const auto& role : device.roles) {
+        label += (label.empty() ? "" : "+") + role;
+    }
+    return label;
+}
+
+int discovery_mode(const Config& config) {
+    EpollLoop loop;
+    if (!loop.initialize()) {
+        return 1;
+    }
+    
+    // Observe each configured device in turn
+    for (const auto& [role_str, input_config] : config.devices) {
+        if (input_config.by_id.empty()) {
+            std::cout << "Skipping " << input_config.role << " (not present)\n";
             continue;
         }
         
         InputDevice device;
+        device.role = input_config.role;
         device.roles.push_back(input_config.role);
-        device.fd = fd;
-        device.dev = dev;
-        device.path = real_path;
-        device.by_id_path = input_config.by_id;
+        device.by_id = input_config.by_id;
         device.vendor = input_config.vendor;
         device.product = input_config.product;
         device.optional = input_config.optional;
+        
+        if (device.open_and_init(false) < 0) {
+            std::cerr << "Failed to open " << input_config.role << ": " << input_config.by_id << "\n";
+            continue;
+        }
+        
+        if (!validate_device(device.by_id, input_config.vendor, input_config.product)) {
+            std::cerr << "Device validation failed for " << input_config.role << "\n";
+            device.close_and_free();
+            continue;
+        }
         device.online = true;
-        device.consecutive_read_failures = 0;
-        device.reconnect_backoff_ms = 500;
-        device.last_reconnect_attempt = std::chrono::steady_clock::now();
-        devices.push_back(device);
         
         std::cout << "\n=== " << input_config.role << " Discovery ===\n";
         std::cout << "Device: " << input_config.by_id << "\n";
@@ -320,37 +696,37 @@ int discovery_mode(const Config& config) {
         std::cout << "Move all controls:\n\n";
 
         std::set<std::pair<int, int>> observed_codes;
-        auto start_time = std::chrono::steady_clock::now();
-        int elapsed_seconds = 0;
-        
-        while (running && elapsed_seconds < 10) {
-            struct input_event ev;
-            
-            // Drain all available events to prevent missing signals
-            while ((rc = libevdev_next_event(dev, LIBEVDEV_READ_FLAG_NORMAL, &ev)) == LIBEVDEV_READ_STATUS_SUCCESS) {
-                if (ev.type == EV_KEY || ev.type == EV_ABS) {
-                    auto code_pair = std::make_pair(ev.type, ev.code);
-                    if (observed_codes.insert(code_pair).second) {
-                        const char* type_name = libevdev_event_type_get_name(ev.type);
-                        const char* code_name = libevdev_event_code_get_name(ev.type, ev.code);
-                        std::cout << "  " << (type_name ? type_name : "UNKNOWN") 
-                                  << " " << (code_name ? code_name : "UNKNOWN") 
-                                  << " (type=" << ev.type << ", code=" << ev.code << ")\n";
-                    }
-                }
+        loop.set_event_callback([&](InputSource*, const struct input_event& ev) {
+            if (ev.type != EV_KEY && ev.type != EV_ABS) {
+                return;
             }
-            
-            if (rc == -EAGAIN) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                auto now = std::chrono::steady_clock::now();
-                elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(now - start_time).count();
-            } else if (rc != LIBEVDEV_READ_STATUS_SUCCESS) {
+            auto code_pair = std::make_pair(ev.type, ev.code);
+            if (observed_codes.insert(code_pair).second) {
+                const char* type_name = libevdev_event_type_get_name(ev.type);
+                const char* code_name = libevdev_event_code_get_name(ev.type, ev.code);
+                std::cout << "  " << (type_name ? type_name : "UNKNOWN") 
+                          << " " << (code_name ? code_name : "UNKNOWN") 
+                          << " (type=" << ev.type << ", code=" << ev.code << ")\n";
+            }
+        });
+        loop.set_disconnect_callback([&](InputSource*, int error) {
+            mark_device_offline(device, error);
+        });
+        
+        if (!loop.add_device(&device)) {
+            device.close_and_free();
+            continue;
+        }
+        
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (running && device.online && std::chrono::steady_clock::now() < deadline) {
+            if (loop.run_once(100) < 0) {
                 break;
             }
         }
         
-        libevdev_free(dev);
-        close(fd);
+        loop.remove_device(&device);
+        device.close_and_free();
     }
     
     std::cout << "\nDiscovery complete.\n";
@@ -421,15 +797,16 @@ int diagnostics_mode(const Config& config) {
         }
         
         // Get actual device properties
-        std::string actual_vendor = get_udev_property(real_path, "ID_VENDOR_ID");
-        std::string actual_product = get_udev_property(real_path, "ID_MODEL_ID");
+        auto identity = read_device_identity(real_path);
+        std::string actual_vendor = identity ? identity->vendor : "";
+        std::string actual_product = identity ? identity->product : "";
         const char* device_name = libevdev_get_name(dev);
         
         std::cout << "    device_name: " << (device_name ? device_name : "UNKNOWN") << "\n";
         std::cout << "    actual_vendor: " << actual_vendor << "\n";
         std::cout << "    actual_product: " << actual_product << "\n";
         
-        bool validation_ok = validate_device(real_path, input_config.vendor, input_config.product);
+        bool validation_ok = validate_device(input_config.by_id, input_config.vendor, input_config.product);
         if (validation_ok) {
             std::cout << "    status: DETECTED_OK\n";
             detected_devices++;
@@ -469,14 +846,12 @@ int diagnostics_mode(const Config& config) {
         std::vector<InputDevice> temp_devices;
         for (const auto& [role_str, input_config] : config.devices) {
             InputDevice device;
+            device.role = input_config.role;
             device.roles.push_back(input_config.role);
-            device.by_id_path = input_config.by_id;
+            device.by_id = input_config.by_id;
             device.vendor = input_config.vendor;
             device.product = input_config.product;
             device.optional = input_config.optional;
-            device.online = false;
-            device.fd = -1;
-            device.dev = nullptr;
             temp_devices.push_back(device);
         }
         
@@ -529,11 +904,14 @@ int diagnostics_mode(const Config& config) {
                 const char* axis_name = libevdev_event_code_get_name(EV_ABS, binding->dst.code);
                 std::cout << "ABS " << (axis_name ? axis_name : "UNKNOWN") << " (" << binding->dst.code << ")";
                 
-                if (binding->xform.invert || binding->xform.deadzone > 0 || binding->xform.scale != 1.0f) {
+                if (binding->xform.invert || has_response_stages(binding->xform) || has_smoothing(binding->xform)) {
                     std::cout << " [";
                     if (binding->xform.invert) std::cout << "invert ";
-                    if (binding->xform.deadzone > 0) std::cout << "deadzone=" << binding->xform.deadzone << " ";
+                    if (binding->xform.deadzone > 0) std::cout << "deadzone=" << binding->xform.deadzone << "% ";
+                    if (binding->xform.expo > 0.0f) std::cout << "expo=" << binding->xform.expo << " ";
+                    if (binding->xform.s_curve > 0.0f) std::cout << "s_curve=" << binding->xform.s_curve << " ";
                     if (binding->xform.scale != 1.0f) std::cout << "scale=" << binding->xform.scale << " ";
+                    if (binding->xform.smoothing > 0.0f) std::cout << "smoothing=" << binding->xform.smoothing << " ";
                     std::cout << "\b]";
                 }
             }
@@ -583,6 +961,20 @@ int diagnostics_mode(const Config& config) {
         std::cout << "  service_file: NOT_FOUND\n";
     }
     
+    // Latency stats written by a running mapper (--stats or SIGUSR1)
+    std::cout << "\nLATENCY:\n";
+    std::string stats_path = LatencyStats::get_stats_path();
+    std::ifstream stats_file(stats_path);
+    if (stats_file.good()) {
+        std::cout << "  stats_file: " << stats_path << "\n";
+        std::string line;
+        while (std::getline(stats_file, line)) {
+            std::cout << "  " << line << "\n";
+        }
+    } else {
+        std::cout << "  stats_file: NOT_FOUND (run mapper with --stats or send it SIGUSR1)\n";
+    }
+    
     // uinput availability check
     std::cout << "\nSYSTEM CHECKS:\n";
     int uinput_check = open("/dev/uinput", O_RDWR | O_NONBLOCK);
@@ -642,15 +1034,79 @@ int diagnostics_mode(const Config& config) {
     return overall_healthy ? 0 : 1;
 }
 
+// --diag-axes while the mapper runs: stream what it writes to the virtual
+// controller from telemetry, without touching the (grabbed) devices
+int diag_axes_telemetry(TelemetryReader& telemetry) {
+    std::cout << "Reading live state from the running mapper.\n";
+    std::cout << "Sources:";
+    for (size_t source = 0; source < telemetry.source_count(); source++) {
+        std::cout << " " << telemetry.label(source);
+    }
+    std::cout << "\n\n=== Live Output Stream ===\n";
+    std::cout << "Move controls or press buttons to see activity...\n\n";
+    
+    TelemetryFrame previous{};
+    TelemetryFrame frame;
+    bool have_previous = false;
+    uint64_t seen = 0;
+    std::array<std::chrono::steady_clock::time_point, VIRTUAL_AXIS_COUNT> last_print{};
+    const auto print_interval = std::chrono::milliseconds(30);
+    
+    while (running) {
+        uint64_t published = telemetry.published();
+        if (published == seen || !telemetry.read(frame)) {
+            if (!telemetry.writer_alive()) {
+                std::cout << "Mapper stopped\n";
+                break;
+            }
+            usleep(5000);
+            continue;
+        }
+        seen = published;
+        if (!have_previous) {
+            previous = frame;
+            have_previous = true;
+            continue;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        for (int i = 0; i < VIRTUAL_AXIS_COUNT; i++) {
+            if (frame.virtual_axes[i] == previous.virtual_axes[i] || now - last_print[i] < print_interval) continue;
+            const char* name = libevdev_event_code_get_name(EV_ABS, VIRTUAL_AXIS_CODES[i]);
+            std::cout << "[virtual] " << (name ? name : "UNKNOWN") << " (out=" << frame.virtual_axes[i] << ")\n";
+            previous.virtual_axes[i] = frame.virtual_axes[i];
+            last_print[i] = now;
+        }
+        for (int i = 0; i < VIRTUAL_BUTTON_COUNT; i++) {
+            if (frame.virtual_buttons[i] == previous.virtual_buttons[i]) continue;
+            const char* name = libevdev_event_code_get_name(EV_KEY, VIRTUAL_BUTTON_CODES[i]);
+            std::cout << "[virtual] " << (name ? name : "UNKNOWN")
+                      << " [" << (frame.virtual_buttons[i] ? "PRESSED" : "RELEASED") << "]\n";
+            previous.virtual_buttons[i] = frame.virtual_buttons[i];
+        }
+        std::cout.flush();
+    }
+    
+    trace::shutdown();
+    return 0;
+}
+
 int diag_axes_mode(const Config& config) {
     std::cout << "=== TWCS ARMA Live Input Monitor ===\n";
     std::cout << "Showing real-time input mappings with physical device names.\n";
     std::cout << "Press Ctrl+C to stop.\n\n";
-    std::cout << "NOTE: Stop the mapper service first if devices are grabbed:\n";
-    std::cout << "  systemctl --user stop twcs-mapper.service\n\n";
+    
+    TelemetryReader telemetry;
+    if (telemetry.open() && telemetry.writer_alive()) {
+        return diag_axes_telemetry(telemetry);
+    }
+    telemetry.close();
+    
+    std::cout << "NOTE: The mapper is not running; reading the devices directly.\n\n";
     
     // Open and validate all devices
     std::vector<InputDevice> input_devices;
+    input_devices.reserve(config.devices.size());
     
     for (const auto& [role_str, input_config] : config.devices) {
         if (input_config.by_id.empty()) {
@@ -658,49 +1114,30 @@ int diag_axes_mode(const Config& config) {
             continue;
         }
         
-        char real_path[PATH_MAX];
-        if (realpath(input_config.by_id.c_str(), real_path) == nullptr) {
-            std::cerr << "Failed to resolve " << input_config.role << " path: " << input_config.by_id << "\n";
-            continue;
-        }
+        InputDevice device;
+        device.role = input_config.role;
+        device.roles.push_back(input_config.role);
+        device.by_id = input_config.by_id;
+        device.vendor = input_config.vendor;
+        device.product = input_config.product;
+        device.optional = input_config.optional;
         
-        int fd = open(real_path, O_RDONLY | O_NONBLOCK);
-        if (fd < 0) {
+        if (device.open_and_init(false) < 0) {
             perror(("Failed to open " + input_config.role).c_str());
             continue;
         }
-
-        struct libevdev* dev = nullptr;
-        int rc = libevdev_new_from_fd(fd, &dev);
-        if (rc < 0) {
-            perror(("Failed to init " + input_config.role).c_str());
-            close(fd);
-            continue;
-        }
         
-        if (!validate_device(real_path, input_config.vendor, input_config.product)) {
+        if (!validate_device(device.by_id, input_config.vendor, input_config.product)) {
             std::cerr << "Device validation failed for " << input_config.role << "\n";
-            libevdev_free(dev);
-            close(fd);
+            device.close_and_free();
             continue;
         }
         
-        InputDevice device;
-        device.roles.push_back(input_config.role);
-        device.fd = fd;
-        device.dev = dev;
-        device.path = real_path;
-        device.by_id_path = input_config.by_id;
-        device.vendor = input_config.vendor;
-        device.product = input_config.product;
-        device.optional = input_config.optional;
         device.online = true;
-        device.consecutive_read_failures = 0;
-        device.reconnect_backoff_ms = 500;
         device.last_reconnect_attempt = std::chrono::steady_clock::now();
         input_devices.push_back(device);
 
-        const char* device_name = libevdev_get_name(dev);
+        const char* device_name = libevdev_get_name(device.dev);
         std::cout << "Opened " << input_config.role << ": " << (device_name ? device_name : "UNKNOWN") << "\n";
         std::cout << "  Path: " << input_config.by_id << "\n";
     }
@@ -734,6 +1171,9 @@ int diag_axes_mode(const Config& config) {
     }
     
     validate_and_filter_bindings(bindings, input_devices);
+    for (auto& device : input_devices) {
+        build_device_routes(device, bindings);
+    }
     BindingResolver resolver(bindings);
     
     // Apply calibrations from config
@@ -783,6 +1223,10 @@ int diag_axes_mode(const Config& config) {
                      << dst_name;
             if (binding.xform.invert) std::cout << " [INVERTED]";
             if (binding.xform.scale != 1.0f) std::cout << " [scale=" << binding.xform.scale << "]";
+            if (binding.xform.deadzone > 0) std::cout << " [deadzone=" << binding.xform.deadzone << "%]";
+            if (binding.xform.expo > 0.0f) std::cout << " [expo=" << binding.xform.expo << "]";
+            if (binding.xform.s_curve > 0.0f) std::cout << " [s_curve=" << binding.xform.s_curve << "]";
+            if (binding.xform.smoothing > 0.0f) std::cout << " [smoothing=" << binding.xform.smoothing << "]";
             std::cout << "\n";
         }
     }
@@ -828,212 +1272,305 @@ int diag_axes_mode(const Config& config) {
     std::cout << "\n=== Live Input Stream ===\n";
     std::cout << "Move controls or press buttons to see activity...\n\n";
     
-    // Set up epoll
-    int epoll_fd = epoll_create1(0);
-    if (epoll_fd < 0) {
-        perror("Failed to create epoll");
+    EpollLoop loop;
+    if (!loop.initialize()) {
         for (auto& dev : input_devices) {
-            libevdev_free(dev.dev);
-            close(dev.fd);
+            dev.close_and_free();
         }
         return 1;
     }
-
-    for (auto& dev : input_devices) {
-        struct epoll_event event;
-        event.events = EPOLLIN;
-        event.data.fd = dev.fd;
-        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, dev.fd, &event);
-    }
     
     // Rate limiting for prints
     std::map<std::pair<std::string, int>, std::chrono::steady_clock::time_point> last_print;
     const auto print_interval = std::chrono::milliseconds(30);
     
-    struct epoll_event events[8];
-    
-    while (running) {
-        int nfds = epoll_wait(epoll_fd, events, 8, 100);
+    loop.set_event_callback([&](InputSource* source, const struct input_event& ev) {
+        InputDevice* source_device = static_cast<InputDevice*>(source);
         
-        if (nfds < 0) {
-            if (errno == EINTR) continue;
-            perror("epoll_wait failed");
-            break;
+        // Determine role from the routing table since device can have multiple roles
+        Role event_role;
+        SrcKind event_kind = (ev.type == EV_KEY) ? SrcKind::Key : SrcKind::Abs;
+        if ((ev.type != EV_ABS && ev.type != EV_KEY) || !source_device->route(event_kind, ev.code, event_role)) {
+            // Skip events that don't match any binding for this device's roles
+            return;
         }
         
-        for (int i = 0; i < nfds; i++) {
-            InputDevice* source_device = nullptr;
-            for (auto& dev : input_devices) {
-                if (dev.fd == events[i].data.fd) {
-                    source_device = &dev;
+        // Handle axis events
+        if (ev.type == EV_ABS) {
+            PhysicalInput input{event_role, SrcKind::Abs, static_cast<uint16_t>(ev.code)};
+
+            // Check if this input has a binding
+            for (const auto& binding : bindings) {
+                if (binding.src.role == input.role &&
+                    binding.src.kind == input.kind &&
+                    binding.src.code == input.code &&
+                    binding.dst.kind == SrcKind::Abs) {
+
+                    auto print_key = std::make_pair(source_device->primary_role(), ev.code);
+                    auto now = std::chrono::steady_clock::now();
+
+                    if (now - last_print[print_key] >= print_interval) {
+                        // Apply transform to show output value (before smoothing)
+                        int transformed = shape_axis_output(
+                            resolver.apply_axis_transform(ev.value, binding.xform, event_role, ev.code), binding.xform);
+
+                        const char* device_name = libevdev_get_name(source_device->dev);
+                        const char* src_name = libevdev_event_code_get_name(EV_ABS, ev.code);
+                        std::string dst_name;
+                        if (binding.dst.code == ABS_RX) dst_name = "Right Stick X (Cyclic Roll)";
+                        else if (binding.dst.code == ABS_RY) dst_name = "Right Stick Y (Cyclic Pitch)";
+                        else if (binding.dst.code == ABS_X) dst_name = "Left Stick X (Anti-torque)";
+                        else if (binding.dst.code == ABS_Y) dst_name = "Left Stick Y (Collective)";
+                        else dst_name = "ABS_" + std::to_string(binding.dst.code);
+
+                        std::cout << "[" << (device_name ? device_name : source_device->primary_role()) << "] "
+                                 << (src_name ? src_name : "UNKNOWN")
+                                 << " (raw=" << ev.value << ") -> "
+                                 << dst_name << " (out=" << transformed << ")\n";
+                        std::cout.flush();
+
+                        last_print[print_key] = now;
+                    }
                     break;
                 }
             }
+        }
+        // Handle button events
+        else if (ev.type == EV_KEY) {
+            PhysicalInput input{event_role, SrcKind::Key, static_cast<uint16_t>(ev.code)};
             
-            if (!source_device) continue;
+            const char* device_name = libevdev_get_name(source_device->dev);
+            const char* src_name = libevdev_event_code_get_name(EV_KEY, ev.code);
             
-            // Drain all available events from this device to prevent missing signals
-            struct input_event ev;
-            int rc;
-            while ((rc = libevdev_next_event(source_device->dev, LIBEVDEV_READ_FLAG_NORMAL, &ev)) == LIBEVDEV_READ_STATUS_SUCCESS) {
-                // Determine role from the binding since device can have multiple roles
-                std::string event_role_str;
-                Role event_role = Role::Stick;
-                SrcKind event_kind = SrcKind::Key;
-                uint16_t event_code = 0;
-
-                if (ev.type == EV_ABS) {
-                    event_kind = SrcKind::Abs;
-                    event_code = static_cast<uint16_t>(ev.code);
-                } else if (ev.type == EV_KEY) {
-                    event_kind = SrcKind::Key;
-                    event_code = static_cast<uint16_t>(ev.code);
-                }
-
-                // Find which role this event belongs to by checking bindings
-                for (const auto& binding : bindings) {
-                    std::string binding_role_str = (binding.src.role == Role::Stick) ? "stick" :
-                                                  (binding.src.role == Role::Throttle) ? "throttle" : "rudder";
-                    if (source_device->has_role(binding_role_str) &&
-                        binding.src.kind == event_kind &&
-                        binding.src.code == event_code) {
-                        event_role_str = binding_role_str;
-                        event_role = binding.src.role;
-                        break;
-                    }
-                }
-
-                // Skip events that don't match any binding for this device's roles
-                if (event_role_str.empty()) continue;
-
-                // Handle axis events
-                if (ev.type == EV_ABS) {
-                    PhysicalInput input{event_role, SrcKind::Abs, static_cast<uint16_t>(ev.code)};
-
-                    // Check if this input has a binding
-                    for (const auto& binding : bindings) {
-                        if (binding.src.role == input.role &&
-                            binding.src.kind == input.kind &&
-                            binding.src.code == input.code &&
-                            binding.dst.kind == SrcKind::Abs) {
-
-                            auto print_key = std::make_pair(source_device->primary_role(), ev.code);
-                            auto now = std::chrono::steady_clock::now();
-
-                            if (now - last_print[print_key] >= print_interval) {
-                                // Apply transform to show output value
-                                int transformed = resolver.apply_axis_transform(ev.value, binding.xform, event_role, ev.code);
-
-                                const char* device_name = libevdev_get_name(source_device->dev);
-                                const char* src_name = libevdev_event_code_get_name(EV_ABS, ev.code);
-                                std::string dst_name;
-                                if (binding.dst.code == ABS_RX) dst_name = "Right Stick X (Cyclic Roll)";
-                                else if (binding.dst.code == ABS_RY) dst_name = "Right Stick Y (Cyclic Pitch)";
-                                else if (binding.dst.code == ABS_X) dst_name = "Left Stick X (Anti-torque)";
-                                else if (binding.dst.code == ABS_Y) dst_name = "Left Stick Y (Collective)";
-                                else dst_name = "ABS_" + std::to_string(binding.dst.code);
-
-                                std::cout << "[" << (device_name ? device_name : source_device->primary_role()) << "] "
-                                         << (src_name ? src_name : "UNKNOWN")
-                                         << " (raw=" << ev.value << ") -> "
-                                         << dst_name << " (out=" << transformed << ")\n";
-                                std::cout.flush();
-
-                                last_print[print_key] = now;
-                            }
-                            break;
-                        }
-                    }
-                }
-                // Handle button events
-                else if (ev.type == EV_KEY) {
-                    PhysicalInput input{event_role, SrcKind::Key, static_cast<uint16_t>(ev.code)};
-                    
-                    const char* device_name = libevdev_get_name(source_device->dev);
-                    const char* src_name = libevdev_event_code_get_name(EV_KEY, ev.code);
-                    
-                    // Show button name or code if unknown
-                    std::string src_button;
-                    if (src_name) {
-                        src_button = src_name;
-                    } else {
-                        src_button = "BTN_CODE_" + std::to_string(ev.code);
-                    }
-                    
-                    // Check if this button has a binding
-                    bool has_binding = false;
-                    std::string virtual_button_name;
-                    
-                    for (const auto& binding : bindings) {
-                        if (binding.src.role == input.role && 
-                            binding.src.kind == input.kind && 
-                            binding.src.code == input.code &&
-                            binding.dst.kind == SrcKind::Key) {
-                            
-                            has_binding = true;
-                            
-                            // Map virtual button codes to generic controller names
-                            if (binding.dst.code == BTN_SOUTH) virtual_button_name = "South Button";
-                            else if (binding.dst.code == BTN_EAST) virtual_button_name = "East Button";
-                            else if (binding.dst.code == BTN_NORTH) virtual_button_name = "X (Left)";
-                            else if (binding.dst.code == BTN_WEST) virtual_button_name = "Y (Top)";
-                            else if (binding.dst.code == BTN_TL) virtual_button_name = "Left Shoulder";
-                            else if (binding.dst.code == BTN_TR) virtual_button_name = "Right Shoulder";
-                            else if (binding.dst.code == BTN_SELECT) virtual_button_name = "Select";
-                            else if (binding.dst.code == BTN_START) virtual_button_name = "Start";
-                            else if (binding.dst.code == BTN_MODE) virtual_button_name = "Menu";
-                            else if (binding.dst.code == BTN_THUMBL) virtual_button_name = "Left Stick Button";
-                            else if (binding.dst.code == BTN_THUMBR) virtual_button_name = "Right Stick Button";
-                            else {
-                                const char* dst_name = libevdev_event_code_get_name(EV_KEY, binding.dst.code);
-                                virtual_button_name = dst_name ? dst_name : ("BTN_CODE_" + std::to_string(binding.dst.code));
-                            }
-                            break;
-                        }
-                    }
+            // Show button name or code if unknown
+            std::string src_button;
+            if (src_name) {
+                src_button = src_name;
+            } else {
+                src_button = "BTN_CODE_" + std::to_string(ev.code);
+            }
+            
+            // Check if this button has a binding
+            bool has_binding = false;
+            std::string virtual_button_name;
+            
+            for (const auto& binding : bindings) {
+                if (binding.src.role == input.role && 
+                    binding.src.kind == input.kind && 
+                    binding.src.code == input.code &&
+                    binding.dst.kind == SrcKind::Key) {
                     
-                    // Display button press/release
-                    std::cout << "[" << (device_name ? device_name : source_device->primary_role()) << "] "
-                             << src_button;
+                    has_binding = true;
                     
-                    if (has_binding) {
-                        std::cout << " -> " << virtual_button_name;
-                    } else {
-                        std::cout << " -> [UNMAPPED]";
+                    // Map virtual button codes to generic controller names
+                    if (binding.dst.code == BTN_SOUTH) virtual_button_name = "South Button";
+                    else if (binding.dst.code == BTN_EAST) virtual_button_name = "East Button";
+                    else if (binding.dst.code == BTN_NORTH) virtual_button_name = "X (Left)";
+                    else if (binding.dst.code == BTN_WEST) virtual_button_name = "Y (Top)";
+                    else if (binding.dst.code == BTN_TL) virtual_button_name = "Left Shoulder";
+                    else if (binding.dst.code == BTN_TR) virtual_button_name = "Right Shoulder";
+                    else if (binding.dst.code == BTN_SELECT) virtual_button_name = "Select";
+                    else if (binding.dst.code == BTN_START) virtual_button_name = "Start";
+                    else if (binding.dst.code == BTN_MODE) virtual_button_name = "Menu";
+                    else if (binding.dst.code == BTN_THUMBL) virtual_button_name = "Left Stick Button";
+                    else if (binding.dst.code == BTN_THUMBR) virtual_button_name = "Right Stick Button";
+                    else {
+                        const char* dst_name = libevdev_event_code_get_name(EV_KEY, binding.dst.code);
+                        virtual_button_name = dst_name ? dst_name : ("BTN_CODE_" + std::to_string(binding.dst.code));
                     }
-                    
-                    std::cout << " [" << (ev.value ? "PRESSED" : "RELEASED") << "]\n";
-                    std::cout.flush();
+                    break;
                 }
             }
             
-            // Check why we exited the loop
-            if (rc != -EAGAIN && rc != LIBEVDEV_READ_STATUS_SUCCESS) {
-                // Read error
-                break;
+            // Display button press/release
+            std::cout << "[" << (device_name ? device_name : source_device->primary_role()) << "] "
+                     << src_button;
+            
+            if (has_binding) {
+                std::cout << " -> " << virtual_button_name;
+            } else {
+                std::cout << " -> [UNMAPPED]";
             }
+            
+            std::cout << " [" << (ev.value ? "PRESSED" : "RELEASED") << "]\n";
+            std::cout.flush();
+        }
+    });
+    loop.set_disconnect_callback([&](InputSource* source, int error) {
+        mark_device_offline(*static_cast<InputDevice*>(source), error);
+    });
+    
+    for (auto& dev : input_devices) {
+        loop.add_device(&dev);
+    }
+    
+    while (running) {
+        if (loop.run_once(100) < 0) {
+            break;
         }
     }
     
     // Clean up
-    close(epoll_fd);
+    loop.cleanup();
     for (auto& dev : input_devices) {
-        libevdev_free(dev.dev);
-        close(dev.fd);
+        dev.close_and_free();
     }
+    trace::shutdown();
     
     return 0;
 }
 
+// Feeds a recording through the same routing, resolver and VirtualDevice path as
+// the live loop, one recorded epoll batch at a time. Output goes to uinput, or to
+// output_path as raw input_events for comparing builds.
+int replay_mode(const Config& config, const std::string& path, bool realtime, const std::string& output_path) {
+    EventReplay replay;
+    if (!replay.open(path)) {
+        return 1;
+    }
+    
+    // Recreate the recorded devices (roles only; nothing is opened)
+    std::vector<InputDevice> devices;
+    for (const auto& label : replay.sources()) {
+        InputDevice device;
+        size_t start = 0;
+        while (start <= label.size()) {
+            size_t end = label.find('+', start);
+            if (end == std::string::npos) end = label.size();
+            if (end > start) device.roles.push_back(label.substr(start, end - start));
+            start = end + 1;
+        }
+        device.role = device.primary_role();
+        device.online = true;
+        devices.push_back(device);
+    }
+    std::cout << "Replaying " << replay.event_count() << " records from " << devices.size() << " devices\n";
+    
+    std::vector<Binding> bindings = load_active_bindings(config);
+    validate_and_filter_bindings(bindings, devices);
+    for (auto& device : devices) {
+        build_device_routes(device, bindings);
+    }
+    // Replay drives the first output only
+    auto resolvers = build_output_resolvers(bindings, config, 1);
+    BindingResolver& resolver = *resolvers[0];
+    
+    VirtualDevice virtual_device(config.uinput_name);
+    bool output_ready = output_path.empty() ? virtual_device.initialize()
+                                            : virtual_device.initialize_capture(output_path);
+    if (!output_ready) {
+        return 1;
+    }
+    
+    std::array<PendingEvent, MAX_PENDING_EVENTS> pending_events;
+    uint64_t input_events = 0;
+    uint64_t output_events = 0;
+    uint64_t batches = 0;
+    
+    const RecordedEvent* records = replay.events();
+    uint64_t first_time_us = replay.event_count() > 0 ? records[0].time_us : 0;
+    bool batch_started = false;
+    auto start_time = std::chrono::steady_clock::now();
+    
+    for (size_t i = 0; i < replay.event_count() && running; i++) {
+        const RecordedEvent& record = records[i];
+        
+        if (record.type == RECORD_BATCH_END) {
+            output_events += queue_resolver_output(resolver, virtual_device, pending_events);
+            virtual_device.flush_frame();
+            batches++;
+            batch_started = false;
+            continue;
+        }
+        if (record.source >= devices.size()) {
+            continue;
+        }
+        
+        // Real-time pacing: release each batch when its first event was captured
+        if (realtime && !batch_started && record.time_us > first_time_us) {
+            std::this_thread::sleep_until(start_time + std::chrono::microseconds(record.time_us - first_time_us));
+        }
+        batch_started = true;
+        
+        struct input_event ev{};
+        ev.type = record.type;
+        ev.code = record.code;
+        ev.value = record.value;
+        if (ev.type != EV_SYN) {
+            input_events++;
+        }
+        if (feed_resolver(resolver, devices[record.source], ev)) {
+            output_events += queue_resolver_output(resolver, virtual_device, pending_events);
+        }
+    }
+    output_events += queue_resolver_output(resolver, virtual_device, pending_events);
+    virtual_device.flush_frame();
+    
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    std::cout << "Replayed " << input_events << " input events in " << batches << " batches -> "
+              << output_events << " output events in " << std::fixed << std::setprecision(3) << elapsed << "s";
+    if (elapsed > 0) {
+        std::cout << " (" << std::setprecision(0) << input_events / elapsed << " events/s)";
+    }
+    std::cout << "\n";
+    
+    virtual_device.cleanup();
+    return 0;
+}
+
+// Normal-mode flags may be combined, so look for them anywhere on the command line
+bool has_option(int argc, char* argv[], const char* option) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], option) == 0) return true;
+    }
+    return false;
+}
+
+// Value of "--option VALUE", or empty if the option is absent
+std::string get_option_value(int argc, char* argv[], const char* option) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], option) == 0) return argv[i + 1];
+    }
+    return "";
+}
+
+// Numeric "--option VALUE" within [min_value, max_value]; value is left alone if the option is absent
+bool get_option_number(int argc, char* argv[], const char* option, long min_value, long max_value, long& value) {
+    if (!has_option(argc, argv, option)) return true;
+    
+    std::string text = get_option_value(argc, argv, option);
+    char* end = nullptr;
+    errno = 0;
+    long parsed = text.empty() ? 0 : strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno != 0 || parsed < min_value || parsed > max_value) {
+        std::cerr << option << " needs a number from " << min_value << " to " << max_value << "\n";
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
 void print_usage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " [OPTION]\n";
+    std::cout << "Usage: " << program_name << " [OPTION]...\n";
     std::cout << "TWCS ARMA Mapper - Virtual controller mapping for flight controls\n\n";
     std::cout << "Options:\n";
     std::cout << "  --print-map     Interactive discovery mode to map device controls\n";
     std::cout << "  --diagnostics   Non-interactive diagnostics reporting device detection, bindings, and service state\n";
     std::cout << "  --diag-axes     Real-time axis mapping diagnostics for ARMA helicopter controls\n";
+    std::cout << "  --fast-start    Normal mode, reusing cached bindings when config and devices are unchanged\n";
+    std::cout << "  --stats         Normal mode, printing input-to-uinput latency stats every 10 seconds\n";
+    std::cout << "  --record FILE   Normal mode, also capturing raw input events of all devices to FILE\n";
+    std::cout << "  --replay FILE   Feed a capture through the resolver to the virtual device and exit\n";
+    std::cout << "      --realtime             Keep the captured timing (default: as fast as possible)\n";
+    std::cout << "      --replay-output OUT    Write output events to OUT instead of uinput\n";
+    std::cout << "  --soak SECONDS  Normal mode against synthetic T.16000M/TWCS/T-Rudder devices, checking\n"
+              << "                  the virtual controller for lost or reordered frames, then exit\n";
+    std::cout << "      --soak-rate HZ         Frames per second on each synthetic device (default 1000)\n";
+    std::cout << "      --soak-max-p99 US      Also fail if the end-to-end p99 latency exceeds US\n";
     std::cout << "  --help          Show this help message\n\n";
     std::cout << "When run without options, mapper starts in normal mode, creating and managing virtual controller.\n";
+    std::cout << "Send SIGUSR1 to a running mapper to print latency stats and write them to\n"
+              << LatencyStats::get_stats_path() << " (also shown by --diagnostics).\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -1049,11 +1586,28 @@ int main(int argc, char* argv[]) {
     sigaction(SIGINT, &sa, nullptr);
     sigaction(SIGTERM, &sa, nullptr);
     sigaction(SIGHUP, &sa, nullptr);
+    sigaction(SIGUSR1, &sa, nullptr);
 
     // Load config using new path resolution
     std::string config_path = ConfigManager::get_config_path();
     
-    auto config_opt = ConfigManager::load(config_path);
+    // Fast start: a snapshot taken against the same config.json bytes replaces parsing it
+    // (a soak run's synthetic devices would never match a snapshot)
+    bool fast_start = has_option(argc, argv, "--fast-start") && !has_option(argc, argv, "--soak");
+    std::string cache_path;
+    uint64_t config_hash = 0;
+    std::optional<StartupSnapshot> snapshot;
+    if (fast_start) {
+        cache_path = StartupCache::get_cache_path();
+        if (StartupCache::hash_file(config_path, config_hash)) {
+            snapshot = StartupCache::load(cache_path);
+            if (snapshot && snapshot->config_hash != config_hash) {
+                snapshot.reset();
+            }
+        }
+    }
+    
+    auto config_opt = snapshot ? std::optional<Config>(snapshot->config) : ConfigManager::load(config_path);
     if (!config_opt) {
         std::cerr << "No configuration found. Run twcs_select first.\n";
         return 1;
@@ -1086,6 +1640,38 @@ int main(int argc, char* argv[]) {
         return diag_axes_mode(config);
     }
 
+    // Check for replay mode
+    if (argc >= 2 && strcmp(argv[1], "--replay") == 0) {
+        if (argc < 3) {
+            std::cerr << "--replay requires a recording file\n";
+            return 1;
+        }
+        return replay_mode(config, argv[2], has_option(argc, argv, "--realtime"),
+                           get_option_value(argc, argv, "--replay-output"));
+    }
+
+    // Soak test: everything below runs as usual, but against synthetic devices
+    // standing in for the configured ones, and ends with the soak report
+    std::unique_ptr<SoakTest> soak;
+    if (has_option(argc, argv, "--soak")) {
+        long seconds = 0;
+        long rate_hz = SoakSettings{}.rate_hz;
+        long max_p99_us = 0;
+        if (!get_option_number(argc, argv, "--soak", 1, 7 * 24 * 3600, seconds) ||
+            !get_option_number(argc, argv, "--soak-rate", 1, 20000, rate_hz) ||
+            !get_option_number(argc, argv, "--soak-max-p99", 1, 10000000, max_p99_us)) {
+            return 1;
+        }
+        SoakSettings settings;
+        settings.duration_s = static_cast<int>(seconds);
+        settings.rate_hz = static_cast<int>(rate_hz);
+        settings.max_p99_us = static_cast<uint64_t>(max_p99_us);
+        soak = std::make_unique<SoakTest>(settings);
+        if (!soak->create_sources(config)) {
+            return 1;
+        }
+    }
+
     // Open and validate all devices
     // First, group all roles by physical device path (to support multiple roles per device)
     std::map<std::string, std::vector<std::pair<std::string, const DeviceConfig*>>> path_to_roles;
@@ -1103,393 +1689,790 @@ int main(int argc, char* argv[]) {
 
     // Now open each unique physical device once
     std::vector<InputDevice> input_devices;
+    input_devices.reserve(path_to_roles.size());
     for (const auto& [by_id_path, role_configs] : path_to_roles) {
-        char real_path[PATH_MAX];
-        if (realpath(by_id_path.c_str(), real_path) == nullptr) {
-            std::cerr << "Failed to resolve device path: " << by_id_path << "\n";
-            bool all_optional = true;
-            for (const auto& [role, cfg] : role_configs) {
-                if (!cfg->optional) all_optional = false;
-            }
-            if (!all_optional) return 1;
-            continue;
+        // Use first role's config for validation (same physical device)
+        const auto* first_cfg = role_configs[0].second;
+        
+        InputDevice device;
+        for (const auto& [role, cfg] : role_configs) {
+            device.roles.push_back(role);
         }
-
-        int fd = open(real_path, O_RDONLY | O_NONBLOCK);
-        if (fd < 0) {
-            perror(("Failed to open device: " + by_id_path).c_str());
-            bool all_optional = true;
-            for (const auto& [role, cfg] : role_configs) {
-                if (!cfg->optional) all_optional = false;
+        device.role = device.primary_role();
+        device.by_id = by_id_path;
+        device.vendor = first_cfg->vendor;
+        device.product = first_cfg->product;
+        // Device is optional only if all roles are optional
+        device.optional = true;
+        for (const auto& [role, cfg] : role_configs) {
+            if (!cfg->optional) {
+                device.optional = false;
+                break;
             }
-            if (!all_optional) return 1;
-            continue;
         }
-
-        struct libevdev* dev = nullptr;
-        int rc = libevdev_new_from_fd(fd, &dev);
-        if (rc < 0) {
-            perror(("Failed to init device: " + by_id_path).c_str());
-            close(fd);
-            bool all_optional = true;
-            for (const auto& [role, cfg] : role_configs) {
-                if (!cfg->optional) all_optional = false;
-            }
-            if (!all_optional) return 1;
+        
+        // Optional devices that can't be opened yet stay in the list offline,
+        // so hotplug can connect them when they are plugged in
+        if (device.open_and_init(config.grab) < 0) {
+            perror(("Failed to open device: " + by_id_path).c_str());
+            if (!device.optional) return 1;
+            std::cout << "Waiting for optional " << device.primary_role() << " to be plugged in\n";
+            input_devices.push_back(device);
             continue;
         }
 
-        // Use first role's config for validation (same physical device)
-        const auto* first_cfg = role_configs[0].second;
-        if (!validate_device(real_path, first_cfg->vendor, first_cfg->product)) {
+        if (!validate_device(device.by_id, device.vendor, device.product)) {
             std::cerr << "Device validation failed for: " << by_id_path << "\n";
-            libevdev_free(dev);
-            close(fd);
-            bool all_optional = true;
-            for (const auto& [role, cfg] : role_configs) {
-                if (!cfg->optional) all_optional = false;
-            }
-            if (!all_optional) return 1;
+            device.close_and_free();
+            if (!device.optional) return 1;
+            input_devices.push_back(device);
             continue;
         }
 
-        // Grab device if configured
         if (config.grab) {
-            rc = ioctl(fd, EVIOCGRAB, 1);
-            if (rc < 0) {
-                perror(("Failed to grab device: " + by_id_path).c_str());
-            } else {
+            if (device.grabbed) {
                 std::cout << "Grabbed device: " << by_id_path << "\n";
+            } else {
+                perror(("Failed to grab device: " + by_id_path).c_str());
             }
         } else {
             std::cout << "Opened device: " << by_id_path << " (no grab)\n";
         }
 
-        InputDevice device;
-        for (const auto& [role, cfg] : role_configs) {
-            device.roles.push_back(role);
-        }
-        device.fd = fd;
-        device.dev = dev;
-        device.path = real_path;
-        device.by_id_path = by_id_path;
-        device.vendor = first_cfg->vendor;
-        device.product = first_cfg->product;
-        // Device is optional only if all roles are optional
-        device.optional = true;
-        for (const auto& [role, cfg] : role_configs) {
-            if (!cfg->optional) {
-                device.optional = false;
-                break;
-            }
-        }
         device.online = true;
-        device.consecutive_read_failures = 0;
-        device.reconnect_backoff_ms = 500;
         device.last_reconnect_attempt = std::chrono::steady_clock::now();
         input_devices.push_back(device);
     }
 
-    if (input_devices.empty()) {
+    bool any_online = std::any_of(input_devices.begin(), input_devices.end(),
+                                  [](const InputDevice& d) { return d.online; });
+    if (!any_online) {
         std::cerr << "No input devices available\n";
         return 1;
     }
 
-// Create virtual device
-    VirtualDevice virtual_device(config.uinput_name);
-    if (!virtual_device.initialize()) {
-        for (auto& dev : input_devices) {
-            if (dev.fd >= 0) {
-                close(dev.fd);
-                if (dev.dev) {
-                    libevdev_free(dev.dev);
-                }
+    // Per-device latency stats; the same index identifies the device in recordings
+    LatencyStats latency;
+    std::vector<std::string> source_labels;
+    for (auto& device : input_devices) {
+        source_labels.push_back(device_label(device));
+        device.stats_source = latency.add_source(source_labels.back());
+    }
+    
+    // Live state for the TUI monitor and --diag-axes, published into shared memory
+    TelemetryWriter telemetry;
+    std::vector<std::string> source_by_ids;
+    for (const auto& device : input_devices) {
+        source_by_ids.push_back(device.by_id);
+    }
+    // A soak run leaves the shared block to a mapper running alongside it
+    if (!soak && telemetry.open(source_labels, source_by_ids)) {
+        for (const auto& device : input_devices) {
+            seed_telemetry_from_device(telemetry, device);
+        }
+    } else if (!soak) {
+        std::cerr << "WARNING: Telemetry unavailable, monitors will read devices directly\n";
+    }
+    
+    EventRecorder recorder;
+    std::string record_path = get_option_value(argc, argv, "--record");
+    if (!record_path.empty()) {
+        if (!recorder.open(record_path, source_labels)) {
+            for (auto& dev : input_devices) {
+                dev.close_and_free();
             }
+            return 1;
         }
-        return 1;
+        std::cout << "Recording input to " << record_path << "\n";
     }
+    bool stats_enabled = has_option(argc, argv, "--stats");
+    const auto stats_interval = std::chrono::seconds(10);
+    auto last_stats_report = std::chrono::steady_clock::now();
 
-    std::cout << "Created uinput device: " << config.uinput_name << "\n";
+    // Create the virtual devices: the primary controller, then one per extra output.
+    // Each gets its own resolver and OutputScheduler below; all share the input path.
+    struct OutputChannel {
+        std::unique_ptr<VirtualDevice> device;
+        std::unique_ptr<OutputScheduler> scheduler;
+    };
+    std::vector<OutputChannel> outputs;
+    auto cleanup_outputs = [&]() {
+        for (auto& output : outputs) {
+            output.device->cleanup();
+        }
+    };
+    std::vector<std::string> output_names{config.uinput_name};
+    for (const auto& extra : config.outputs) {
+        output_names.push_back(extra.uinput_name);
+    }
+    for (const auto& name : output_names) {
+        OutputChannel output;
+        output.device = std::make_unique<VirtualDevice>(name);
+        if (!output.device->initialize()) {
+            cleanup_outputs();
+            for (auto& dev : input_devices) {
+                dev.close_and_free();
+            }
+            return 1;
+        }
+        std::cout << "Created uinput device: " << name << "\n";
+        outputs.push_back(std::move(output));
+    }
 
-    // Set up epoll
-    int epoll_fd = epoll_create1(0);
-    if (epoll_fd < 0) {
-        perror("Failed to create epoll");
-        virtual_device.cleanup();
+    // Set up the event loop. input_devices is not resized from here on, so the
+    // loop can hold pointers to its entries.
+    EpollLoop loop;
+    if (!loop.initialize()) {
+        cleanup_outputs();
         for (auto& dev : input_devices) {
-            libevdev_free(dev.dev);
-            close(dev.fd);
+            dev.close_and_free();
         }
         return 1;
     }
 
-    // Add all input devices to epoll
-    for (auto& dev : input_devices) {
-        struct epoll_event event;
-        event.events = EPOLLIN;
-        event.data.fd = dev.fd;
-        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, dev.fd, &event) < 0) {
-            perror("Failed to add device to epoll");
-            virtual_device.cleanup();
-            for (auto& d : input_devices) {
-                libevdev_free(d.dev);
-                close(d.fd);
+    // Resolve the bindings of every profile against the attached devices
+    std::map<std::string, std::vector<Binding>> profile_bindings;
+    std::vector<DeviceCapabilities> device_capabilities;
+    for (const auto& device : input_devices) {
+        device_capabilities.push_back(capture_device_capabilities(device));
+    }
+    
+    uint64_t caps_hash = hash_device_capabilities(input_devices);
+    bool use_snapshot = snapshot && snapshot->caps_hash == caps_hash;
+    if (snapshot && !use_snapshot) {
+        // Devices changed since the snapshot; the profiles it omits are needed to rebuild
+        std::cout << "Fast start: device capabilities changed, rebuilding bindings\n";
+        snapshot.reset();
+        config_opt = ConfigManager::load(config_path);
+        if (!config_opt) {
+            std::cerr << "No configuration found. Run twcs_select first.\n";
+            loop.cleanup();
+            cleanup_outputs();
+            for (auto& dev : input_devices) {
+                dev.close_and_free();
             }
-            close(epoll_fd);
             return 1;
         }
+        config = *config_opt;
     }
-
-    // Initialize binding resolver
-    std::vector<Binding> bindings;
     
-    // Try to load bindings from active profile, fall back to defaults if none or invalid
-    auto active_keys = config.get_active_bindings_keys();
-    auto active_abs = config.get_active_bindings_abs();
-    if (!active_keys.empty() || !active_abs.empty()) {
-        auto config_bindings = make_bindings_from_config(active_keys, active_abs);
+    if (use_snapshot) {
+        profile_bindings = snapshot->profile_bindings;
+        std::cout << "Fast start: loaded cached bindings for " << profile_bindings.size() << " profile(s)\n";
+    } else {
+        profile_bindings = load_all_profile_bindings(config, device_capabilities);
         
-        // Validate config bindings and filter out invalid ones
-        std::vector<Binding> valid_config_bindings;
-        for (const auto& binding : config_bindings) {
-            if (validate_bindings({binding})) {
-                valid_config_bindings.push_back(binding);
-            } else {
-                std::cout << "WARNING: Ignored invalid binding targeting virtual controller contract violation\n";
+        if (fast_start) {
+            StartupSnapshot new_snapshot;
+            new_snapshot.config_hash = config_hash;
+            new_snapshot.caps_hash = caps_hash;
+            new_snapshot.config = config;
+            new_snapshot.config.profiles.clear();
+            new_snapshot.profile_bindings = profile_bindings;
+            if (!StartupCache::save(cache_path, new_snapshot)) {
+                std::cerr << "WARNING: Failed to write startup cache: " << cache_path << "\n";
             }
         }
-        
-        if (!valid_config_bindings.empty()) {
-            bindings = valid_config_bindings;
-            std::cout << "Loaded " << bindings.size() << " bindings from config\n";
-        } else {
-            std::cout << "WARNING: All config bindings were invalid, falling back to defaults\n";
-            bindings = make_default_bindings();
-        }
-    } else {
-        bindings = make_default_bindings();
-        std::cout << "Loaded " << bindings.size() << " default bindings\n";
     }
-    
-    // Validate source codes and filter out invalid bindings
-    validate_and_filter_bindings(bindings, input_devices);
 
-    // Build code_to_role mapping for each device (needed when multiple roles share one device)
-    for (auto& device : input_devices) {
-        for (const auto& binding : bindings) {
-            std::string binding_role_str = (binding.src.role == Role::Stick) ? "stick" :
-                                          (binding.src.role == Role::Throttle) ? "throttle" : "rudder";
-            if (device.has_role(binding_role_str)) {
-                auto key = std::make_pair(binding.src.kind, binding.src.code);
-                device.code_to_role[key] = binding_role_str;
+    // Compile every profile up front: per-code role routing for each device (needed
+    // when multiple roles share one device) and a resolver per output.
+    auto compile_profiles = [&](std::map<std::string, std::vector<Binding>> bindings_by_profile,
+                                const Config& profile_config) {
+        std::vector<CompiledProfile> compiled;
+        for (auto& [name, bindings] : bindings_by_profile) {
+            CompiledProfile profile;
+            profile.name = name;
+            for (const auto& device : input_devices) {
+                profile.routes.push_back(compute_device_routes(device.roles, bindings));
             }
+            profile.resolvers = build_output_resolvers(bindings, profile_config, outputs.size(),
+                                                       name == profile_config.active_profile);
+            compiled.push_back(std::move(profile));
         }
+        return compiled;
+    };
+    
+    // The soak counter is planned from the bindings of the profile it drives
+    std::vector<Binding> soak_bindings;
+    if (soak) {
+        auto it = profile_bindings.find(config.active_profile);
+        soak_bindings = (it != profile_bindings.end() ? it : profile_bindings.begin())->second;
     }
-
-    BindingResolver resolver(bindings);
     
-    // Apply calibrations from config
-    for (const auto& [role_str, axes] : config.calibrations) {
-        Role role;
-        if (role_str == "stick") role = Role::Stick;
-        else if (role_str == "throttle") role = Role::Throttle;
-        else if (role_str == "rudder") role = Role::Rudder;
-        else continue;
-        
-        for (const auto& [axis_code, cal] : axes) {
-            resolver.set_calibration(role, cal.src_code, cal);
-            std::cout << "Loaded calibration for " << role_str << " axis " << cal.src_code 
-                     << " (range: " << cal.observed_min << "-" << cal.observed_max << ")\n";
+    // profiles is only touched on the event thread; live points at the one being fed
+    std::vector<CompiledProfile> profiles = compile_profiles(std::move(profile_bindings), config);
+    CompiledProfile* live = find_profile(profiles, config.active_profile);
+    if (!live) {
+        live = &profiles.front();
+    }
+    for (size_t i = 0; i < input_devices.size(); i++) {
+        input_devices[i].routes = live->routes[i];
+    }
+    if (profiles.size() > 1) {
+        std::cout << "Compiled " << profiles.size() << " profiles, active: " << live->name << "\n";
+    }
+    
+    // Optional button combo that cycles through the compiled profiles
+    ProfileSwitchCombo profile_switch;
+    bool switch_requested = false;
+    if (!config.profile_switch.buttons.empty()) {
+        for (const auto& device : input_devices) {
+            if (device.has_role(config.profile_switch.role)) {
+                profile_switch.device = &device;
+                break;
+            }
+        }
+        for (int code : config.profile_switch.buttons) {
+            if (code < KEY_CNT && profile_switch.buttons.size() < 32) {
+                profile_switch.buttons.push_back(static_cast<uint16_t>(code));
+            }
+        }
+        if (!profile_switch.device || profile_switch.buttons.empty()) {
+            std::cerr << "WARNING: Profile switch combo needs buttons on a configured role, switching disabled\n";
+            profile_switch.device = nullptr;
+            profile_switch.buttons.clear();
+        } else if (profiles.size() < 2) {
+            std::cout << "Profile switch combo set but only one profile exists\n";
+        } else {
+            std::cout << "Profile switch: hold " << profile_switch.buttons.size() << " button(s) on "
+                      << config.profile_switch.role << " to cycle profiles\n";
         }
     }
     
-#ifdef DEBUG_BINDINGS
-    const char* debug_env = getenv("TWCS_DEBUG_BINDINGS");
-    debug_bindings_enabled = (debug_env && strcmp(debug_env, "1") == 0);
-    if (debug_bindings_enabled) {
-        printf("Debug bindings enabled\n");
+    if (trace::init_from_env() != 0) {
+        std::cout << "Tracing enabled (TWCS_TRACE)\n";
     }
-#endif
 
     // Main event loop - Virtual Controller Contract must remain fixed
     // Axes: 8 (ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ, ABS_HAT0X, ABS_HAT0Y)
     // Buttons: 17 (Face 4, Shoulders 2, Triggers 2, System 3, Stick clicks 2, D-pad 4)
-    struct epoll_event events[8];
-    bool events_written = false;
+    std::array<PendingEvent, MAX_PENDING_EVENTS> pending_events;  // Reused for every resolver drain
     
-    while (running) {
-        int nfds = epoll_wait(epoll_fd, events, 8, 100);  // 100ms timeout
+    // Axis hysteresis and rate limiting between each resolver and its uinput device
+    bool rate_limit_ok = true;
+    for (auto& output : outputs) {
+        output.scheduler = std::make_unique<OutputScheduler>(*output.device);
+        rate_limit_ok = output.scheduler->initialize(config.output_hysteresis, config.output_max_rate_hz) && rate_limit_ok;
+    }
+    if (!rate_limit_ok) {
+        std::cerr << "WARNING: Output rate limiting unavailable, axis frames are sent immediately\n";
+    }
+    
+    // Resolve once per input frame and queue the result. Frames from every
+    // device woken by the same epoll_wait are merged into one virtual frame;
+    // VirtualDevice splits it only where a button would otherwise lose a toggle.
+    auto resolve_frame = [&]() {
+        for (size_t i = 0; i < outputs.size(); i++) {
+            size_t pending_count = live->resolvers[i]->get_pending_events(pending_events);
+            outputs[i].scheduler->submit({pending_events.data(), pending_count});
+            live->resolvers[i]->clear_pending_events();
+        }
+    };
+    
+    // True if any output wrote a frame
+    auto flush_outputs = [&](uint64_t now_us) {
+        bool emitted = false;
+        for (auto& output : outputs) {
+            emitted = output.scheduler->flush(now_us) || emitted;
+        }
+        return emitted;
+    };
+    auto outputs_pending = [&]() {
+        return std::any_of(outputs.begin(), outputs.end(),
+                           [](const OutputChannel& output) { return output.scheduler->has_pending(); });
+    };
+    
+    // Input that changed nothing never reaches uinput, so only emitted frames count.
+    // Input held back by the rate limit keeps its timestamp until its frame goes out.
+    auto account_frame_latency = [&](bool emitted) {
+        uint64_t now_us = LatencyStats::now_us();
+        for (auto& device : input_devices) {
+            if (device.frame_time_us == 0) continue;
+            if (emitted) {
+                uint64_t age_us = (now_us > device.frame_time_us) ? now_us - device.frame_time_us : 0;
+                latency.record_frame(device.stats_source, age_us);
+            } else if (outputs_pending()) {
+                continue;
+            }
+            device.frame_time_us = 0;
+        }
+    };
+    
+    loop.set_event_callback([&](InputSource* source, const struct input_event& ev) {
+        InputDevice* source_device = static_cast<InputDevice*>(source);
         
-        if (nfds < 0) {
-            if (errno == EINTR) continue;
-            perror("epoll_wait failed");
-            break;
+        if (source_device->frame_time_us == 0) {
+            source_device->frame_time_us = LatencyStats::event_time_us(ev);
+        }
+        if (ev.type != EV_SYN) {
+            latency.count_event(source_device->stats_source);
+        } else if (ev.code == SYN_DROPPED) {
+            // EpollLoop follows this with libevdev's resync: the current state of every
+            // code that changed during the overflow, ending in SYN_REPORT, which goes
+            // through the resolver like any other frame
+            latency.count_resync(source_device->stats_source);
+            TRACE(TRACE_BINDINGS, "%s: SYN_DROPPED, resyncing device state", source_device->primary_role().c_str());
         }
         
-        for (int i = 0; i < nfds; i++) {
-            // Find the device that triggered this event
-            InputDevice* source_device = nullptr;
-            for (auto& dev : input_devices) {
-                if (dev.fd == events[i].data.fd) {
-                    source_device = &dev;
-                    break;
-                }
+        if (recorder.is_open()) {
+            recorder.record(static_cast<uint8_t>(source_device->stats_source), ev);
+        }
+        telemetry.record_event(source_device->stats_source, ev);
+        
+        // The switch combo takes effect at the end of the batch; its buttons are
+        // kept from the resolvers while a switch holds them
+        bool masked = false;
+        if (source_device == profile_switch.device && profile_switch.process(ev, masked)) {
+            switch_requested = true;
+        }
+        if (masked) {
+            return;
+        }
+        
+        // End of an input frame - resolve everything it changed at once. Every
+        // output's resolver sees the event; its dispatch table skips unbound codes.
+        bool frame_end = false;
+        for (auto& resolver : live->resolvers) {
+            frame_end = feed_resolver(*resolver, *source_device, ev);
+        }
+        if (frame_end) {
+            resolve_frame();
+        }
+    });
+    
+    auto publish_telemetry = [&]() {
+        if (!telemetry.is_open()) return;
+        TelemetryFrame& frame = telemetry.frame();
+        for (const auto& device : input_devices) {
+            if (device.stats_source >= TELEMETRY_MAX_SOURCES) continue;
+            TelemetrySource& source = frame.sources[device.stats_source];
+            source.online = device.online ? 1 : 0;
+            source.events = latency.events(device.stats_source);
+            source.frames = latency.frames(device.stats_source);
+            source.resyncs = latency.resyncs(device.stats_source);
+        }
+        // Telemetry carries the primary controller
+        const VirtualDevice& primary = *outputs[0].device;
+        std::copy(primary.emitted_buttons().begin(), primary.emitted_buttons().end(), frame.virtual_buttons);
+        std::copy(primary.emitted_axes().begin(), primary.emitted_axes().end(), frame.virtual_axes);
+        telemetry.publish(LatencyStats::now_us());
+    };
+    
+    // Event thread: make `next` the live profile. Its resolvers pick up where the
+    // live ones' outputs left off and are seeded with the current physical state,
+    // so held buttons and deflected axes stay put and only what the new mapping
+    // changes is emitted. Buttons masked by the switch combo read as released.
+    auto go_live = [&](CompiledProfile& next) {
+        for (size_t i = 0; i < outputs.size(); i++) {
+            next.resolvers[i]->adopt_outputs(*live->resolvers[i]);
+        }
+        live = &next;
+        for (size_t i = 0; i < input_devices.size(); i++) {
+            input_devices[i].routes = next.routes[i];
+            for (auto& resolver : next.resolvers) {
+                seed_resolver_from_device(*resolver, input_devices[i]);
             }
-            
-            if (!source_device) continue;
-            
-            // Skip offline devices
-            if (!source_device->online || source_device->fd < 0 || !source_device->dev) {
+        }
+        for (size_t b = 0; b < profile_switch.buttons.size(); b++) {
+            Role role;
+            if (!(profile_switch.masked & (1u << b)) ||
+                !profile_switch.device->route(SrcKind::Key, profile_switch.buttons[b], role)) {
                 continue;
             }
+            for (auto& resolver : next.resolvers) {
+                resolver->process_input({role, SrcKind::Key, profile_switch.buttons[b]}, 0);
+            }
+        }
+        resolve_frame();
+        flush_outputs(LatencyStats::now_us());
+    };
+    
+    // Reload: housekeeping builds a complete ResolverGeneration (config and every
+    // compiled profile) and publishes it through pending_generation. The event
+    // thread adopts it between batches and hands the old one back through
+    // retired_generation so nothing is freed on the hot path. retired_generation
+    // holds one generation: while housekeeping hasn't reclaimed it, the event
+    // thread leaves the pending one alone and housekeeping wakes it once it has.
+    struct ResolverGeneration {
+        Config config;
+        std::vector<CompiledProfile> profiles;
+    };
+    std::atomic<ResolverGeneration*> pending_generation{nullptr};
+    std::atomic<ResolverGeneration*> retired_generation{nullptr};
+    
+    // Event thread: swap in a published generation. A profile picked in config.json
+    // wins; otherwise the mapper stays on the profile it was switched to.
+    auto adopt_pending_generation = [&]() {
+        // Only this thread fills the retired slot, so an empty one stays empty until the store below
+        if (retired_generation.load(std::memory_order_acquire)) return;
+        ResolverGeneration* next = pending_generation.exchange(nullptr, std::memory_order_acquire);
+        if (!next) return;
+        
+        std::string wanted = next->config.active_profile != config.active_profile ? next->config.active_profile
+                                                                                  : live->name;
+        CompiledProfile* target = find_profile(next->profiles, wanted);
+        if (!target) {
+            target = find_profile(next->profiles, next->config.active_profile);
+        }
+        go_live(target ? *target : next->profiles.front());
+        std::swap(profiles, next->profiles);  // Elements keep their addresses, so live stays valid
+        std::swap(config, next->config);
+        
+        retired_generation.store(next, std::memory_order_release);
+    };
+    
+    EventThreadLog event_log;
+    
+    // Pick up anything from a frame cut off mid-read, then emit the merged frame
+    loop.set_batch_callback([&]() {
+        resolve_frame();
+        recorder.mark_batch_end();
+        account_frame_latency(flush_outputs(LatencyStats::now_us()));
+        publish_telemetry();
+        
+        adopt_pending_generation();
+        
+        if (switch_requested) {
+            switch_requested = false;
+            go_live(profiles[(live - profiles.data() + 1) % profiles.size()]);
+            publish_telemetry();
+            event_log.line("Switched to profile %s", live->name.c_str());
+        }
+    });
+    
+    for (auto& output : outputs) {
+        OutputScheduler* scheduler = output.scheduler.get();
+        if (scheduler->get_timer_fd() >= 0 && !loop.add_fd(scheduler->get_timer_fd(), [&, scheduler](uint32_t) {
+                account_frame_latency(scheduler->on_timer(LatencyStats::now_us()));
+                publish_telemetry();
+            })) {
+            cleanup_outputs();
+            for (auto& d : input_devices) {
+                d.close_and_free();
+            }
+            return 1;
+        }
+    }
+    
+    // Device state (online, fds, routes), the resolver and the loop itself are only
+    // touched on the event thread; housekeeping hands work over with loop.post() or,
+    // for reloads, pending_generation. Housekeeping owns the reconnect backoff and
+    // device_capabilities. offline_count mirrors the online flags, and
+    // reconnect_wanted marks the offline devices housekeeping should reopen.
+    std::atomic<int> offline_count{static_cast<int>(std::count_if(
+        input_devices.begin(), input_devices.end(), [](const InputDevice& d) { return !d.online; }))};
+    std::unique_ptr<std::atomic<bool>[]> reconnect_wanted(new std::atomic<bool>[input_devices.size()]);
+    for (size_t i = 0; i < input_devices.size(); i++) {
+        reconnect_wanted[i].store(!input_devices[i].online, std::memory_order_relaxed);
+    }
+    // Housekeeping's copies of what the live profiles were built from; reloads are
+    // diffed against these. published_profiles are never fed input.
+    Config published_config = config;
+    std::vector<CompiledProfile> published_profiles;
+    for (const auto& profile : profiles) {
+        published_profiles.push_back(clone_profile(profile));
+    }
+    
+    loop.set_disconnect_callback([&](InputSource* source, int error) {
+        InputDevice& device = *static_cast<InputDevice*>(source);
+        mark_device_offline(device, error, &event_log);
+        offline_count++;
+        reconnect_wanted[&device - input_devices.data()].store(true, std::memory_order_release);
+    });
+    
+    // Hotplug: reconnect as soon as a device node or by-id link appears instead of
+    // polling. Falls back to backoff polling if /dev/input can't be watched.
+    // In real-time mode the housekeeping thread waits on it instead of the event loop.
+    HotplugMonitor hotplug;
+    std::atomic<bool> hotplug_pending{false};
+    bool hotplug_enabled = hotplug.initialize();
+    if (hotplug_enabled && !config.realtime) {
+        hotplug_enabled = loop.add_fd(hotplug.get_fd(), [&](uint32_t) {
+            if (hotplug.drain()) hotplug_pending = true;
+        });
+    }
+    if (!hotplug_enabled) {
+        hotplug.cleanup();
+        std::cerr << "Hotplug monitor unavailable, polling for reconnects\n";
+    }
+    // Config saves (e.g. from the TUI) are picked up without a SIGHUP
+    ConfigWatcher config_watcher;
+    std::atomic<bool> config_changed{false};
+    bool config_watch_enabled = !soak && config_watcher.initialize(config_path);
+    if (config_watch_enabled && !config.realtime) {
+        config_watch_enabled = loop.add_fd(config_watcher.get_fd(), [&](uint32_t) {
+            if (config_watcher.drain()) config_changed = true;
+        });
+    }
+    if (!config_watch_enabled) {
+        config_watcher.cleanup();
+        if (!soak) std::cerr << "Config file watch unavailable, use SIGHUP to reload\n";
+    }
+    
+    // udev may still be applying permissions when the link appears, so keep
+    // retrying briefly after each hotplug notification
+    const auto hotplug_settle_time = std::chrono::seconds(2);
+    auto hotplug_retry_until = std::chrono::steady_clock::time_point{};
+    
+    loop.set_raw_read(config.raw_read);
+    for (auto& dev : input_devices) {
+        if (!dev.online) {
+            continue;
+        }
+        if (!loop.add_device(&dev)) {
+            cleanup_outputs();
+            for (auto& d : input_devices) {
+                d.close_and_free();
+            }
+            return 1;
+        }
+    }
+    
+    // Housekeeping: reopen offline devices (each respects its own backoff). The
+    // event thread is only handed the open handles to register.
+    auto reconnect_offline_devices = [&]() {
+        for (size_t i = 0; i < input_devices.size(); i++) {
+            InputDevice reopened;
+            if (!reconnect_wanted[i].load(std::memory_order_acquire) ||
+                !attempt_device_reconnection(input_devices[i], reopened, published_config.grab)) {
+                continue;
+            }
+            device_capabilities[i] = capture_device_capabilities(reopened);
+            reconnect_wanted[i].store(false, std::memory_order_relaxed);
             
-            // Drain ALL available events from this device to prevent missing signals
-            struct input_event ev;
-            int rc;
-            while ((rc = libevdev_next_event(source_device->dev, LIBEVDEV_READ_FLAG_NORMAL, &ev)) == LIBEVDEV_READ_STATUS_SUCCESS) {
-                // Reset failure counter on successful read
-                source_device->consecutive_read_failures = 0;
-                events_written = false;
-                
-                switch (ev.type) {
-                    case EV_ABS: {
-                        // Look up role from code_to_role mapping (supports multiple roles per device)
-                        auto key = std::make_pair(SrcKind::Abs, static_cast<uint16_t>(ev.code));
-                        auto it = source_device->code_to_role.find(key);
-                        if (it != source_device->code_to_role.end()) {
-                            Role role = string_to_role(it->second);
-                            PhysicalInput input{role, SrcKind::Abs, static_cast<uint16_t>(ev.code)};
-                            resolver.process_input(input, ev.value);
-                        }
-                        break;
-                    }
-
-                    case EV_KEY: {
-                        // Look up role from code_to_role mapping (supports multiple roles per device)
-                        auto key = std::make_pair(SrcKind::Key, static_cast<uint16_t>(ev.code));
-                        auto it = source_device->code_to_role.find(key);
-                        if (it != source_device->code_to_role.end()) {
-                            Role role = string_to_role(it->second);
-                            PhysicalInput input{role, SrcKind::Key, static_cast<uint16_t>(ev.code)};
-                            resolver.process_input(input, ev.value);
-                        }
-                        break;
-                    }
-                    
-                    case EV_SYN:
-                        // Don't write sync yet - emit pending events first
-                        break;
+            loop.post([&, i, fd = reopened.fd, dev = reopened.dev, grabbed = reopened.grabbed,
+                       path = std::move(reopened.resolved_path)]() mutable {
+                InputDevice& device = input_devices[i];
+                device.fd = fd;
+                device.dev = dev;
+                device.grabbed = grabbed;
+                std::swap(device.resolved_path, path);
+                device.consecutive_read_failures = 0;
+                device.online = true;
+                // Reconnected devices are registered exactly once; the loop drops them on disconnect
+                if (!loop.add_device(&device)) {
+                    event_log.line("Failed to add reconnected %s to event loop", device.primary_role().c_str());
+                    device.close_and_free();
+                    device.online = false;
+                    reconnect_wanted[i].store(true, std::memory_order_release);
+                    return;
                 }
-                
-                // Emit any pending virtual events after processing input
-                auto pending_events = resolver.get_pending_events();
-                bool events_emitted = false;
-                
-                for (const auto& [slot, value] : pending_events) {
-                    struct input_event out_ev;
-                    memset(&out_ev, 0, sizeof(out_ev));
-                    out_ev.type = (slot.kind == SrcKind::Key) ? EV_KEY : EV_ABS;
-                    out_ev.code = slot.code;
-                    out_ev.value = value;
-                    
-                    if (virtual_device.write_event(out_ev)) {
-                        events_emitted = true;
-                    }
+                offline_count--;
+                seed_telemetry_from_device(telemetry, device);
+                if (&device == profile_switch.device) {
+                    profile_switch.reset();
                 }
-                
-                resolver.clear_pending_events();
-                
-                // Emit sync after all pending events are written
-                if (events_emitted || ev.type == EV_SYN) {
-                    virtual_device.emit_sync();
+            });
+        }
+    };
+    
+    // Housekeeping: turn a loaded config into a pending generation. Unless full,
+    // only what differs from the published config is rebuilt: a calibration-only
+    // change copies the published profiles and rebuilds just those axis tables,
+    // picking another active profile only selects a precompiled one, and profiles
+    // are recompiled only when their bindings changed.
+    auto publish_config = [&](Config new_config, bool full) {
+        if (restart_settings_changed(published_config, new_config)) {
+            std::cout << "Device and settings changes take effect after a restart\n";
+        }
+        
+        std::vector<std::pair<Role, AxisCalibration>> changed_calibrations;
+        bool rebuild = full || new_config.profiles != published_config.profiles ||
+                       !find_profile(published_profiles, new_config.active_profile) ||
+                       !collect_changed_calibrations(published_config, new_config, changed_calibrations);
+        bool profile_selected = new_config.active_profile != published_config.active_profile;
+        if (!rebuild && changed_calibrations.empty() && !profile_selected) {
+            std::cout << "No binding or calibration changes\n";
+            published_config = std::move(new_config);
+            return;
+        }
+        
+        auto generation = std::make_unique<ResolverGeneration>();
+        generation->config = new_config;
+        if (rebuild) {
+            std::cout << "Config reloaded. Active profile: " << new_config.active_profile << "\n";
+            
+            generation->profiles = compile_profiles(
+                load_all_profile_bindings(new_config, device_capabilities), new_config);
+            std::cout << "Compiled " << generation->profiles.size() << " profile(s) from new config\n";
+        } else {
+            for (const auto& profile : published_profiles) {
+                generation->profiles.push_back(clone_profile(profile));
+            }
+            for (auto& profile : generation->profiles) {
+                for (auto& resolver : profile.resolvers) {
+                    for (const auto& [role, cal] : changed_calibrations) {
+                        resolver->set_calibration(role, cal.src_code, cal);
+                    }
                 }
             }
-            
-            // Check the reason we exited the loop
-            if (rc == -EAGAIN) {
-                // No more data available - this is normal
-                source_device->consecutive_read_failures = 0;
-            } else if (rc != LIBEVDEV_READ_STATUS_SUCCESS) {
-                // Read error - handle device disconnection
-                handle_device_error(*source_device);
+            if (!changed_calibrations.empty()) {
+                std::cout << "Updated " << changed_calibrations.size() << " calibration(s)\n";
+            }
+            if (profile_selected) {
+                std::cout << "Switching to profile " << new_config.active_profile << "\n";
+            }
+        }
+        published_profiles.clear();
+        for (const auto& profile : generation->profiles) {
+            published_profiles.push_back(clone_profile(profile));
+        }
+        published_config = std::move(new_config);
+        
+        if (ResolverGeneration* superseded = pending_generation.exchange(generation.release(),
+                                                                         std::memory_order_acq_rel)) {
+            delete superseded;
+        }
+        loop.post([]() {});  // Wake an idle loop so the swap doesn't wait for input
+    };
+    
+    // Stats, config reload and reconnect scheduling. Runs after each loop pass in
+    // normal mode, or on the main thread while the event thread runs in real-time mode.
+    auto housekeeping = [&]() {
+        if (soak && soak->finished()) {
+            running = 0;
+        }
+        event_log.drain(std::cout);
+        
+        if (dump_stats || (stats_enabled && std::chrono::steady_clock::now() - last_stats_report >= stats_interval)) {
+            dump_stats = 0;
+            last_stats_report = std::chrono::steady_clock::now();
+            std::string report = latency.format_report();
+            std::cout << report << std::flush;
+            latency.write_report_file(LatencyStats::get_stats_path(), report);
+        }
+        
+        if (ResolverGeneration* retired = retired_generation.exchange(nullptr, std::memory_order_acquire)) {
+            delete retired;
+            if (pending_generation.load(std::memory_order_acquire)) {
+                loop.post([]() {});  // A generation waited on the slot; let the event thread adopt it
             }
         }
         
-        // Check for config reload signal
-        if (reload_config) {
+        // Config reload: SIGHUP rebuilds everything, a save seen by the file watch
+        // only what changed. The event thread only swaps in the result.
+        bool config_saved = config_changed.exchange(false);
+        if (reload_config || config_saved) {
+            bool full = reload_config;
             reload_config = 0;
-            std::cout << "\n[SIGHUP] Reloading configuration...\n";
+            std::cout << (full ? "\n[SIGHUP] Reloading configuration...\n" : "\nConfig file changed, applying...\n");
             
             auto new_config_opt = ConfigManager::load(config_path);
             if (new_config_opt) {
-                config = *new_config_opt;
-                std::cout << "Config reloaded. Active profile: " << config.active_profile << "\n";
-                
-                // Reload bindings from new config
-                auto new_active_keys = config.get_active_bindings_keys();
-                auto new_active_abs = config.get_active_bindings_abs();
-                if (!new_active_keys.empty() || !new_active_abs.empty()) {
-                    auto new_bindings = make_bindings_from_config(new_active_keys, new_active_abs);
-                    
-                    std::vector<Binding> valid_bindings;
-                    for (const auto& binding : new_bindings) {
-                        if (validate_bindings({binding})) {
-                            valid_bindings.push_back(binding);
-                        }
-                    }
-                    
-                    if (!valid_bindings.empty()) {
-                        bindings = valid_bindings;
-                        validate_and_filter_bindings(bindings, input_devices);
-                        resolver = BindingResolver(bindings);
-                        std::cout << "Loaded " << bindings.size() << " bindings from new config\n";
-                        
-                        // Reload calibrations
-                        for (const auto& [role_str, axes] : config.calibrations) {
-                            Role role;
-                            if (role_str == "stick") role = Role::Stick;
-                            else if (role_str == "throttle") role = Role::Throttle;
-                            else if (role_str == "rudder") role = Role::Rudder;
-                            else continue;
-                            
-                            for (const auto& [axis_code, cal] : axes) {
-                                resolver.set_calibration(role, cal.src_code, cal);
-                            }
-                        }
-                    }
-                }
+                publish_config(std::move(*new_config_opt), full);
             } else {
                 std::cerr << "Failed to reload config\n";
             }
         }
         
         // Try to reconnect any offline devices
-        for (auto& device : input_devices) {
-            attempt_device_reconnection(device);
-            
-            // If device came back online, add it to epoll
-            if (device.online && device.fd >= 0) {
-                struct epoll_event event;
-                event.events = EPOLLIN;
-                event.data.fd = device.fd;
-                if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, device.fd, &event) < 0) {
-                    if (errno != EEXIST) { // EEXIST means already added
-                        perror("Failed to add reconnected device to epoll");
-                    }
+        if (hotplug_pending.exchange(false)) {
+            hotplug_retry_until = std::chrono::steady_clock::now() + hotplug_settle_time;
+            for (auto& device : input_devices) {
+                device.reconnect_backoff_ms = 0;  // Try right away
+            }
+        }
+        
+        if (offline_count == 0 || (hotplug_enabled && std::chrono::steady_clock::now() >= hotplug_retry_until)) {
+            return;
+        }
+        reconnect_offline_devices();
+    };
+    
+    // Short ticks only while reconnects are being retried; otherwise just
+    // wake up often enough to notice SIGHUP/SIGTERM set between waits
+    auto housekeeping_timeout_ms = [&]() {
+        bool polling = offline_count > 0 &&
+                       (!hotplug_enabled || std::chrono::steady_clock::now() < hotplug_retry_until);
+        return polling ? 100 : 1000;
+    };
+    
+    // Devices are in the loop, so the soak generator can start writing
+    if (soak) {
+        std::vector<PhysicalInput> excluded;
+        for (uint16_t code : profile_switch.buttons) {
+            excluded.push_back({string_to_role(config.profile_switch.role), SrcKind::Key, code});
+        }
+        if (!soak->plan(soak_bindings, excluded) || !soak->start(outputs[0].device->event_node())) {
+            cleanup_outputs();
+            loop.cleanup();
+            for (auto& d : input_devices) {
+                d.close_and_free();
+            }
+            return 1;
+        }
+    }
+    
+    if (!config.realtime) {
+        while (running) {
+            if (loop.run_once(housekeeping_timeout_ms()) < 0) {
+                break;
+            }
+            housekeeping();
+        }
+    } else {
+        // Real-time mode: the event thread only translates events and runs posted
+        // tasks. It blocks all signals so SIGHUP/SIGTERM/SIGUSR1 land here.
+        sigset_t all_signals, previous_signals;
+        sigfillset(&all_signals);
+        pthread_sigmask(SIG_BLOCK, &all_signals, &previous_signals);
+        std::thread event_thread([&]() {
+            if (make_current_thread_realtime(config.realtime_priority, config.realtime_cpu)) {
+                std::cout << "Event thread running SCHED_FIFO priority " << config.realtime_priority;
+                if (config.realtime_cpu >= 0) std::cout << " on CPU " << config.realtime_cpu;
+                std::cout << "\n";
+            }
+            while (running) {
+                if (loop.run_once(1000) < 0) {
+                    running = 0;
+                }
+            }
+        });
+        pthread_sigmask(SIG_SETMASK, &previous_signals, nullptr);
+        
+        if (config.lock_memory && lock_process_memory()) {
+            std::cout << "Locked mapper memory (mlockall)\n";
+        }
+        
+        while (running) {
+            int timeout_ms = housekeeping_timeout_ms();
+            // Disabled watchers have fd -1, which poll() skips
+            struct pollfd pfds[2] = {{hotplug.get_fd(), POLLIN, 0}, {config_watcher.get_fd(), POLLIN, 0}};
+            if (hotplug_enabled || config_watch_enabled) {
+                if (poll(pfds, 2, timeout_ms) > 0) {
+                    if ((pfds[0].revents & POLLIN) && hotplug.drain()) hotplug_pending = true;
+                    if ((pfds[1].revents & POLLIN) && config_watcher.drain()) config_changed = true;
                 }
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
             }
+            housekeeping();
         }
+        
+        loop.post([]() {});  // Wake the event thread so it sees running == 0
+        event_thread.join();
     }
 
+    event_log.drain(std::cout);
     std::cout << "Exiting...\n";
+    if (soak) {
+        soak->stop();  // Before the virtual controller it reads goes away
+    }
     
     // Clean up
-    virtual_device.cleanup();
-    close(epoll_fd);
+    delete pending_generation.exchange(nullptr);
+    delete retired_generation.exchange(nullptr);
+    telemetry.close();
+    cleanup_outputs();
+    loop.cleanup();
     for (auto& dev : input_devices) {
-        libevdev_free(dev.dev);
-        close(dev.fd);
+        dev.close_and_free();
     }
     
+    if (soak) {
+        std::cout << "\n" << latency.format_report();
+        return soak->report();
+    }
     return 0;
 }
\ No newline at end of file
@@ -1,12 +1,9 @@
 #include "config.hpp"
+#include "device_identity.hpp"
 #include <iostream>
 #include <vector>
 #include <string>
 #include <filesystem>
-#include <cstdio>
-#include <memory>
-#include <array>
-#include <sstream>
 #include <limits.h>
 
 struct DeviceInfo {
@@ -18,33 +15,6 @@ struct DeviceInfo {
     std::string path;
 };
 
-std::string exec_command(const std::string& cmd) {
-    std::array<char, 128> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-    if (!pipe) {
-        return "";
-    }
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-        result += buffer.data();
-    }
-    return result;
-}
-
-std::string get_udev_property(const std::string& device_path, const std::string& property) {
-    std::string cmd = "udevadm info -q property -n " + device_path + " 2>/dev/null";
-    std::string output = exec_command(cmd);
-    
-    std::istringstream iss(output);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.substr(0, property.length() + 1) == property + "=") {
-            return line.substr(property.length() + 1);
-        }
-    }
-    return "";
-}
-
 std::vector<DeviceInfo> enumerate_devices() {
     std::vector<DeviceInfo> devices;
     
@@ -66,15 +36,13 @@ std::vector<DeviceInfo> enumerate_devices() {
                 continue;
             }
             
-            // Get udev properties
-            info.vendor_id = get_udev_property(info.event_path, "ID_VENDOR_ID");
-            info.model_id = get_udev_property(info.event_path, "ID_MODEL_ID");
-            info.name = get_udev_property(info.event_path, "NAME");
-            info.path = get_udev_property(info.event_path, "ID_PATH");
-            
-            // Clean up the name (remove quotes if present)
-            if (!info.name.empty() && info.name.front() == '"' && info.name.back() == '"') {
-                info.name = info.name.substr(1, info.name.length() - 2);
+            // Read identity straight from sysfs
+            auto identity = read_device_identity(info.event_path);
+            if (identity) {
+                info.vendor_id = identity->vendor;
+                info.model_id = identity->product;
+                info.name = identity->name;
+                info.path = identity->phys;
             }
             
             devices.push_back(info);
@@ -1,5 +1,8 @@
 #include "config.hpp"
 #include "bindings.hpp"
+#include "device_identity.hpp"
+#include "axis_sampler.hpp"
+#include "device_discovery.hpp"
 #include <linux/input.h>
 #include <linux/input-event-codes.h>
 #include <libevdev-1.0/libevdev/libevdev.h>
@@ -142,28 +145,6 @@ int get_user_choice(int max_index, int default_choice = 0) {
     }
 }
 
-std::string get_udev_property(const std::string& device_path, const std::string& property) {
-    std::string cmd = "udevadm info -q property -n " + device_path + " 2>/dev/null";
-    FILE* pipe = popen(cmd.c_str(), "r");
-    if (!pipe) return "";
-    
-    std::string output;
-    char buffer[128];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        output += buffer;
-    }
-    pclose(pipe);
-    
-    std::istringstream iss(output);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.substr(0, property.length() + 1) == property + "=") {
-            return line.substr(property.length() + 1);
-        }
-    }
-    return "";
-}
-
 static bool check_fd_not_grabbed(int fd, const std::string& path, std::string& err) {
     errno = 0;
     if (ioctl(fd, EVIOCGRAB, 1) == 0) {
@@ -247,45 +228,31 @@ std::string detect_device_role(const DeviceInfo& device) {
 std::vector<DeviceInfo> detect_devices() {
     std::vector<DeviceInfo> devices;
     
-    // Enumerate /dev/input/by-id/
+    // Enumerate /dev/input/by-id/ and probe every node concurrently
     const char* by_id_dir = "/dev/input/by-id";
-    DIR* dir = opendir(by_id_dir);
-    if (!dir) {
+    auto links = DeviceDiscovery::list_event_links(by_id_dir);
+    if (links.empty()) {
         std::cerr << "Failed to open " << by_id_dir << "\n";
         return devices;
     }
     
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (strstr(entry->d_name, "event") == nullptr) continue;
-        
-        std::string by_id_path = std::string(by_id_dir) + "/" + entry->d_name;
-        char real_path[PATH_MAX];
-        if (realpath(by_id_path.c_str(), real_path) == nullptr) continue;
-        
-        int fd = open(real_path, O_RDONLY | O_NONBLOCK);
-        if (fd < 0) continue;
-        
-        struct libevdev* dev = nullptr;
-        if (libevdev_new_from_fd(fd, &dev) != 0) {
-            close(fd);
-            continue;
-        }
+    DeviceDiscovery discovery;
+    for (auto& probe : discovery.scan(links)) {
+        if (!probe.ok()) continue;
         
         // No filtering - detect all devices with event interface
         
         DeviceInfo info;
-        info.path = real_path;
-        info.by_id = by_id_path;
-        info.fd = fd;
-        info.dev = dev;
-        info.vendor = get_udev_property(real_path, "ID_VENDOR_ID");
-        info.product = get_udev_property(real_path, "ID_MODEL_ID");
+        info.path = probe.path;
+        info.by_id = probe.by_id;
+        info.fd = probe.fd;
+        info.dev = probe.dev;
+        info.vendor = probe.vendor;
+        info.product = probe.product;
         info.role = "";  // No role assigned yet
         
         devices.push_back(info);
     }
-    closedir(dir);
     
     // Sort by preference (Thrustmaster devices first, keyboards/mice last)
     std::sort(devices.begin(), devices.end(), [](const DeviceInfo& a, const DeviceInfo& b) {
@@ -321,53 +288,39 @@ std::vector<DeviceInfo> detect_devices() {
 std::vector<DeviceInfo> build_devices_from_config_inputs(const Config& cfg) {
     std::vector<DeviceInfo> devices;
     
+    std::vector<std::string> links;
+    std::vector<const DeviceConfig*> inputs;
     for (const auto& [role, input_config] : cfg.devices) {
         if (input_config.by_id.empty()) {
             std::cout << "Skipping " << role << " (no by_id path configured)\n";
             continue;
         }
-        
-        // Resolve by_id symlink to real event path
-        char real_path[PATH_MAX];
-        if (realpath(input_config.by_id.c_str(), real_path) == nullptr) {
-            std::cerr << "ERROR: Failed to resolve " << input_config.role << " path: " << input_config.by_id << "\n";
-            continue;
-        }
-        
-        // Open device
-        int fd = open(real_path, O_RDONLY | O_NONBLOCK);
-        if (fd < 0) {
-            std::cerr << "ERROR: Failed to open " << input_config.role << ": " << input_config.by_id << " (" << strerror(errno) << ")\n";
-            continue;
-        }
-        
-        // Initialize libevdev
-        struct libevdev* dev = nullptr;
-        if (libevdev_new_from_fd(fd, &dev) != 0) {
-            std::cerr << "ERROR: Failed to initialize " << input_config.role << ": " << input_config.by_id << "\n";
-            close(fd);
+        links.push_back(input_config.by_id);
+        inputs.push_back(&input_config);
+    }
+    
+    // Resolve and open every configured device at once
+    DeviceDiscovery discovery;
+    auto probes = discovery.scan(links);
+    
+    for (size_t i = 0; i < probes.size(); i++) {
+        const DeviceConfig& input_config = *inputs[i];
+        auto& probe = probes[i];
+        if (!probe.ok()) {
+            std::cerr << "ERROR: " << input_config.role << ": " << probe.error << "\n";
             continue;
         }
         
         // Create DeviceInfo from config (do NOT infer role)
         DeviceInfo info;
-        info.path = real_path;
+        info.path = probe.path;
         info.by_id = input_config.by_id;
-        info.fd = fd;
-        info.dev = dev;
+        info.fd = probe.fd;
+        info.dev = probe.dev;
         
-        // Use config values first, fallback to udev if needed
-        if (!input_config.vendor.empty()) {
-            info.vendor = input_config.vendor;
-        } else {
-            info.vendor = get_udev_property(real_path, "ID_VENDOR_ID");
-        }
-        
-        if (!input_config.product.empty()) {
-            info.product = input_config.product;
-        } else {
-            info.product = get_udev_property(real_path, "ID_MODEL_ID");
-        }
+        // Use config values first, fallback to sysfs if needed
+        info.vendor = input_config.vendor.empty() ? probe.vendor : input_config.vendor;
+        info.product = input_config.product.empty() ? probe.product : input_config.product;
         
         info.role = input_config.role; // Use config role, do NOT infer
         
@@ -450,119 +403,61 @@ std::map<std::string, DeviceInfo> select_devices_per_role(const std::vector<Devi
     return selected_devices;
 }
 
-int detect_axis(DeviceInfo& device, const std::string& axis_name, int capture_time_ms = 4000) {
-    const int JITTER_THRESHOLD = 100;  // Increased from 32 to reduce false detections
-    const int MIN_MOVEMENT = 5000;      // Require significant movement
-    std::map<int, int> delta_sum;
-    struct input_event ev;
-    
-    // Drain pending events first
-    while (libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-        // Just drain the queue
-    }
-    
-    // Get initial values as baseline
-    std::map<int, int> baseline_values;
-    for (int code = 0; code <= ABS_MAX; code++) {
-        if (libevdev_has_event_code(device.dev, EV_ABS, code)) {
-            const struct input_absinfo* absinfo = libevdev_get_abs_info(device.dev, code);
-            if (absinfo) {
-                baseline_values[code] = absinfo->value;
-                delta_sum[code] = 0;
-            }
-        }
-    }
-    
-    auto start = std::chrono::steady_clock::now();
-    
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(capture_time_ms)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            int baseline = baseline_values[ev.code];
-            int delta = std::abs(ev.value - baseline);
-            
-            if (delta >= JITTER_THRESHOLD) {
-                delta_sum[ev.code] += delta;
-            }
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
-    }
-    
-    // Show all detected movement for debugging
+// Prints accumulated movement per axis, for seeing what a capture picked up
+static void print_axis_movement(const AxisSampler& sampler) {
     std::cout << "  Movement detected:\n";
-    for (const auto& [code, delta] : delta_sum) {
-        if (delta > 0) {
+    for (int code = 0; code < ABS_CNT; code++) {
+        if (sampler.has_axis(code) && sampler.movement(code) > 0) {
             const char* axis_name = libevdev_event_code_get_name(EV_ABS, code);
             std::cout << "    Axis " << code << " (" << (axis_name ? axis_name : "UNKNOWN") 
-                     << "): " << delta << " units\n";
+                     << "): " << sampler.movement(code) << " units\n";
         }
     }
-    
-    // Find axis with highest delta
-    int best_code = -1;
-    int max_delta = 0;
-    for (const auto& [code, delta] : delta_sum) {
-        if (delta > max_delta) {
-            max_delta = delta;
-            best_code = code;
-        }
+}
+
+// Most-moved axis, or -1 if it moved less than min_movement
+static int pick_moved_axis(const AxisSampler& sampler, int64_t min_movement) {
+    int best_code = sampler.most_moved_axis();
+    int64_t max_delta = best_code >= 0 ? sampler.movement(best_code) : 0;
+    if (max_delta < min_movement) {
+        std::cout << "  WARNING: Movement too small (" << max_delta << " < " << min_movement << ")\n";
+        return -1;
     }
+    return best_code;
+}
+
+int detect_axis(DeviceInfo& device, const std::string& axis_name, int capture_time_ms = 4000) {
+    const int JITTER_THRESHOLD = 100;  // Increased from 32 to reduce false detections
+    const int MIN_MOVEMENT = 5000;      // Require significant movement
     
-    // Require minimum movement
-    if (max_delta < MIN_MOVEMENT) {
-        std::cout << "  WARNING: Movement too small (" << max_delta << " < " << MIN_MOVEMENT << ")\n";
+    AxisSampler sampler;
+    if (!sampler.open(device.path)) {
         return -1;
     }
+    sampler.reset(JITTER_THRESHOLD);
+    sampler.run_for(capture_time_ms);
     
-    return best_code;
+    print_axis_movement(sampler);
+    return pick_moved_axis(sampler, MIN_MOVEMENT);
 }
 
 std::pair<int, int> detect_two_axes(DeviceInfo& device, const std::string& description, int capture_time_ms = 2000) {
     const int JITTER_THRESHOLD = 32;
-    std::map<int, int> delta_sum;
-    struct input_event ev;
-    
-    // Drain pending events first
-    while (libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-        // Just drain the queue
-    }
-    
-    // Get initial values as baseline
-    std::map<int, int> baseline_values;
-    for (int code = 0; code <= ABS_MAX; code++) {
-        if (libevdev_has_event_code(device.dev, EV_ABS, code)) {
-            const struct input_absinfo* absinfo = libevdev_get_abs_info(device.dev, code);
-            if (absinfo) {
-                baseline_values[code] = absinfo->value;
-                delta_sum[code] = 0;
-            }
-        }
-    }
-    
-    auto start = std::chrono::steady_clock::now();
     
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(capture_time_ms)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            int baseline = baseline_values[ev.code];
-            int delta = std::abs(ev.value - baseline);
-            
-            if (delta >= JITTER_THRESHOLD) {
-                delta_sum[ev.code] += delta;
-            }
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+    AxisSampler sampler;
+    if (!sampler.open(device.path)) {
+        return {-1, -1};
     }
+    sampler.reset(JITTER_THRESHOLD);
+    sampler.run_for(capture_time_ms);
     
     // Find two axes with highest deltas
     int first_code = -1, second_code = -1;
-    int first_delta = 0, second_delta = 0;
+    int64_t first_delta = 0, second_delta = 0;
     
-    for (const auto& [code, delta] : delta_sum) {
+    for (int code = 0; code < ABS_CNT; code++) {
+        if (!sampler.has_axis(code)) continue;
+        int64_t delta = sampler.movement(code);
         if (delta > first_delta) {
             second_delta = first_delta;
             second_code = first_code;
@@ -578,11 +473,9 @@ std::pair<int, int> detect_two_axes(DeviceInfo& device, const std::string& descr
 }
 
 std::optional<AxisCalibration> calibrate_detected_axis(DeviceInfo& device, int axis_code, const std::string& axis_name) {
-    struct input_event ev;
-    
-    // Drain pending events first
-    while (libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-        // Just drain the queue
+    AxisSampler sampler;
+    if (!sampler.open(device.path) || !sampler.has_axis(axis_code)) {
+        return std::nullopt;
     }
     
     std::cout << "  Calibrating axis " << axis_code << " (" << axis_name << ")\n";
@@ -592,37 +485,9 @@ std::optional<AxisCalibration> calibrate_detected_axis(DeviceInfo& device, int a
     std::cout << "  Press ENTER when ready...";
     get_line_input();
     
-    std::vector<int> center_samples;
-    int center_min = INT_MAX;
-    int center_max = INT_MIN;
-    
-    // Get initial value
-    const struct input_absinfo* absinfo = libevdev_get_abs_info(device.dev, axis_code);
-    if (absinfo) {
-        center_samples.push_back(absinfo->value);
-        center_min = absinfo->value;
-        center_max = absinfo->value;
-    }
-    
-    auto start = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(5000)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS && ev.code == axis_code) {
-            center_samples.push_back(ev.value);
-            center_min = std::min(center_min, ev.value);
-            center_max = std::max(center_max, ev.value);
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    }
-    
-    // Calculate center value and deadzone
-    long long sum = 0;
-    for (int val : center_samples) {
-        sum += val;
-    }
-    int center_value = center_samples.empty() ? 0 : sum / center_samples.size();
+    sampler.reset();
+    sampler.run_for(5000);
+    int center_value = sampler.stats(axis_code).center();
     int deadzone_radius = 10;  // Fixed deadzone for centered axes
     
     // Step 2: Measure full range
@@ -630,27 +495,10 @@ std::optional<AxisCalibration> calibrate_detected_axis(DeviceInfo& device, int a
     std::cout << "  Press ENTER when ready...";
     get_line_input();
     
-    int range_min = center_value;
-    int range_max = center_value;
-    
-    // Get current value as starting point
-    absinfo = libevdev_get_abs_info(device.dev, axis_code);
-    if (absinfo) {
-        range_min = absinfo->value;
-        range_max = absinfo->value;
-    }
-    
-    start = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10000)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS && ev.code == axis_code) {
-            range_min = std::min(range_min, ev.value);
-            range_max = std::max(range_max, ev.value);
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    }
+    sampler.reset();
+    sampler.run_for(10000);
+    int range_min = sampler.stats(axis_code).min();
+    int range_max = sampler.stats(axis_code).max();
     
     // Show results to user
     std::cout << "  Observed MIN: " << range_min << "\n";
@@ -677,82 +525,25 @@ std::optional<AxisCalibration> calibrate_detected_axis(DeviceInfo& device, int a
 std::pair<int, std::optional<AxisCalibration>> detect_and_calibrate_throttle_axis(DeviceInfo& device, const std::string& axis_name, int capture_time_ms = 6000) {
     const int JITTER_THRESHOLD = 100;
     const int MIN_MOVEMENT = 5000;
-    std::map<int, int> delta_sum;
-    std::map<int, int> range_min;
-    std::map<int, int> range_max;
-    struct input_event ev;
-    
-    // Drain pending events first
-    while (libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-        // Just drain the queue
-    }
-    
-    // Get initial values as baseline and initialize min/max tracking
-    std::map<int, int> baseline_values;
-    for (int code = 0; code <= ABS_MAX; code++) {
-        if (libevdev_has_event_code(device.dev, EV_ABS, code)) {
-            const struct input_absinfo* absinfo = libevdev_get_abs_info(device.dev, code);
-            if (absinfo) {
-                baseline_values[code] = absinfo->value;
-                delta_sum[code] = 0;
-                range_min[code] = absinfo->value;
-                range_max[code] = absinfo->value;
-            }
-        }
-    }
-    
-    auto start = std::chrono::steady_clock::now();
     
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(capture_time_ms)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            int baseline = baseline_values[ev.code];
-            int delta = std::abs(ev.value - baseline);
-            
-            if (delta >= JITTER_THRESHOLD) {
-                delta_sum[ev.code] += delta;
-            }
-            
-            // Track min/max for all axes
-            range_min[ev.code] = std::min(range_min[ev.code], ev.value);
-            range_max[ev.code] = std::max(range_max[ev.code], ev.value);
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
-    }
-    
-    // Show all detected movement for debugging
-    std::cout << "  Movement detected:\n";
-    for (const auto& [code, delta] : delta_sum) {
-        if (delta > 0) {
-            const char* axis_name_str = libevdev_event_code_get_name(EV_ABS, code);
-            std::cout << "    Axis " << code << " (" << (axis_name_str ? axis_name_str : "UNKNOWN") 
-                     << "): " << delta << " units\n";
-        }
-    }
-    
-    // Find axis with highest delta
-    int best_code = -1;
-    int max_delta = 0;
-    for (const auto& [code, delta] : delta_sum) {
-        if (delta > max_delta) {
-            max_delta = delta;
-            best_code = code;
-        }
+    AxisSampler sampler;
+    if (!sampler.open(device.path)) {
+        return {-1, std::nullopt};
     }
+    sampler.reset(JITTER_THRESHOLD);
+    sampler.run_for(capture_time_ms);
     
-    // Require minimum movement
-    if (max_delta < MIN_MOVEMENT) {
-        std::cout << "  WARNING: Movement too small (" << max_delta << " < " << MIN_MOVEMENT << ")\n";
+    print_axis_movement(sampler);
+    int best_code = pick_moved_axis(sampler, MIN_MOVEMENT);
+    if (best_code < 0) {
         return {-1, std::nullopt};
     }
     
     std::cout << "Detected axis code: " << best_code << "\n";
     
     // Use the captured min/max from the detection phase
-    int obs_min = range_min[best_code];
-    int obs_max = range_max[best_code];
+    int obs_min = sampler.stats(best_code).min();
+    int obs_max = sampler.stats(best_code).max();
     
     std::cout << "  Observed MIN (0%): " << obs_min << "\n";
     std::cout << "  Observed MAX (100%): " << obs_max << "\n";
@@ -779,99 +570,35 @@ std::pair<int, std::optional<AxisCalibration>> detect_and_calibrate_throttle_axi
 std::pair<int, int> detect_axis_and_center_only(DeviceInfo& device, int capture_time_ms = 3000) {
     const int JITTER_THRESHOLD = 100;
     const int MIN_MOVEMENT = 3000;
-    std::map<int, int> delta_sum;
-    std::map<int, std::vector<int>> center_samples;
-    std::map<int, int> baseline_values;
-    struct input_event ev;
-    
-    // Drain pending events first
-    while (libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-        // Just drain the queue
-    }
-    
-    // Get initial values as baseline
-    for (int code = 0; code <= ABS_MAX; code++) {
-        if (libevdev_has_event_code(device.dev, EV_ABS, code)) {
-            const struct input_absinfo* absinfo = libevdev_get_abs_info(device.dev, code);
-            if (absinfo) {
-                baseline_values[code] = absinfo->value;
-                delta_sum[code] = 0;
-            }
-        }
+    
+    AxisSampler sampler;
+    if (!sampler.open(device.path)) {
+        return {-1, 0};
     }
+    sampler.reset(JITTER_THRESHOLD);
     
     // Sample center values at the beginning (first 1 second while user holds still)
-    auto start = std::chrono::steady_clock::now();
-    auto center_end = start + std::chrono::milliseconds(1000);
-    
     std::cout << "  Sampling center position (hold still)...\n";
-    while (std::chrono::steady_clock::now() < center_end) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            center_samples[ev.code].push_back(ev.value);
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
+    sampler.run_for(std::min(1000, capture_time_ms));
+    std::vector<int> centers(ABS_CNT, 0);
+    for (int code = 0; code < ABS_CNT; code++) {
+        if (sampler.has_axis(code)) centers[code] = sampler.stats(code).center();
     }
     
-    std::cout << "  Now move the axis to detect it...\n";
-    
     // Now capture movement for remaining time (user moves the axis)
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(capture_time_ms)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            int baseline = baseline_values[ev.code];
-            int delta = std::abs(ev.value - baseline);
-            
-            if (delta >= JITTER_THRESHOLD) {
-                delta_sum[ev.code] += delta;
-            }
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
-    }
-    
-    // Show all detected movement for debugging
-    std::cout << "  Movement detected:\n";
-    for (const auto& [code, delta] : delta_sum) {
-        if (delta > 0) {
-            const char* axis_name_str = libevdev_event_code_get_name(EV_ABS, code);
-            std::cout << "    Axis " << code << " (" << (axis_name_str ? axis_name_str : "UNKNOWN") 
-                     << "): " << delta << " units\n";
-        }
-    }
-    
-    // Find axis with highest delta
-    int best_code = -1;
-    int max_delta = 0;
-    for (const auto& [code, delta] : delta_sum) {
-        if (delta > max_delta) {
-            max_delta = delta;
-            best_code = code;
-        }
-    }
+    std::cout << "  Now move the axis to detect it...\n";
+    sampler.run_for(std::max(0, capture_time_ms - 1000));
     
-    // Require minimum movement
-    if (max_delta < MIN_MOVEMENT) {
-        std::cout << "  WARNING: Movement too small (" << max_delta << " < " << MIN_MOVEMENT << ")\n";
+    print_axis_movement(sampler);
+    int best_code = pick_moved_axis(sampler, MIN_MOVEMENT);
+    if (best_code < 0) {
         return {-1, 0};
     }
     
     std::cout << "Detected axis code: " << best_code << "\n";
     
-    // Calculate center value from initial samples (when user was holding still)
-    int center_value = baseline_values[best_code];
-    
-    if (!center_samples[best_code].empty()) {
-        long long sum = 0;
-        for (int val : center_samples[best_code]) {
-            sum += val;
-        }
-        center_value = sum / center_samples[best_code].size();
-    }
-    
+    // Center value from the initial samples (when user was holding still)
+    int center_value = centers[best_code];
     std::cout << "Center value: " << center_value << "\n";
     
     return {best_code, center_value};
@@ -880,114 +607,37 @@ std::pair<int, int> detect_axis_and_center_only(DeviceInfo& device, int capture_
 std::pair<int, std::optional<AxisCalibration>> detect_and_calibrate_centered_axis(DeviceInfo& device, const std::string& axis_name, int capture_time_ms = 6000, bool offer_midpoint = false) {
     const int JITTER_THRESHOLD = 100;
     const int MIN_MOVEMENT = 5000;
-    std::map<int, int> delta_sum;
-    std::map<int, int> range_min;
-    std::map<int, int> range_max;
-    std::vector<std::map<int, int>> center_samples_map;
-    struct input_event ev;
-    
-    // Drain pending events first
-    while (libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-        // Just drain the queue
-    }
-    
-    // Get initial values as baseline and initialize tracking
-    std::map<int, int> baseline_values;
-    for (int code = 0; code <= ABS_MAX; code++) {
-        if (libevdev_has_event_code(device.dev, EV_ABS, code)) {
-            const struct input_absinfo* absinfo = libevdev_get_abs_info(device.dev, code);
-            if (absinfo) {
-                baseline_values[code] = absinfo->value;
-                delta_sum[code] = 0;
-                range_min[code] = absinfo->value;
-                range_max[code] = absinfo->value;
-            }
-        }
+    
+    AxisSampler sampler;
+    if (!sampler.open(device.path)) {
+        return {-1, std::nullopt};
     }
+    sampler.reset(JITTER_THRESHOLD);
     
     // Sample center values at the beginning (first 1 second)
-    auto start = std::chrono::steady_clock::now();
-    auto center_end = start + std::chrono::milliseconds(1000);
-    std::map<int, std::vector<int>> center_samples;
-    
-    while (std::chrono::steady_clock::now() < center_end) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            center_samples[ev.code].push_back(ev.value);
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
+    sampler.run_for(std::min(1000, capture_time_ms));
+    std::vector<int> centers(ABS_CNT, 0);
+    for (int code = 0; code < ABS_CNT; code++) {
+        if (sampler.has_axis(code)) centers[code] = sampler.stats(code).center();
     }
     
     // Now capture movement for remaining time
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(capture_time_ms)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            int baseline = baseline_values[ev.code];
-            int delta = std::abs(ev.value - baseline);
-            
-            if (delta >= JITTER_THRESHOLD) {
-                delta_sum[ev.code] += delta;
-            }
-            
-            // Track min/max for all axes
-            range_min[ev.code] = std::min(range_min[ev.code], ev.value);
-            range_max[ev.code] = std::max(range_max[ev.code], ev.value);
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
-    }
-    
-    // Show all detected movement for debugging
-    std::cout << "  Movement detected:\n";
-    for (const auto& [code, delta] : delta_sum) {
-        if (delta > 0) {
-            const char* axis_name_str = libevdev_event_code_get_name(EV_ABS, code);
-            std::cout << "    Axis " << code << " (" << (axis_name_str ? axis_name_str : "UNKNOWN") 
-                     << "): " << delta << " units\n";
-        }
-    }
-    
-    // Find axis with highest delta
-    int best_code = -1;
-    int max_delta = 0;
-    for (const auto& [code, delta] : delta_sum) {
-        if (delta > max_delta) {
-            max_delta = delta;
-            best_code = code;
-        }
-    }
+    sampler.run_for(std::max(0, capture_time_ms - 1000));
     
-    // Require minimum movement
-    if (max_delta < MIN_MOVEMENT) {
-        std::cout << "  WARNING: Movement too small (" << max_delta << " < " << MIN_MOVEMENT << ")\n";
+    print_axis_movement(sampler);
+    int best_code = pick_moved_axis(sampler, MIN_MOVEMENT);
+    if (best_code < 0) {
         return {-1, std::nullopt};
     }
     
     std::cout << "Detected axis code: " << best_code << "\n";
     
-    // Calculate center value from initial samples
-    int center_value = baseline_values[best_code];
-    int center_min = center_value;
-    int center_max = center_value;
-    
-    if (!center_samples[best_code].empty()) {
-        long long sum = 0;
-        for (int val : center_samples[best_code]) {
-            sum += val;
-            center_min = std::min(center_min, val);
-            center_max = std::max(center_max, val);
-        }
-        center_value = sum / center_samples[best_code].size();
-    }
-    
+    int center_value = centers[best_code];
     int deadzone_radius = 10;  // Fixed deadzone for centered axes
     
     // Use the captured min/max from the detection phase
-    int obs_min = range_min[best_code];
-    int obs_max = range_max[best_code];
+    int obs_min = sampler.stats(best_code).min();
+    int obs_max = sampler.stats(best_code).max();
     
     std::cout << "  Observed MIN: " << obs_min << "\n";
     std::cout << "  Observed MAX: " << obs_max << "\n";
@@ -1055,11 +705,9 @@ std::pair<int, std::optional<AxisCalibration>> detect_and_calibrate_centered_axi
 }
 
 std::optional<AxisCalibration> calibrate_throttle_axis(DeviceInfo& device, int axis_code, const std::string& axis_name) {
-    struct input_event ev;
-    
-    // Drain pending events first
-    while (libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-        // Just drain the queue
+    AxisSampler sampler;
+    if (!sampler.open(device.path) || !sampler.has_axis(axis_code)) {
+        return std::nullopt;
     }
     
     std::cout << "  Calibrating axis " << axis_code << " (" << axis_name << ")\n";
@@ -1067,27 +715,10 @@ std::optional<AxisCalibration> calibrate_throttle_axis(DeviceInfo& device, int a
     std::cout << "  Press ENTER when ready...";
     get_line_input();
     
-    int range_min = INT_MAX;
-    int range_max = INT_MIN;
-    
-    // Get current value as starting point
-    const struct input_absinfo* absinfo = libevdev_get_abs_info(device.dev, axis_code);
-    if (absinfo) {
-        range_min = absinfo->value;
-        range_max = absinfo->value;
-    }
-    
-    auto start = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10000)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS && ev.code == axis_code) {
-            range_min = std::min(range_min, ev.value);
-            range_max = std::max(range_max, ev.value);
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    }
+    sampler.reset();
+    sampler.run_for(10000);
+    int range_min = sampler.stats(axis_code).min();
+    int range_max = sampler.stats(axis_code).max();
     
     // Show results to user
     std::cout << "  Observed MIN (0%): " << range_min << "\n";
@@ -1113,11 +744,9 @@ std::optional<AxisCalibration> calibrate_throttle_axis(DeviceInfo& device, int a
 std::pair<std::optional<AxisCalibration>, std::optional<AxisCalibration>> calibrate_two_axes(
     DeviceInfo& device, int axis1_code, int axis2_code, const std::string& description) {
     
-    struct input_event ev;
-    
-    // Drain pending events first
-    while (libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-        // Just drain the queue
+    AxisSampler sampler;
+    if (!sampler.open(device.path) || !sampler.has_axis(axis1_code) || !sampler.has_axis(axis2_code)) {
+        return {std::nullopt, std::nullopt};
     }
     
     std::cout << "  Calibrating axes " << axis1_code << " and " << axis2_code << " (" << description << ")\n";
@@ -1127,79 +756,28 @@ std::pair<std::optional<AxisCalibration>, std::optional<AxisCalibration>> calibr
     std::cout << "  Press ENTER when ready...";
     get_line_input();
     
-    std::vector<int> center_samples1, center_samples2;
-    int center_min1 = INT_MAX, center_max1 = INT_MIN;
-    int center_min2 = INT_MAX, center_max2 = INT_MIN;
-    
-    // Get initial values
-    const struct input_absinfo* absinfo1 = libevdev_get_abs_info(device.dev, axis1_code);
-    const struct input_absinfo* absinfo2 = libevdev_get_abs_info(device.dev, axis2_code);
-    if (absinfo1) {
-        center_samples1.push_back(absinfo1->value);
-        center_min1 = absinfo1->value;
-        center_max1 = absinfo1->value;
-    }
-    if (absinfo2) {
-        center_samples2.push_back(absinfo2->value);
-        center_min2 = absinfo2->value;
-        center_max2 = absinfo2->value;
-    }
-    
-    auto start = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(5000)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            if (ev.code == axis1_code) {
-                center_samples1.push_back(ev.value);
-                center_min1 = std::min(center_min1, ev.value);
-                center_max1 = std::max(center_max1, ev.value);
-            } else if (ev.code == axis2_code) {
-                center_samples2.push_back(ev.value);
-                center_min2 = std::min(center_min2, ev.value);
-                center_max2 = std::max(center_max2, ev.value);
-            }
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    }
-    
-    // Calculate center values and deadzones
-    long long sum1 = 0, sum2 = 0;
-    for (int val : center_samples1) sum1 += val;
-    for (int val : center_samples2) sum2 += val;
-    
-    int center_value1 = center_samples1.empty() ? 0 : sum1 / center_samples1.size();
-    int center_value2 = center_samples2.empty() ? 0 : sum2 / center_samples2.size();
-    int deadzone_radius1 = (center_max1 - center_min1) / 2 + 10;
-    int deadzone_radius2 = (center_max2 - center_min2) / 2 + 10;
+    sampler.reset();
+    sampler.run_for(5000);
+    const AxisStats& center1 = sampler.stats(axis1_code);
+    const AxisStats& center2 = sampler.stats(axis2_code);
+    int center_value1 = center1.center();
+    int center_value2 = center2.center();
+    int deadzone_radius1 = (center1.max() - center1.min()) / 2 + 10;
+    int deadzone_radius2 = (center2.max() - center2.min()) / 2 + 10;
     
     // Step 2: Measure full range for both axes
     std::cout << "  Step 2: Move stick in full circles for 10 seconds...\n";
     std::cout << "  Press ENTER when ready...";
     get_line_input();
     
-    // Initialize range with center values, not current position
-    // This prevents contamination if stick isn't centered when ENTER is pressed
-    int range_min1 = center_value1, range_max1 = center_value1;
-    int range_min2 = center_value2, range_max2 = center_value2;
+    sampler.reset();
+    sampler.run_for(10000);
     
-    start = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10000)) {
-        int rc = libevdev_next_event(device.dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-        
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS) {
-            if (ev.code == axis1_code) {
-                range_min1 = std::min(range_min1, ev.value);
-                range_max1 = std::max(range_max1, ev.value);
-            } else if (ev.code == axis2_code) {
-                range_min2 = std::min(range_min2, ev.value);
-                range_max2 = std::max(range_max2, ev.value);
-            }
-        } else if (rc == -EAGAIN) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    }
+    // Include the centers, so the range always spans the rest position
+    int range_min1 = std::min(center_value1, sampler.stats(axis1_code).min());
+    int range_max1 = std::max(center_value1, sampler.stats(axis1_code).max());
+    int range_min2 = std::min(center_value2, sampler.stats(axis2_code).min());
+    int range_max2 = std::max(center_value2, sampler.stats(axis2_code).max());
     
     // Show results for axis 1
     std::cout << "  Axis " << axis1_code << ":\n";
@@ -1568,29 +1146,11 @@ void capture_axes(CaptureState& state) {
             get_line_input();
             
             // Sample center for 5 seconds
-            struct input_event ev;
-            while (libevdev_next_event(rudder->dev, LIBEVDEV_READ_FLAG_NORMAL, &ev) == LIBEVDEV_READ_STATUS_SUCCESS) {
-                // Drain queue
-            }
-            
-            std::vector<int> center_samples;
-            auto start = std::chrono::steady_clock::now();
-            while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(5000)) {
-                int rc = libevdev_next_event(rudder->dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-                if (rc == LIBEVDEV_READ_STATUS_SUCCESS && ev.type == EV_ABS && ev.code == antitorque_code) {
-                    center_samples.push_back(ev.value);
-                } else if (rc == -EAGAIN) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                }
-            }
-            
             int center_value = temp_cal->center_value;
-            if (!center_samples.empty()) {
-                long long sum = 0;
-                for (int val : center_samples) {
-                    sum += val;
-                }
-                center_value = sum / center_samples.size();
+            AxisSampler sampler;
+            if (sampler.open(rudder->path) && sampler.has_axis(antitorque_code)) {
+                sampler.run_for(5000);
+                center_value = sampler.stats(antitorque_code).center();
             }
             
             std::cout << "Center value: " << center_value << "\n";
@@ -3,10 +3,12 @@
 #include <unistd.h>
 #include <cstring>
 #include <cstdio>
+#include <cerrno>
 #include <sys/ioctl.h>
+#include <dirent.h>
 
 VirtualDevice::VirtualDevice(const std::string& device_name) 
-    : device_name(device_name), uinput_fd(-1), ready(false) {
+    : device_name(device_name), uinput_fd(-1), ready(false), capture(false) {
 }
 
 VirtualDevice::~VirtualDevice() {
@@ -46,15 +48,58 @@ bool VirtualDevice::initialize() {
     return true;
 }
 
+bool VirtualDevice::initialize_capture(const std::string& path) {
+    cleanup();
+    
+    uinput_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (uinput_fd < 0) {
+        perror(("Failed to open capture file: " + path).c_str());
+        return false;
+    }
+    
+    capture = true;
+    ready = true;
+    return true;
+}
+
+std::string VirtualDevice::event_node() const {
+    return (ready && !capture) ? uinput_event_node(uinput_fd) : "";
+}
+
+std::string uinput_event_node(int uinput_fd) {
+    // "inputN" under /sys/devices/virtual/input, which holds the eventN child
+    char sysname[64] = {};
+    if (ioctl(uinput_fd, UI_GET_SYSNAME(sizeof(sysname)), sysname) < 0) {
+        return "";
+    }
+    std::string sys_dir = std::string("/sys/devices/virtual/input/") + sysname;
+    DIR* dir = opendir(sys_dir.c_str());
+    if (!dir) {
+        return "";
+    }
+    
+    std::string node;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strncmp(entry->d_name, "event", 5) == 0) {
+            node = std::string("/dev/input/") + entry->d_name;
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
 void VirtualDevice::cleanup() {
     if (uinput_fd >= 0) {
-        if (ready) {
+        if (ready && !capture) {
             ioctl(uinput_fd, UI_DEV_DESTROY);
         }
         close(uinput_fd);
         uinput_fd = -1;
     }
     ready = false;
+    capture = false;
 }
 
 bool VirtualDevice::setup_uinput() {
@@ -168,4 +213,93 @@ bool VirtualDevice::emit_sync() {
     sync_ev.value = 0;
     
     return write(uinput_fd, &sync_ev, sizeof(sync_ev)) >= 0;
-}
\ No newline at end of file
+}
+
+bool VirtualDevice::write_all(const struct input_event* events, size_t count) {
+    const char* data = reinterpret_cast<const char*>(events);
+    size_t remaining = count * sizeof(struct input_event);
+    
+    // uinput consumes whole events; retry the tail if a write is interrupted or short
+    while (remaining > 0) {
+        ssize_t written = write(uinput_fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (written == 0) {
+            return false;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void VirtualDevice::queue_event(uint16_t type, uint16_t code, int32_t value) {
+    // Coalesce with an event already queued for the same code in this frame
+    for (size_t i = 0; i < frame_count; i++) {
+        struct input_event& queued = frame_buffer[i];
+        if (queued.type != type || queued.code != code) {
+            continue;
+        }
+        
+        if (type == EV_ABS) {
+            // Only the latest axis position matters within a frame
+            queued.value = value;
+            return;
+        }
+        
+        if (queued.value == value) {
+            return;
+        }
+        
+        // A button toggling again inside one frame would cancel out; close the
+        // current frame so both edges (e.g. a quick click) reach the game.
+        flush_frame();
+        break;
+    }
+    
+    if (frame_count == MAX_FRAME_EVENTS) {
+        flush_frame();
+    }
+    
+    struct input_event& ev = frame_buffer[frame_count++];
+    memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+}
+
+bool VirtualDevice::flush_frame() {
+    if (frame_count == 0) {
+        return true;
+    }
+    
+    size_t count = frame_count;
+    frame_count = 0;
+    
+    if (uinput_fd < 0 || !ready) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        const struct input_event& ev = frame_buffer[i];
+        int index = (ev.type == EV_KEY) ? virtual_button_index(ev.code) : virtual_axis_index(ev.code);
+        if (index < 0) continue;
+        if (ev.type == EV_KEY) {
+            button_state[index] = ev.value;
+        } else {
+            axis_state[index] = ev.value;
+        }
+    }
+    
+    struct input_event& sync_ev = frame_buffer[count];
+    memset(&sync_ev, 0, sizeof(sync_ev));
+    sync_ev.type = EV_SYN;
+    sync_ev.code = SYN_REPORT;
+    sync_ev.value = 0;
+    
+    return write_all(frame_buffer.data(), count + 1);
+}
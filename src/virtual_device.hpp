@@ -2,7 +2,11 @@
 #define VIRTUAL_DEVICE_HPP
 
 #include <string>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <linux/uinput.h>
+#include "bindings.hpp"
 
 class VirtualDevice {
 public:
@@ -10,18 +14,47 @@ public:
     ~VirtualDevice();
     
     bool initialize();
+    // Write frames to a file instead of creating a uinput device (replay output
+    // capture). Timestamps are zero, so captures from two builds compare byte for byte.
+    bool initialize_capture(const std::string& path);
     void cleanup();
     
     int get_fd() const { return uinput_fd; }
     bool is_ready() const { return ready; }
+    // /dev/input/eventN the kernel created for the device, empty if unknown
+    std::string event_node() const;
     
     bool write_event(const struct input_event& ev);
     bool emit_sync();
+    
+    // Frame batching: queue the output events of one input frame, then flush
+    // them with a trailing SYN_REPORT in a single write() of an input_event array.
+    // Repeated axis values for the same code are merged; a repeated button toggle
+    // starts a new frame instead.
+    void queue_event(uint16_t type, uint16_t code, int32_t value);
+    bool flush_frame();  // No-op (returns true) when nothing is queued
+    size_t queued_events() const { return frame_count; }
+    
+    // Last value written for each contract slot, i.e. what the game currently sees
+    const std::array<int32_t, VIRTUAL_BUTTON_COUNT>& emitted_buttons() const { return button_state; }
+    const std::array<int32_t, VIRTUAL_AXIS_COUNT>& emitted_axes() const { return axis_state; }
+    
+    // Room for the whole virtual contract (17 buttons + 8 axes) several times over;
+    // a frame that outgrows it is flushed early as its own frame.
+    static constexpr size_t MAX_FRAME_EVENTS = 64;
 
 private:
     std::string device_name;
     int uinput_fd;
     bool ready;
+    bool capture;
+    
+    std::array<struct input_event, MAX_FRAME_EVENTS + 1> frame_buffer{};  // +1 for SYN_REPORT
+    size_t frame_count = 0;
+    std::array<int32_t, VIRTUAL_BUTTON_COUNT> button_state{};
+    std::array<int32_t, VIRTUAL_AXIS_COUNT> axis_state{};
+    
+    bool write_all(const struct input_event* events, size_t count);
     
     bool setup_uinput();
     bool enable_event_types();
@@ -30,4 +63,7 @@ private:
     bool create_device();
 };
 
+// Event node of any device created through the given uinput fd, empty if unknown
+std::string uinput_event_node(int uinput_fd);
+
 #endif // VIRTUAL_DEVICE_HPP
\ No newline at end of file